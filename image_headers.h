@@ -14,7 +14,9 @@
 #define IMGINFO_H
 
 #include <string>
+#include <vector>
 using std::string;
+using std::vector;
 
 #define MAXHEADERITEMS 1024
 
@@ -40,6 +42,27 @@ typedef enum {FORMAT_UNKNOWN, FORMAT_HDF5_EIGER} format_t;
 #define MAXIMAGES               9
 
 typedef struct image_header_s  image_header;
+typedef struct image_sweep_s   image_sweep;
+typedef struct image_filter_s  image_filter;
+
+/* one sweep (trigger) within a multi-image file: angles [degree] of
+   first and last image (each as start, end) */
+struct image_sweep_s {
+  INT32 cont;  /* continuation of previous sweep (0/1)  */
+  INT32 img1;  /* first image number                    */
+  INT32 img2;  /* last image number                     */
+  FLT64 omeg[4]; /* Omega   first start/end, last start/end */
+  FLT64 kapp[4]; /* Kappa                                */
+  FLT64 chi[4];  /* Chi                                  */
+  FLT64 phi[4];  /* Phi                                  */
+  FLT64 twot[4]; /* 2-Theta                              */
+};
+
+/* compression filter used for the image data */
+struct image_filter_s {
+  INT32 id;    /* HDF5 filter identification number     */
+  string name; /* filter name                           */
+};
 
 /* ================================================================================= */
 /* generic header - used internally in imginfo.c */
@@ -73,6 +96,16 @@ struct image_header_s {
   string sensm;/* sensor material                       */
   FLT64 fpol;  /* fraction of polarization              */
   INT32 msec;  /* fraction of date & timestamp     [ms] */
+  INT32 nimg;  /* number of images                      */
+  INT32 ntrg;  /* number of triggers                    */
+  INT32 imgn;  /* image number reported on              */
+  INT32 imgl;  /* last image number                     */
+  INT32 imgo;  /* offset between image number and position */
+  INT32 nmis;  /* images without data written (-h5check) */
+  string rota; /* rotation axis                         */
+  vector<image_sweep>  swps; /* sweeps (multi-image files only) */
+  vector<image_filter> filt; /* filters of image data (-h5check) */
+  vector<string> extf; /* external (data) files checked     */
 };
 
 #endif
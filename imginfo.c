@@ -17,6 +17,23 @@
 #include <time.h>
 #include <locale.h>
 #include <libgen.h> //basename and dirname
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
 
 #if defined(__APPLE__) && defined(__MACH__)
 #include <libgen.h>
@@ -24,139 +41,15 @@
 
 #if defined(USE_HDF5)
 #include "hdf5.h"
-#ifdef __cplusplus
-extern "C" {
-#endif
-#ifdef USE_BITSHUFFLE
-#include "bshuf_h5filter.h"
-#endif
-#ifdef USE_LZ4
-extern const H5Z_class2_t H5Z_LZ4[1];
-#define LZ4_FILTER 32004
-#endif
-#ifdef __cplusplus
-}
-#endif
 #endif
 
-// compile with -lz -lbz2 //
-#include <zlib.h>
-#include <bzlib.h>
-
 #include "imginfo.h"
 
-#define CHUNK 16384
-
-#ifdef NaN
-#define INIT_FLOAT  NaN
-#ifdef NaN64
-#define INIT_DOUBLE NaN64
-#else
-#define INIT_DOUBLE NaN
-#endif
-#else
-#define INIT_FLOAT  0.0
-#define INIT_DOUBLE 0.0
-#endif
-#define INIT_INT    INT_MIN
-
-#define CHAR_ARRAY_LEN 128
-
-// https://en.wikipedia.org/wiki/Machine_epsilon#Values_for_standard_hardware_floating_point_arithmetics
-#define EPSILON32 1.19e-07
-#define EPSILON64 2.22e-16
-
 int iverb = 0;
-int buffer_size = 0;
-int get_header_iverb = 1;
 int h5check = 0;
-
-vector<string> tokenise(const char* line)
-{
-  // split into space-separated strings
-  vector<string> V;
-  int lptr = 0;
-  int sptr = 0;
-  // skip initial spaces
-  while (line[lptr] == 32) lptr++;
-  while (2 != 3)
-    {
-      sptr = lptr;
-      while (line[lptr]!=32 && line[lptr]!=0 && line[lptr]!=10 && line[lptr]!=13) lptr++;
-      V.push_back(string(line+sptr, lptr-sptr));
-      if (line[lptr] == 0 ||line[lptr]==10 || line[lptr]==13) {
-        // mark end of array with an empty item
-        V.push_back("");
-        return V;
-      }
-      while (line[lptr]==32) lptr++;
-    }
-}
-
-vector<string> tokenise_cbf_header(const char* line)
-{
-  // split into space-separated strings
-  // according to manual version 1.2 the following are equivalent to space: '#=:,()'
-  // ascii decimal table from: http://www.asciitable.com/
-  //  0 == NUL (null)
-  // 10 == LF  (line feed, new line)
-  // 13 == CR  (carriage return)
-  // 32 == space
-  // 35 == '#'
-  // 40 == '('
-  // 41 == ')'
-  // 44 == ','
-  // 58 == ':'
-  // 61 == '='
-  vector<string> V;
-  int lptr = 0;
-  int sptr = 0;
-  // skip initial spaces
-  while (line[lptr] == 32) lptr++;
-  while (2 != 3)
-    {
-      sptr = lptr;
-      while (line[lptr]!=32 && line[lptr]!=0  && line[lptr]!=10 && line[lptr]!=13 &&
-             line[lptr]!=35 && line[lptr]!=40 && line[lptr]!=41 && line[lptr]!=44 && 
-             line[lptr]!=58 && line[lptr]!=61) lptr++;
-      V.push_back(string(line+sptr, lptr-sptr));
-      if (line[lptr] == 0 || line[lptr]==10 || line[lptr]==13) {
-        // mark end of array with an empty item
-        V.push_back("");
-        return V;
-      }
-      while (line[lptr]==32 || line[lptr]==35 || line[lptr]==40 || line[lptr]==41 || line[lptr]==44 || line[lptr]==58 || line[lptr]==61) lptr++;
-    }
-}
-
-vector<string> tokenise_file_name(const char* line)
-{
-  // split into space-separated strings
-  // ascii decimal table from: http://www.asciitable.com/
-  //  0 == NUL (null)
-  // 10 == LF  (line feed, new line)
-  // 13 == CR  (carriage return)
-  // 32 == space
-  // 44 == ','
-  vector<string> V;
-  int lptr = 0;
-  int sptr = 0;
-  // skip initial spaces
-  while (line[lptr] == 32) lptr++;
-  while (2 != 3)
-    {
-      sptr = lptr;
-      while (line[lptr]!=32 && line[lptr]!=0  && line[lptr]!=10 && line[lptr]!=13 &&
-             line[lptr]!=44 ) lptr++;
-      V.push_back(string(line+sptr, lptr-sptr));
-      if (line[lptr] == 0 || line[lptr]==10 || line[lptr]==13) {
-        // mark end of array with an empty item
-        V.push_back("");
-        return V;
-      }
-      while (line[lptr]==32 || line[lptr]==44 ) lptr++;
-    }
-}
+// number of worker processes checking external links in h5check mode
+// (0 = depending on CPUs and number of links, see H5JOBS_MAX)
+int h5check_workers = 0;
 
 void print_copyright(int full_copyright) {
   // -------------------------------------------------------------------------------
@@ -467,7 +360,13 @@ void print_copyright(int full_copyright) {
 
 void print_help() {
   printf("\n");
-  printf(" USAGE: imginfo [-v|-h] [-detid] [-[no]norm] [-h5check] <file-1> [... <file-N>]\n");
+  printf(" USAGE: imginfo [-v|-h] [-detid] [-[no]norm] [-h5check] [-h5jobs <N>] [-h5resume <file>] [-h5mem[=<MB>]]\n");
+  printf("               [-sweep-summary] [-trace <file>] [-timings] [-j <N>] [-cache <file>|-nocache] [-scan <dir>]\n");
+  printf("               [-watch <dir>] [-format text|ndjson] [-per-image[-raw]] [-frames[=<N>]|-verify[=<N>]]\n");
+  printf("               [-manifest <file> [-sha256]] <file-1> [... <file-N>]\n");
+  printf("        imginfo -manifest-check <file>\n");
+  printf("        imginfo -serve <socket>\n");
+  printf("        imginfo -client <socket> [... as above ...]\n");
   printf("\n");
   printf("        -v                      : increase verbosity\n");
   printf("\n");
@@ -477,25 +376,139 @@ void print_help() {
   printf("\n");
   printf("        -[no]norm               : normalise (or not) angular ranges into 0..360 range (default = take values as-is)\n");
   printf("\n");
-  printf("        -h5check                : some additional checks on HDF5 files\n");
+  printf("        -h5check                : some additional checks on HDF5 files - including images that have\n");
+  printf("                                  no data written in the external (data) files (from the chunk index)\n");
   printf("\n");
-  printf("        <file-N>                : HDF5 (master) file\n");
+  printf("        -h5jobs <N>             : check up to N external (data) files at the same time during\n");
+  printf("                                  -h5check (in separate processes) - default = one process per %d\n",H5JOBS_LINKS);
+  printf("                                  files, up to %d (or the number of CPUs), and none with -j\n",H5JOBS_MAX);
+  printf("\n");
+  printf("        -h5resume <file>        : keep track of external (data) files already checked during -h5check\n");
+  printf("                                  in <file> and only check new (or changed) ones next time\n");
+  printf("\n");
+  printf("        -h5mem[=<MB>]           : read HDF5 master files of up to <MB> megabytes (default = %d) into\n",H5MEM_DEFAULT_MB);
+  printf("                                  memory with a single read before looking at them - much faster on\n");
+  printf("                                  network file systems\n");
+  printf("\n");
+  printf("        -sweep-summary          : for files with many triggers, report each run of sweeps that continue\n");
+  printf("                                  one another (in terms of angles) as a single range\n");
+  printf("\n");
+  printf("        -trace <file>           : write a timeline (Chrome trace-event format, for chrome://tracing\n");
+  printf("                                  or Perfetto) of reading each file, each HDF5 item and each\n");
+  printf("                                  external file opened by -h5check\n");
+  printf("\n");
+  printf("        -timings                : report wall and CPU time, bytes read and HDF5 calls for each phase\n");
+  printf("                                  of reading a header (also in -format ndjson output) and the peak RSS\n");
+  printf("\n");
+  printf("        -j <N>                  : process up to N files at the same time (in separate processes) - the\n");
+  printf("                                  report for each file is still given in command-line order (default = 1)\n");
+  printf("\n");
+  printf("        -cache <file>           : keep header information in (shared) cache file - entries are\n");
+  printf("                                  invalidated when the master or a checked data file changes\n");
+  printf("                                  (default = $IMGINFO_CACHE if set, otherwise no cache)\n");
+  printf("\n");
+  printf("        -nocache                : do not use a header cache\n");
+  printf("\n");
+  printf("        -scan <dir>             : after any files given, report on all *_master.h5 files anywhere below\n");
+  printf("                                  <dir> (read in parallel, reporting on each as soon as it is found -\n");
+  printf("                                  several at the same time with -j)\n");
+  printf("\n");
+  printf("        -watch <dir>            : after any files given, keep reporting on each new *_master.h5 file\n");
+  printf("                                  in <dir> as soon as it has been written (and closed)\n");
+  printf("\n");
+  printf("        -format text|ndjson     : output format: human-readable report (default) or one JSON object\n");
+  printf("                                  per file (and per sweep) and line\n");
+  printf("\n");
+  printf("        -per-image              : instead of the report, a table with image number, trigger and the\n");
+  printf("                                  start/end of omega, kappa, chi, phi and 2-theta for every image\n");
+  printf("\n");
+  printf("        -per-image-raw          : the same table as binary records (int32 image, int32 trigger and\n");
+  printf("                                  10 float64 angles, native byte order)\n");
+  printf("\n");
+  printf("        -frames[=<N>]           : instead of the report, read the image data (all of it, or the range\n");
+  printf("                                  of images given) decompressing it in N threads (default = number\n");
+  printf("                                  of CPUs), and report frames/s and GB/s achieved\n");
+  printf("\n");
+  printf("        -verify[=<N>]           : like -frames, but check the external files first (-h5check) and\n");
+  printf("                                  carry on past frames that can't be read or decoded - the first of\n");
+  printf("                                  them is reported (and the run fails)\n");
+  printf("\n");
+  printf("        -manifest <file>        : instead of the report, hash each master file and all data files it\n");
+  printf("                                  links to (in parallel) and write the hashes to <file> - one line\n");
+  printf("                                  \"XXH64 (<file>) = <hash>\" per file, as \"sha256sum --tag\" would\n");
+  printf("\n");
+  printf("        -sha256                 : add SHA-256 hashes to the manifest\n");
+  printf("\n");
+  printf("        -manifest-check <file>  : hash all files listed in manifest <file> again and compare\n");
+  printf("\n");
+  printf("        -serve <socket>         : keep running and answer requests from \"imginfo -client\" on the\n");
+  printf("                                  given Unix domain socket (same user only, using the header cache\n");
+  printf("                                  given by $IMGINFO_CACHE when the server was started)\n");
+  printf("\n");
+  printf("        -client <socket>        : have the server listening on the given socket do the work - runs\n");
+  printf("                                  normally if there is no server (or with -cache or -nocache)\n");
+  printf("\n");
+  printf("        <file-N>                : HDF5 (master) file - optionally followed by a comma-separated list\n");
+  printf("                                  of images to report on: single numbers or ranges A-B[:step],\n");
+  printf("                                  e.g. x_master.h5,1-3600:100 or x_master.h5,1,900,1800 (images are\n");
+  printf("                                  numbered from 1, up to %d of them can be given)\n",IMAGE_SPEC_MAX);
+  printf("                                  (master files may be compressed with gzip or bzip2, \"-\" reads one\n");
+  printf("                                  from stdin - external links are then looked up from the current\n");
+  printf("                                  directory)\n");
   printf("\n");
 }
 
 int main(int argc, char *argv[])
 {
-  image_header h;
-  int header_success;
+  if (argc>1 && (strcmp(argv[1],"-serve")==0 || strcmp(argv[1],"--serve")==0)) {
+    if (argc!=3) {
+      printf("\n ERROR: option \"-serve\" requires a socket name (and nothing else)!\n\n");
+      exit(EXIT_FAILURE);
+    }
+    exit(serve(argv[2]));
+  }
+  if (argc>1 && (strcmp(argv[1],"-client")==0 || strcmp(argv[1],"--client")==0)) {
+    if (argc<3) {
+      printf("\n ERROR: option \"-client\" requires a socket name!\n\n");
+      exit(EXIT_FAILURE);
+    }
+    // the socket name takes the place of the program name
+    exit(client(argv[2], argc-2, argv+2));
+  }
+  return imginfo_main(argc, argv);
+}
 
+// ==================================================================================================
+// imginfo_main: a normal run over all command-line arguments
+// ==================================================================================================
+int imginfo_main(int argc, char *argv[])
+{
   int idet=0, inorm=0;
   int nfil = 0;
+  int njobs = 1;
+  string cache;
+  string h5resume;
+  long h5mem = 0;
+  int output = OUTPUT_TEXT;
+  int frame_threads = 1;
+  int verify = 0;
+  string manifest;
+  string manifest_check;
+  int hashes = IMGINFO_HASH_XXH64;
+  int timings = 0;
+  int sweep_summary = 0;
+  string watch_dir;
+  string scan_dir;
+  // -timings: command line and files (wall and CPU time)
+  double run_wall[3], run_cpu_s[3];
+  run_wall[0]  = timing_wall();
+  run_cpu_s[0] = run_cpu();
 
   char *path;
-  char buffer[CHUNK+1];
-  int buflen = 0;
   int imgnum = 0;
   vector<string> fields;
+  vector<imginfo_job> jobs;
+  imginfo_job job;
   char *locale;
 
   int full_copyright = 0;
@@ -505,7 +518,7 @@ int main(int argc, char *argv[])
   // ensure locale setting:
   locale = setlocale(LC_ALL, "C");
 
-  memset(buffer, 0, CHUNK);
+  if (getenv("IMGINFO_CACHE")!=NULL) cache = getenv("IMGINFO_CACHE");
 
   argc--;*argv++;
   while(argc--) {
@@ -542,9 +555,205 @@ int main(int argc, char *argv[])
       if (iverb>1) printf(" Will perform additional checks on HDF5 files\n");
       *argv++;
     }
+    else if (strcmp(*argv,"-h5jobs")==0) {
+      *argv++;
+      if (argc<1 || atoi(*argv)<1) {
+        printf("\n ERROR: option \"-h5jobs\" requires a number of processes (1 or more)!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      h5check_workers = atoi(*argv);
+      if (iverb>1) printf(" Will check up to %d external files at the same time\n",h5check_workers);
+      *argv++;
+    }
+    else if (strcmp(*argv,"-cache")==0) {
+      *argv++;
+      if (argc<1) {
+        printf("\n ERROR: option \"-cache\" requires a file name!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      cache = *argv;
+      if (iverb>1) printf(" Will use header cache %s\n",cache.c_str());
+      *argv++;
+    }
+    else if (strcmp(*argv,"-watch")==0 || strcmp(*argv,"--watch")==0) {
+      *argv++;
+      if (argc<1) {
+        printf("\n ERROR: option \"-watch\" requires a directory!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      watch_dir = *argv;
+      if (iverb>1) printf(" Will watch directory %s for new master files\n",watch_dir.c_str());
+      *argv++;
+    }
+    else if (strcmp(*argv,"-scan")==0 || strcmp(*argv,"--scan")==0) {
+      *argv++;
+      if (argc<1) {
+        printf("\n ERROR: option \"-scan\" requires a directory!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      scan_dir = *argv;
+      if (iverb>1) printf(" Will scan directory %s for master files\n",scan_dir.c_str());
+      *argv++;
+    }
+    else if (strcmp(*argv,"-nocache")==0) {
+      cache = "";
+      if (iverb>1) printf(" Will not use header cache\n");
+      *argv++;
+    }
+    else if (strcmp(*argv,"-h5resume")==0) {
+      *argv++;
+      if (argc<1) {
+        printf("\n ERROR: option \"-h5resume\" requires a file name!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      h5resume = *argv;
+      if (iverb>1) printf(" Will keep state of -h5check in %s\n",h5resume.c_str());
+      *argv++;
+    }
+    else if (strcmp(*argv,"-h5mem")==0 || strcmp(*argv,"--h5mem")==0 ||
+             strncmp(*argv,"-h5mem=",7)==0 || strncmp(*argv,"--h5mem=",8)==0) {
+      const char *mb = strchr(*argv,'=');
+      h5mem = (long) H5MEM_DEFAULT_MB*1024*1024;
+      if (mb!=NULL) {
+        if (mb[1]=='\0' || strspn(mb+1,"0123456789")!=strlen(mb+1)) {
+          printf("\n ERROR: option \"-h5mem\" requires a size in MB (0 or more)!\n\n");
+          exit(EXIT_FAILURE);
+        }
+        h5mem = atol(mb+1)*1024*1024;
+      }
+      if (iverb>1) printf(" Will read HDF5 master files of up to %ld bytes into memory\n",h5mem);
+      *argv++;
+    }
+    else if (strcmp(*argv,"-format")==0 || strncmp(*argv,"--format=",9)==0 || strncmp(*argv,"-format=",8)==0) {
+      const char *format = strchr(*argv,'=');
+      if (format!=NULL) {
+        format++;
+      } else {
+        *argv++;
+        if (argc<1) {
+          printf("\n ERROR: option \"-format\" requires a format (text or ndjson)!\n\n");
+          exit(EXIT_FAILURE);
+        }
+        argc--;
+        format = *argv;
+      }
+      if (strcmp(format,"text")==0) {
+        output = OUTPUT_TEXT;
+      }
+      else if (strcmp(format,"ndjson")==0) {
+        output = OUTPUT_NDJSON;
+      }
+      else {
+        printf("\n ERROR: unknown output format \"%s\" (use text or ndjson)!\n\n",format);
+        exit(EXIT_FAILURE);
+      }
+      if (iverb>1) printf(" Output format set to %s\n",format);
+      *argv++;
+    }
+    else if (strcmp(*argv,"-per-image")==0 || strcmp(*argv,"--per-image")==0) {
+      output = OUTPUT_IMAGES;
+      if (iverb>1) printf(" Will write per-image table\n");
+      *argv++;
+    }
+    else if (strcmp(*argv,"-per-image-raw")==0 || strcmp(*argv,"--per-image-raw")==0) {
+      output = OUTPUT_IMAGES_RAW;
+      if (iverb>1) printf(" Will write per-image table (binary)\n");
+      *argv++;
+    }
+    else if (strcmp(*argv,"-frames")==0 || strcmp(*argv,"--frames")==0 ||
+             strncmp(*argv,"-frames=",8)==0 || strncmp(*argv,"--frames=",9)==0 ||
+             strcmp(*argv,"-verify")==0 || strcmp(*argv,"--verify")==0 ||
+             strncmp(*argv,"-verify=",8)==0 || strncmp(*argv,"--verify=",9)==0) {
+      const char *n = strchr(*argv,'=');
+      verify = ( strstr(*argv,"-verify")!=NULL );
+      output = OUTPUT_FRAMES;
+      frame_threads = sysconf(_SC_NPROCESSORS_ONLN);
+      if (n!=NULL) {
+        if (n[1]=='\0' || strspn(n+1,"0123456789")!=strlen(n+1) || atoi(n+1)<1) {
+          printf("\n ERROR: option \"-%s\" requires a number of threads (1 or more)!\n\n",verify ? "verify" : "frames");
+          exit(EXIT_FAILURE);
+        }
+        frame_threads = atoi(n+1);
+      }
+      if (frame_threads<1) frame_threads = 1;
+      if (iverb>1) printf(" Will %s all frames using %d decode threads\n",verify ? "verify" : "read",frame_threads);
+      *argv++;
+    }
+    else if (strcmp(*argv,"-manifest")==0 || strcmp(*argv,"--manifest")==0 ||
+             strcmp(*argv,"-manifest-check")==0 || strcmp(*argv,"--manifest-check")==0) {
+      int check = ( strstr(*argv,"-check")!=NULL );
+      *argv++;
+      if (argc<1) {
+        printf("\n ERROR: option \"-manifest%s\" requires a file name!\n\n",check ? "-check" : "");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      if (check) {
+        manifest_check = *argv;
+      } else {
+        // every master file adds its entries (possibly from several
+        // worker processes)
+        manifest = *argv;
+        output = OUTPUT_MANIFEST;
+        int fd = open(manifest.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0666);
+        if (fd<0) {
+          printf("\n ERROR: unable to create manifest \"%s\" (%s)!\n\n",manifest.c_str(),strerror(errno));
+          exit(EXIT_FAILURE);
+        }
+        close(fd);
+        if (iverb>1) printf(" Will write manifest to %s\n",manifest.c_str());
+      }
+      *argv++;
+    }
+    else if (strcmp(*argv,"-trace")==0 || strcmp(*argv,"--trace")==0) {
+      *argv++;
+      if (argc<1) {
+        printf("\n ERROR: option \"-trace\" requires a file name!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      if (imginfo_trace_open(*argv, TRACE_EVENTS)!=0) {
+        printf("\n ERROR: unable to write trace file \"%s\"!\n\n",*argv);
+        exit(EXIT_FAILURE);
+      }
+      atexit(imginfo_trace_close);
+      if (iverb>1) printf(" Will write trace to %s\n",*argv);
+      *argv++;
+    }
+    else if (strcmp(*argv,"-sweep-summary")==0 || strcmp(*argv,"--sweep-summary")==0) {
+      sweep_summary = 1;
+      if (iverb>1) printf(" Will report runs of continuation sweeps as one\n");
+      *argv++;
+    }
+    else if (strcmp(*argv,"-timings")==0 || strcmp(*argv,"--timings")==0) {
+      timings = 1;
+      if (iverb>1) printf(" Will report timings\n");
+      *argv++;
+    }
+    else if (strcmp(*argv,"-sha256")==0 || strcmp(*argv,"--sha256")==0) {
+      hashes |= IMGINFO_HASH_SHA256;
+      if (iverb>1) printf(" Will add SHA-256 to manifest\n");
+      *argv++;
+    }
+    else if (strcmp(*argv,"-j")==0) {
+      *argv++;
+      if (argc<1 || atoi(*argv)<1) {
+        printf("\n ERROR: option \"-j\" requires a number of processes (1 or more)!\n\n");
+        exit(EXIT_FAILURE);
+      }
+      argc--;
+      njobs = atoi(*argv);
+      if (iverb>1) printf(" Will process up to %d files at the same time\n",njobs);
+      *argv++;
+    }
     else {
 
-      if (do_copyright==1) {
+      if (do_copyright==1 && output==OUTPUT_TEXT) {
         print_copyright(full_copyright);
         do_copyright=0;
       }
@@ -552,36 +761,162 @@ int main(int argc, char *argv[])
       path = *argv++;
 
       // allow a path specification *,* to set image numbers in case of e.g. HDF5 master files
+      vector<int> images;
       if (strstr(path, ",") != NULL) {
-	fields = tokenise_file_name(path);
-	imgnum = atoi(fields[1].c_str());
+	string spec = path;
+	size_t pos = 0, end;
+	fields.clear();
+	while ((end = spec.find(',', pos))!=string::npos) {
+	  fields.push_back(spec.substr(pos, end-pos));
+	  pos = end + 1;
+	}
+	fields.push_back(spec.substr(pos));
+	for (size_t ifield = 1; ifield < fields.size(); ifield++) {
+	  int nimages = parse_image_spec(fields[ifield], images);
+	  if (nimages<0) {
+	    printf("\n ERROR: more than %d images given for file %s!\n\n",IMAGE_SPEC_MAX,fields[0].c_str());
+	    exit(EXIT_FAILURE);
+	  }
+	  if (nimages==0) {
+	    printf("\n ERROR: invalid image specification \"%s\" for file %s (use N or A-B[:step], images are numbered from 1)!\n\n",fields[ifield].c_str(),fields[0].c_str());
+	    exit(EXIT_FAILURE);
+	  }
+	}
+	if (!images.empty()) imgnum = images.back();
 	path = (char *) fields[0].c_str();
       }
-
-      printf("\n\n ################# File = %s\n\n",path);
-      buflen = get_buffer(path, buffer);
-      if (iverb>1) printf(" [debug] get_buffer send back buflen=%i\n", buflen);
-      if ( buflen > 0 ) {
-        // protect overflow when scanning buffer using strycpy
-        buffer[buflen - 1] = EOF;
-        buffer_size = buflen - 1;
-        if (iverb>1) printf(" [debug] buffer_size=%i\n", buffer_size);
-        if (iverb>2) printf(" [debug] calling get_header\n");
-        header_success = get_header(buffer, &h, path, imgnum);
-        if (iverb>2) printf(" [debug] header_success=%d\n", header_success);
-        if (header_success == 0) {
-          printf("\n\nError reading file header\n");
-          exit(EXIT_FAILURE);
+      // -frames reads the whole range in one go
+      int imglast = 0;
+      if (output==OUTPUT_FRAMES) {
+        if (!images.empty()) {
+          imglast = *std::max_element(images.begin(), images.end());
+          images.assign(1, *std::min_element(images.begin(), images.end()));
+        } else {
+          images.push_back(0);
         }
-        print_header(&h,idet,inorm);
-        nfil++;
       }
+      // -manifest hashes each file once, whatever images are given
+      if (output==OUTPUT_MANIFEST && images.size()>1) images.resize(1);
+      if (images.empty()) images.push_back(imgnum);
+
+      job.path    = path;
+      job.iverb   = iverb;
+      job.idet    = idet;
+      job.inorm   = inorm;
+      job.h5check = h5check;
+      job.h5jobs  = h5check_workers;
+      job.cache   = cache;
+      job.h5resume = h5resume;
+      job.h5mem   = h5mem;
+      job.output  = output;
+      job.imglast = imglast;
+      job.frame_threads = frame_threads;
+      job.verify  = verify;
+      job.manifest = manifest;
+      job.hashes  = hashes;
+      job.timings = timings;
+      job.sweep_summary = sweep_summary;
+      for (size_t iimage = 0; iimage < images.size(); iimage++) {
+        job.imgnum = images[iimage];
+        jobs.push_back(job);
+      }
+    }
+
+  }
+
+  if (manifest_check.size()>0) {
+    exit(check_manifest(manifest_check));
+  }
+  // files already handled in parallel (-j) check their external files
+  // in-process unless -h5jobs says otherwise
+  if (njobs>1 && h5check_workers==0) {
+    h5check_workers = 1;
+    for (size_t ijob = 0; ijob < jobs.size(); ijob++) {
+      if (jobs[ijob].h5jobs==0) jobs[ijob].h5jobs = 1;
+    }
+  }
+  run_wall[1]  = timing_wall();
+  run_cpu_s[1] = run_cpu();
+
+  if (njobs>1 && jobs.size()>1) {
+    // each file is handled by its own worker process (the HDF5
+    // library is not thread-safe), reports come back in order
+    // (images of the same file together)
+    file_tasks tasks;
+    file_tasks_group(&tasks, &jobs);
+    int workers_success = run_workers(tasks.first.size()-1, njobs, process_file_task, report_file_task, &tasks);
+    nfil = tasks.nfil;
+    if (workers_success<0) {
+      printf("\n\n ERROR - unable to run worker processes!\n\n");
+    }
+    if (workers_success!=0) {
+      exit(EXIT_FAILURE);
+    }
+  } else {
+    // consecutive images of the same file are read through one handle
+    imginfo_file* file = NULL;
+    for (size_t ijob = 0; ijob < jobs.size(); ijob++) {
+      if (ijob==0 || !same_file(&jobs[ijob-1], &jobs[ijob])) {
+        imginfo_close(file);
+        file = open_job_file(&jobs[ijob]);
+      }
+      int file_success = process_file(&jobs[ijob], file);
+      imginfo_trace_flush();
+      if (file_success<0) {
+        exit(EXIT_FAILURE);
+      }
+      nfil += file_success;
     }
+    imginfo_close(file);
+  }
 
+  if (scan_dir.size()>0 || watch_dir.size()>0) {
+    if (do_copyright==1 && output==OUTPUT_TEXT) {
+      print_copyright(full_copyright);
+      do_copyright=0;
+    }
+    job.path    = "";
+    job.imgnum  = 0;
+    job.iverb   = iverb;
+    job.idet    = idet;
+    job.inorm   = inorm;
+    job.h5check = h5check;
+    job.h5jobs  = h5check_workers;
+    job.cache   = cache;
+    job.h5resume = h5resume;
+    job.h5mem   = h5mem;
+    job.output  = output;
+    job.imglast = 0;
+    job.frame_threads = frame_threads;
+    job.verify  = verify;
+    job.manifest = manifest;
+    job.hashes  = hashes;
+    job.timings = timings;
+    job.sweep_summary = sweep_summary;
+    if (scan_dir.size()>0) {
+      int scan_success = scan_directory(scan_dir, &job, njobs);
+      if (scan_success<0) {
+        exit(EXIT_FAILURE);
+      }
+      nfil += scan_success;
+    }
+    if (watch_dir.size()>0) {
+      exit(watch_directory(watch_dir, &job, njobs));
+    }
   }
+
   if (nfil>0) {
+    if (timings && output==OUTPUT_TEXT) {
+      run_wall[2]  = timing_wall();
+      run_cpu_s[2] = run_cpu();
+      print_run_timings(run_wall, run_cpu_s);
+    }
     exit(EXIT_SUCCESS);
   } else {
+    if (output!=OUTPUT_TEXT) {
+      fprintf(stderr,"\nError - no (or unrecognized) files given?\n\n");
+      exit(EXIT_FAILURE);
+    }
     if (do_copyright==1) {
       print_copyright(full_copyright);
       do_copyright=0;
@@ -592,1396 +927,1827 @@ int main(int argc, char *argv[])
 
 }
 
-int get_buffer(const char* path, char* buffer){
-
-  int ret;
-  FILE *file;
-  gzFile gzfile;
-  BZFILE *bzfile;
-  int bzerror;
-  int empty;
-
-  ret = -1;
-  empty = 0;
-
-  // first try BZ2 //
-  file = fopen(path, "rb");
-  if (!file)
-      return ret;
-  bzfile = BZ2_bzReadOpen(&bzerror, file, 0, 0, NULL, 0);
-  if ( bzerror == BZ_OK ) {
-      ret = BZ2_bzRead ( &bzerror, bzfile, buffer, CHUNK);
-      if (bzerror == BZ_STREAM_END)
-          empty = 1;
-      //printf("BZERROR=%d %d\n", bzerror, empty);
-  }
-  BZ2_bzReadClose ( &bzerror, bzfile );
-  if (file)
-      fclose(file);
-  if (ret > 0){
-      return ret;
-  }
-  // Detected an empty bz2 file above //
-  if (empty == 1){
-      ret = 0;
-      return ret;
-  }
-
-  // then try gz (will work equally fine on a regular file //
-  gzfile = gzopen(path, "rb");
-  if (gzfile != NULL) {
-      ret = gzread(gzfile, buffer, CHUNK);
-      gzclose(gzfile);
-      if (ret >= 0) {
-          return ret;
-      }
-  }
-
-  // something went wrong //
-  ret = -1;
-  return ret;
+// images given after a file name: "N", "A-B" or "A-B:step" (added to
+// images), returns 0 if the specification can't be used
+// one item of the image list given with a file: N or A-B[:step] (images
+// are numbered from 1) - returns the number of images added to images,
+// 0 for a syntax error and -1 if that would make more than IMAGE_SPEC_MAX
+int parse_image_spec(const string& spec, vector<int>& images)
+{
+  const char *p = spec.c_str();
+  char *e;
+  long first = strtol(p, &e, 10);
+  if (e==p || first<1) return 0;
+  long last = first, step = 1;
+  if (*e=='-') {
+    p = e + 1;
+    last = strtol(p, &e, 10);
+    if (e==p || last<first) return 0;
+    if (*e==':') {
+      p = e + 1;
+      step = strtol(p, &e, 10);
+      if (e==p || step<1) return 0;
+    }
+  }
+  if (*e!='\0' || last>INT_MAX) return 0;
+  long n = (last-first)/step + 1;
+  if (n > IMAGE_SPEC_MAX - (long) images.size()) return -1;
+  for (long img = first; img <= last; img += step) {
+    images.push_back((int) img);
+  }
+  return (int) n;
 }
 
 // ==================================================================================================
-// get_format
+// watch_directory (-watch <dir>)
+//   report on every *_master.h5 file that is closed after writing (or
+//   moved) into the directory, as soon as that happens - using the
+//   options in effect at the end of the command line. Files arriving
+//   together are handled by up to njobs worker processes, and a file that
+//   can't be read doesn't stop the watch. Only returns on error.
 // ==================================================================================================
-format_t get_format(const char* buffer) {
-  format_t formatn[]  = {
-    FORMAT_HDF5_EIGER
-  };
-  const char* formats[] = {
-    "hdf5_eiger"
-  };
-  int (*formatf[])(const char*) = {
-    is_hdf5_eiger
-  };
-
-  int nformats = sizeof(formatn) / sizeof(int);
-  for (int u=0; u<nformats; u++)
-    {
-      if (iverb>2) printf(" [debug]   (%d) calling is_%s\n", u, formats[u]);
-      if (formatf[u](buffer)) {
-        if (iverb>2) printf(" [debug]   YES %d\n",formatn[u]);
-        return formatn[u];
-      } else {
-        if (iverb>2) printf(" [debug]   NO\n");
-      }
-    }
-  return FORMAT_UNKNOWN;
+#define WATCH_SUFFIX "_master.h5"
+
+int watch_file_report(int itask, int status, const string& output, const string& result, void* arg)
+{
+  report_file_task(itask, status, output, result, arg);
+  return 0;
+}
+
+int watch_directory(const string& dir, const imginfo_job* opts, int njobs)
+{
+#if defined(__linux__)
+  int ifd = inotify_init1(IN_CLOEXEC);
+  if (ifd<0) {
+    printf("\n ERROR: unable to initialise inotify!\n\n");
+    return EXIT_FAILURE;
+  }
+  if (inotify_add_watch(ifd, dir.c_str(), IN_CLOSE_WRITE|IN_MOVED_TO)<0) {
+    printf("\n ERROR: unable to watch directory \"%s\"!\n\n",dir.c_str());
+    close(ifd);
+    return EXIT_FAILURE;
+  }
+  if (iverb>0) printf(" Watching %s for new master files\n",dir.c_str());
+  fflush(stdout);
+
+  char events[64*(sizeof(struct inotify_event)+NAME_MAX+1)]
+    __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  size_t lsuffix = strlen(WATCH_SUFFIX);
+
+  while (2 != 3) {
+    ssize_t nread = read(ifd, events, sizeof(events));
+    if (nread<0) {
+      if (errno==EINTR) continue;
+      printf("\n ERROR: reading inotify events for \"%s\"!\n\n",dir.c_str());
+      break;
+    }
+
+    // all master files in this batch of events (each one once)
+    vector<imginfo_job> jobs;
+    for (char *p = events; p < events + nread; ) {
+      struct inotify_event *ev = (struct inotify_event *) p;
+      p += sizeof(struct inotify_event) + ev->len;
+      if (ev->mask & IN_Q_OVERFLOW) {
+        printf("\n WARNING: inotify event queue overflow - some files in \"%s\" may have been missed!\n\n",dir.c_str());
+        fflush(stdout);
+      }
+      if (ev->len==0 || (ev->mask & IN_ISDIR)) continue;
+      size_t lname = strlen(ev->name);
+      if (lname<=lsuffix || strcmp(ev->name+lname-lsuffix, WATCH_SUFFIX)!=0) continue;
+      imginfo_job job = *opts;
+      job.path = dir + "/" + ev->name;
+      int seen = 0;
+      for (size_t ijob = 0; ijob < jobs.size(); ijob++) {
+        if (jobs[ijob].path==job.path) seen = 1;
+      }
+      if (!seen) jobs.push_back(job);
+    }
+    if (jobs.empty()) continue;
+
+    // each file in its own process: a fatal error in one of them must not
+    // end the watch
+    file_tasks tasks;
+    file_tasks_group(&tasks, &jobs);
+    if (run_workers(tasks.first.size()-1, njobs, process_file_task, watch_file_report, &tasks)<0) {
+      printf("\n\n ERROR - unable to run worker processes!\n\n");
+      fflush(stdout);
+    }
+    imginfo_trace_flush();
+  }
+  close(ifd);
+#else
+  printf("\n ERROR: option \"-watch\" is only available on Linux!\n\n");
+#endif
+  return EXIT_FAILURE;
 }
 
 // ==================================================================================================
-// get_header
+// scan_directory (-scan <dir>)
+//   report on every master file anywhere below a directory - using the
+//   options in effect at the end of the command line. The tree is read
+//   by SCAN_THREADS threads, each taking the next directory still to be
+//   read (and adding the ones it finds in there), so that a visit with
+//   thousands of sub-directories is read in parallel even on network
+//   file systems. Files are reported as they are found, one by one while
+//   the tree is still being read - worker processes can't be forked while
+//   the scan threads are running (the child of a multi-threaded process
+//   may only make async-signal-safe calls, and HDF5 is anything but) - and
+//   whatever is left once it has been read by up to njobs of them.
+//   Symbolic links to directories are not followed, a master file found
+//   through a link to one already found (or vice versa) is reported once.
+//   Returns the number of files reported (-1 on a fatal error).
 // ==================================================================================================
-int get_header(const char* buffer, image_header* h, const char* path, const int imgnum)
+
+// *_master.h5 - also compressed
+int scan_is_master(const char* name)
+{
+  static const char* suffix[] = { WATCH_SUFFIX, WATCH_SUFFIX ".gz", WATCH_SUFFIX ".bz2" };
+  size_t lname = strlen(name);
+  for (size_t isuffix = 0; isuffix < sizeof(suffix)/sizeof(suffix[0]); isuffix++) {
+    size_t lsuffix = strlen(suffix[isuffix]);
+    if (lname>lsuffix && strcmp(name+lname-lsuffix, suffix[isuffix])==0) return 1;
+  }
+  return 0;
+}
+
+// sub-directories and (HDF5) master files of one directory - the file
+// type comes from the directory entry itself where the file system
+// provides it, returns the number of entries (-1 if it can't be read)
+long scan_read_dir(const string& dir, vector<string>& dirs, vector<string>& found)
 {
-  empty_header(h);
-  if (iverb>2) printf(" [debug]  calling get_format\n");
-  format_t format = get_format(buffer);
-  if (iverb>2) printf(" [debug]  format = %d\n",format);
+  DIR *d = opendir(dir.c_str());
+  if (d==NULL) return -1;
+  int dfd = dirfd(d);
+  string prefix = dir;
+  if (prefix[prefix.size()-1]!='/') prefix += "/";
+  char buffer[CHUNK+1];
+  long nentries = 0;
+  struct dirent *e;
+  while ((e = readdir(d))!=NULL) {
+    if (strcmp(e->d_name,".")==0 || strcmp(e->d_name,"..")==0) continue;
+    nentries++;
+    int master = scan_is_master(e->d_name);
+    int type = e->d_type;
+    struct stat st;
+    if (type==DT_UNKNOWN) {
+      if (fstatat(dfd, e->d_name, &st, AT_SYMLINK_NOFOLLOW)<0) continue;
+      type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : S_ISLNK(st.st_mode) ? DT_LNK : DT_UNKNOWN;
+    }
+    // a link to a master file counts, one to a directory doesn't
+    if (type==DT_LNK && master) {
+      if (fstatat(dfd, e->d_name, &st, 0)<0) continue;
+      if (S_ISREG(st.st_mode)) type = DT_REG;
+    }
+    if (type==DT_DIR) {
+      dirs.push_back(prefix + e->d_name);
+    }
+    else if (type==DT_REG && master) {
+      // data files and anything else that only looks like a master file
+      string path = prefix + e->d_name;
+      int nbuffer = get_buffer(path.c_str(), buffer);
+      if (nbuffer>=8 && is_hdf5_eiger(buffer)==FORMAT_HDF5_EIGER) found.push_back(path);
+    }
+  }
+  closedir(d);
+  std::sort(found.begin(), found.end());
+  return nentries;
+}
 
-  if (format == FORMAT_UNKNOWN) {
-    printf("ERROR: cannot determine file format\n");
-    return 0;
+// scan thread: reads directories until there are none left (and no
+// other thread can find any more)
+void* scan_worker(void* arg)
+{
+  scan_pool* p = (scan_pool*) arg;
+  vector<string> dirs, found;
+  pthread_mutex_lock(&p->lock);
+  while (2 != 3) {
+    while (p->dirs.empty() && p->nbusy>0 && !p->stop) pthread_cond_wait(&p->cond, &p->lock);
+    if (p->dirs.empty() || p->stop) break;
+    // depth-first: keeps the list of directories short
+    string dir = p->dirs.back();
+    p->dirs.pop_back();
+    p->nbusy++;
+    pthread_mutex_unlock(&p->lock);
+
+    dirs.clear();
+    found.clear();
+    long nentries = scan_read_dir(dir, dirs, found);
+    vector<string> real(found.size());
+    for (size_t ifound = 0; ifound < found.size(); ifound++) {
+      char path[PATH_MAX];
+      real[ifound] = ( realpath(found[ifound].c_str(), path)!=NULL ) ? path : found[ifound];
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->nbusy--;
+    p->ndirs++;
+    if (nentries<0) {
+      p->nunreadable++;
+    } else {
+      p->nentries += nentries;
+    }
+    p->dirs.insert(p->dirs.end(), dirs.rbegin(), dirs.rend());
+    for (size_t ifound = 0; ifound < found.size(); ifound++) {
+      if (p->seen.insert(std::make_pair(real[ifound], 1)).second) p->found.push_back(found[ifound]);
+    }
+    if (p->dirs.empty() && p->nbusy==0) p->done = 1;
+    pthread_cond_broadcast(&p->cond);
   }
+  pthread_mutex_unlock(&p->lock);
+  return NULL;
+}
+
+int scan_directory(const string& dir, const imginfo_job* opts, int njobs)
+{
+  struct stat st;
+  if (stat(dir.c_str(), &st)<0 || !S_ISDIR(st.st_mode)) {
+    printf("\n ERROR: unable to scan directory \"%s\"!\n\n",dir.c_str());
+    return -1;
+  }
+  if (iverb>0) printf(" Scanning %s for master files\n",dir.c_str());
+
+  scan_pool p;
+  pthread_mutex_init(&p.lock, NULL);
+  pthread_cond_init(&p.cond, NULL);
+  p.dirs.push_back(dir);
+  p.nbusy       = 0;
+  p.done        = 0;
+  p.stop        = 0;
+  p.ndirs       = 0;
+  p.nentries    = 0;
+  p.nunreadable = 0;
+  vector<pthread_t> threads(SCAN_THREADS);
+  int nstarted;
+  for (nstarted = 0; nstarted < SCAN_THREADS; nstarted++) {
+    if (pthread_create(&threads[nstarted], NULL, scan_worker, &p)!=0) break;
+  }
+  // no threads at all: read the whole tree first
+  if (nstarted==0) scan_worker(&p);
 
-  format_t formats2[] = {FORMAT_HDF5_EIGER};
-  string   formath2[] = {"HDF5/Eiger"};
-  int(*formatf2[])(const char*, const int, image_header*) = {get_header_eiger};
+  int nfil = 0;
+  size_t next = 0;
+  int joined = 0;
+  pthread_mutex_lock(&p.lock);
+  while (2 != 3) {
+    while (next==p.found.size() && !p.done) pthread_cond_wait(&p.cond, &p.lock);
+    if (next==p.found.size()) break;
+    vector<imginfo_job> jobs;
+    for (; next < p.found.size(); next++) {
+      imginfo_job job = *opts;
+      job.path = p.found[next];
+      jobs.push_back(job);
+    }
+    int walked = p.done;
+    pthread_mutex_unlock(&p.lock);
+
+    // forking is only safe once the scan threads are gone
+    if (walked && !joined) {
+      for (int ithread = 0; ithread < nstarted; ithread++) pthread_join(threads[ithread], NULL);
+      joined = 1;
+    }
+    int failed = 0;
+    if (joined && njobs>1 && jobs.size()>1) {
+      file_tasks tasks;
+      file_tasks_group(&tasks, &jobs);
+      int workers_success = run_workers(tasks.first.size()-1, njobs, process_file_task, report_file_task, &tasks);
+      if (workers_success<0) {
+        printf("\n\n ERROR - unable to run worker processes!\n\n");
+      }
+      failed = ( workers_success!=0 );
+      nfil += tasks.nfil;
+    } else {
+      for (size_t ijob = 0; ijob < jobs.size() && !failed; ijob++) {
+        imginfo_file* file = open_job_file(&jobs[ijob]);
+        int file_success = process_file(&jobs[ijob], file);
+        imginfo_close(file);
+        imginfo_trace_flush();
+        if (file_success<0) {
+          failed = 1;
+        } else {
+          nfil += file_success;
+        }
+      }
+    }
+    fflush(stdout);
 
-  for (UINT32 u=0; u < sizeof(formats2)/sizeof(format_t); u++){
-    if (format == formats2[u]) {
-      printf(" >>> Image format detected as %s\n",formath2[u].c_str());
-      return formatf2[u](path, imgnum, h);
+    pthread_mutex_lock(&p.lock);
+    if (failed) {
+      p.stop = 1;
+      pthread_cond_broadcast(&p.cond);
+      nfil = -1;
+      break;
     }
   }
+  pthread_mutex_unlock(&p.lock);
+  if (!joined) {
+    for (int ithread = 0; ithread < nstarted; ithread++) pthread_join(threads[ithread], NULL);
+  }
+  pthread_cond_destroy(&p.cond);
+  pthread_mutex_destroy(&p.lock);
 
-  printf(" ERROR: unknown format %d\n",format);
-  return 0;
+  if (nfil>=0 && opts->output==OUTPUT_TEXT) {
+    if (p.nunreadable>0) {
+      printf("\n WARNING: %ld directories below %s could not be read!\n",p.nunreadable,dir.c_str());
+    }
+    if (iverb>0) {
+      printf("\n Scanned %ld directories (%ld entries) below %s: %lu master files\n\n",p.ndirs,p.nentries,dir.c_str(),(unsigned long) p.found.size());
+    }
+  }
+  return nfil;
 }
 
 // ==================================================================================================
-// utility routines
+// resident server (-serve <socket>) and its client (-client <socket>)
+//   the server initialises the HDF5 library and registers the filters
+//   once, then waits for requests on a Unix domain socket. A request is
+//   the client's working directory followed by its command-line
+//   arguments, one per line, ended by an empty line. Each request is
+//   answered by a forked process (so several can be served at the same
+//   time, and a fatal error only ends that request) running exactly what
+//   a normal imginfo run would do. The answer is
+//
+//     IMGINFO <exit-status> <nbytes> <nerrbytes>\n
+//
+//   followed by nbytes of report (stdout) and nerrbytes of whatever went
+//   to stderr (e.g. HDF5 error stacks). The client prints both to its own
+//   stdout and stderr and exits with the status given. If no server is
+//   listening the client simply does the work itself.
+//
+//   Only processes of the user running the server are answered (the
+//   socket is only accessible to that user as well), the working
+//   directory has to be absolute, and the header cache is the server's
+//   own ($IMGINFO_CACHE when it was started) - requests with -cache or
+//   -nocache are refused, the client runs those itself.
 // ==================================================================================================
+#define SERVE_MAX_REQUEST (1024*1024)
+
+typedef struct serve_request_s {
+  int            fd;    // connection to client
+  string         cwd;
+  vector<string> args;
+} serve_request;
 
-char* strycpy(char* out, const char* in, int* nchars)
+const char* serve_socket = NULL;
+
+void serve_stop(int sig)
 {
-  int u;
-  int v;
-  int mchars = *nchars;
-  int eof = -1;
-  v=0;
-  for (u=0; u<mchars-1; u++){
-      v++;
-      out[u]=in[u];
-      if (out[u] == '\0') break;
-      if (out[u] == 10) break;
-      if (out[u] == EOF) {
-          eof = u;
-          break;
-      }
+  if (serve_socket!=NULL) unlink(serve_socket);
+  _exit(EXIT_SUCCESS);
+}
+
+int write_all(int fd, const char* data, size_t n)
+{
+  while (n>0) {
+    ssize_t nw = write(fd, data, n);
+    if (nw<0) {
+      if (errno==EINTR) continue;
+      return -1;
+    }
+    data += nw;
+    n    -= nw;
   }
-  *nchars = v;
-  // As per default of fgets:
-  if (eof == 0) return NULL;
-  if (v < mchars) out[v] = 0;
-  return out;
+  return 0;
 }
 
-float my_stof(const string& S)
+int serve_task(int itask, int fd_result, void* arg)
 {
-  float f;
-  sscanf(S.c_str(),"%f",&f);
-  return f;
+  serve_request *req = (serve_request *) arg;
+  // stderr goes back to the client too (instead of into the server's log)
+  dup2(fd_result, STDERR_FILENO);
+  close(fd_result);
+  if (chdir(req->cwd.c_str())<0) {
+    printf("\n\n ERROR - unable to change to directory \"%s\"!\n\n",req->cwd.c_str());
+    return EXIT_FAILURE;
+  }
+  vector<char*> argv;
+  argv.push_back((char *) "imginfo");
+  for (size_t iarg = 0; iarg < req->args.size(); iarg++) {
+    argv.push_back((char *) req->args[iarg].c_str());
+  }
+  argv.push_back(NULL);
+  int status = imginfo_main(argv.size()-1, &argv[0]);
+  // a -trace of this request is finished here (not at exit)
+  imginfo_trace_close();
+  return status;
 }
 
-double my_stod(const string& S)
+int serve_report(int itask, int status, const string& output, const string& result, void* arg)
 {
-  double f;
-  sscanf(S.c_str(),"%lf",&f);
-  return f;
+  serve_request *req = (serve_request *) arg;
+  string report = output;
+  int exit_status = EXIT_FAILURE;
+  if (WIFEXITED(status)) {
+    exit_status = WEXITSTATUS(status);
+  } else {
+    report += "\n\n ERROR - worker process terminated abnormally!\n\n";
+  }
+  return serve_answer(req->fd, exit_status, report, result);
 }
 
-int my_stoi(const string& S)
+int serve_answer(int fd, int exit_status, const string& report, const string& errors)
 {
-  int f;
-  sscanf(S.c_str(),"%d",&f);
-  return f;
+  char head[CHAR_ARRAY_LEN];
+  snprintf(head, sizeof(head), "IMGINFO %d %lu %lu\n", exit_status, (unsigned long) report.size(), (unsigned long) errors.size());
+  if (write_all(fd, head, strlen(head))<0 ||
+      write_all(fd, report.data(), report.size())<0 ||
+      write_all(fd, errors.data(), errors.size())<0) {
+    return 1;
+  }
+  return 0;
 }
 
-// http://stackoverflow.com/questions/352055/best-algorithm-to-strip-leading-and-trailing-spaces-in-c
-char *strstrip(char *s)
+void serve_connection(int fd)
 {
-    size_t size;
-    char *end;
+  serve_request req;
+  string request;
+  char chunk[CHUNK];
+  req.fd = fd;
+
+  // nobody else gets to run anything as us
+  struct ucred cred;
+  socklen_t ncred = sizeof(cred);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &ncred)<0 || cred.uid!=geteuid()) {
+    serve_answer(fd, EXIT_FAILURE, "", "\n ERROR: requests are only accepted from the user running the server!\n\n");
+    return;
+  }
+
+  // read up to the empty line ending the request
+  while (request.find("\n\n")==string::npos) {
+    ssize_t nread = read(fd, chunk, sizeof(chunk));
+    if (nread<0 && errno==EINTR) continue;
+    if (nread<=0 || request.size()+nread > SERVE_MAX_REQUEST) return;
+    request.append(chunk, nread);
+  }
+  size_t pos = 0, end;
+  while ((end = request.find('\n', pos))!=string::npos && end>pos) {
+    if (pos==0) {
+      req.cwd = request.substr(pos, end-pos);
+    } else {
+      req.args.push_back(request.substr(pos, end-pos));
+    }
+    pos = end + 1;
+  }
+  if (req.cwd.size()==0 || req.cwd[0]!='/') {
+    serve_answer(fd, EXIT_FAILURE, "", "\n ERROR: working directory of request is not an absolute path!\n\n");
+    return;
+  }
+  for (size_t iarg = 0; iarg < req.args.size(); iarg++) {
+    if (req.args[iarg]=="-cache" || req.args[iarg]=="-nocache") {
+      serve_answer(fd, EXIT_FAILURE, "", "\n ERROR: the server only uses its own header cache (no -cache or -nocache)!\n\n");
+      return;
+    }
+  }
+
+  if (run_workers(1, 1, serve_task, serve_report, &req)<0) {
+    printf("\n\n ERROR - unable to run worker processes!\n\n");
+    fflush(stdout);
+  }
+}
 
-    size = strlen(s);
+int serve(const char* path)
+{
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    printf("\n ERROR: socket name \"%s\" too long!\n\n",path);
+    return EXIT_FAILURE;
+  }
+
+  // everything a request would otherwise have to do first
+  setlocale(LC_ALL, "C");
+  imginfo_result res;
+  imginfo_ctx ctx;
+  ctx.iverb = iverb;
+  ctx.fatal = 0;
+  ctx.res   = &res;
+  ctx.file  = NULL;
+  if (!register_filters(&ctx)) {
+    fwrite(res.report.data(), 1, res.report.size(), stdout);
+    return EXIT_FAILURE;
+  }
+
+  int sfd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sfd<0) {
+    printf("\n ERROR: unable to create socket!\n\n");
+    return EXIT_FAILURE;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  // remove a socket left behind by a server that is no longer running
+  struct stat st;
+  if (stat(path, &st)==0 && S_ISSOCK(st.st_mode)) {
+    int cfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(cfd, (struct sockaddr *) &addr, sizeof(addr))==0) {
+      printf("\n ERROR: another server is already listening on \"%s\"!\n\n",path);
+      close(cfd);
+      close(sfd);
+      return EXIT_FAILURE;
+    }
+    close(cfd);
+    unlink(path);
+  }
+
+  // only we may connect
+  mode_t mask = umask(0077);
+  int bound = bind(sfd, (struct sockaddr *) &addr, sizeof(addr));
+  umask(mask);
+  if (bound<0 || listen(sfd, 128)<0) {
+    printf("\n ERROR: unable to listen on socket \"%s\"!\n\n",path);
+    close(sfd);
+    return EXIT_FAILURE;
+  }
+  serve_socket = path;
+  signal(SIGINT,  serve_stop);
+  signal(SIGTERM, serve_stop);
+  signal(SIGPIPE, SIG_IGN);
+  // finished connection handlers are reaped automatically
+  signal(SIGCHLD, SIG_IGN);
+
+  if (iverb>0) printf(" Serving requests on %s\n",path);
+  fflush(stdout);
+
+  while (2 != 3) {
+    int fd = accept(sfd, NULL, NULL);
+    if (fd<0) {
+      if (errno==EINTR || errno==ECONNABORTED) continue;
+      printf("\n ERROR: in accept on socket \"%s\"!\n\n",path);
+      break;
+    }
+    pid_t pid = fork();
+    if (pid==0) {
+      close(sfd);
+      signal(SIGINT,  SIG_DFL);
+      signal(SIGTERM, SIG_DFL);
+      signal(SIGCHLD, SIG_DFL);
+      serve_socket = NULL;
+      serve_connection(fd);
+      close(fd);
+      _exit(EXIT_SUCCESS);
+    }
+    if (pid<0) {
+      printf("\n ERROR: unable to start process for request!\n\n");
+    }
+    close(fd);
+  }
+  unlink(path);
+  close(sfd);
+  return EXIT_FAILURE;
+}
 
-    if (!size)
-            return s;
+int client(const char* path, int argc, char* argv[])
+{
+  struct sockaddr_un addr;
+  char cwd[PATH_MAX];
+  string request;
+
+  for (int iarg = 1; iarg < argc; iarg++) {
+    // the server can't read our stdin and only uses its own header cache
+    if (strlen(argv[iarg])==0 || strchr(argv[iarg],'\n')!=NULL ||
+        strcmp(argv[iarg],"-")==0 || strncmp(argv[iarg],"-,",2)==0 ||
+        strcmp(argv[iarg],"-cache")==0 || strcmp(argv[iarg],"-nocache")==0) return imginfo_main(argc, argv);
+    request += string(argv[iarg]) + "\n";
+  }
+  if (getcwd(cwd, sizeof(cwd))==NULL || strchr(cwd,'\n')!=NULL) return imginfo_main(argc, argv);
+  request = string(cwd) + "\n" + request + "\n";
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path)-1);
+  if (fd<0 || connect(fd, (struct sockaddr *) &addr, sizeof(addr))<0) {
+    if (fd>=0) close(fd);
+    return imginfo_main(argc, argv);
+  }
+  signal(SIGPIPE, SIG_IGN);
+  if (write_all(fd, request.data(), request.size())<0) {
+    printf("\n ERROR: unable to send request to server on \"%s\"!\n\n",path);
+    return EXIT_FAILURE;
+  }
+
+  string answer;
+  char chunk[CHUNK];
+  ssize_t nread;
+  while ((nread = read(fd, chunk, sizeof(chunk)))!=0) {
+    if (nread<0) {
+      if (errno==EINTR) continue;
+      break;
+    }
+    answer.append(chunk, nread);
+  }
+  close(fd);
+
+  int status;
+  unsigned long nbytes, nerrbytes;
+  size_t head = answer.find('\n');
+  if (head==string::npos ||
+      sscanf(answer.c_str(), "IMGINFO %d %lu %lu", &status, &nbytes, &nerrbytes)!=3 ||
+      answer.size()-head-1 != nbytes+nerrbytes) {
+    printf("\n ERROR: incomplete answer from server on \"%s\"!\n\n",path);
+    return EXIT_FAILURE;
+  }
+  fwrite(answer.data()+head+1, 1, nbytes, stdout);
+  fflush(stdout);
+  fwrite(answer.data()+head+1+nbytes, 1, nerrbytes, stderr);
+  return status;
+}
 
-    end = s + size - 1;
-    while (end >= s && isspace(*end))
-            end--;
-    *(end + 1) = '\0';
+// ==================================================================================================
+// NDJSON output (-format ndjson)
+//   one JSON object per file, followed by one per sweep. Values are given
+//   as read (no -norm), anything unset or NaN as null and floating-point
+//   numbers in the shortest form that reads back to the same value. The
+//   warnings and errors reported while reading the file are passed on as
+//   "messages" (one per diagnostic). Each file is written with a single
+//   fwrite into a large stdout buffer.
+// ==================================================================================================
+void json_string(string& out, const string& s)
+{
+  char u[8];
+  out += '"';
+  for (size_t i = 0; i < s.size(); i++) {
+    unsigned char c = s[i];
+    if      (c=='"')  out += "\\\"";
+    else if (c=='\\') out += "\\\\";
+    else if (c=='\n') out += "\\n";
+    else if (c=='\t') out += "\\t";
+    else if (c<0x20) {
+      snprintf(u, sizeof(u), "\\u%04x", c);
+      out += u;
+    }
+    else out += c;
+  }
+  out += '"';
+}
 
-    while (*s && isspace(*s))
-            s++;
+void json_double(string& out, double v)
+{
+  char buf[32];
+  if (isnan(v) || isinf(v)) {
+    out += "null";
+    return;
+  }
+  // 15 significant digits always read back exactly if the value has a
+  // representation that short - otherwise 16 or 17 are needed
+  for (int prec = 15; prec <= 17; prec++) {
+    snprintf(buf, sizeof(buf), "%.*g", prec, v);
+    if (prec==17 || strtod(buf, NULL)==v) break;
+  }
+  out += buf;
+}
 
-    return s;
+void json_key(string& out, const char* key)
+{
+  if (out[out.size()-1]!='{' && out[out.size()-1]!='[') out += ',';
+  out += '"';
+  out += key;
+  out += "\":";
 }
 
-// https://stackoverflow.com/questions/17333/what-is-the-most-effective-way-for-float-and-double-comparison
-bool AreSame(double a, double b, double diff)
+void json_add_string(string& out, const char* key, const string& v)
 {
-  if (iverb>2) {
-    printf("\n");
-    printf(" AreSame : a    = %20.12e\n",a);
-    printf("           b    = %20.12e\n",b);
-    printf("           a-b  = %20.12e\n",fabs(a - b));
-    printf("           diff = %20.12e\n",diff);
+  json_key(out, key);
+  if (v=="N/A") {
+    out += "null";
+  } else {
+    json_string(out, v);
   }
-  return fabs(a - b) <= diff;
 }
 
-bool stotime_t(time_t& result, const string& S, const string& format)
+void json_add_double(string& out, const char* key, double v)
 {
-  struct tm tm;
-  char* oldloc = setlocale(LC_TIME,"C");
-  if (strptime(S.c_str(), format.c_str(), &tm))
-    {
-      result = timegm(&tm);
-      setlocale(LC_TIME,oldloc);
-      return true;
-    }
-  else
-    {
-      setlocale(LC_TIME,oldloc);
-      return false;
-    }
+  json_key(out, key);
+  json_double(out, v);
 }
 
-string time_ttos(const time_t& T, const string& format = "%d %b %Y %H:%M:%S")
+void json_add_int(string& out, const char* key, long v)
 {
-  char Tbuf[200];
-  char* oldloc = setlocale(LC_TIME,"C");
-  struct tm* W;
-  W = gmtime(&T);
-  W->tm_isdst = -1;
-  strftime(Tbuf, sizeof(Tbuf)-3, format.c_str(), W);
-  setlocale(LC_TIME,oldloc);
-  return string(Tbuf);
+  char buf[32];
+  json_key(out, key);
+  snprintf(buf, sizeof(buf), "%ld", v);
+  out += buf;
 }
 
-int is_hdf5_eiger(const char* buffer)
+void json_add_doubles(string& out, const char* key, const double* v, int n)
 {
-  char sig[8];
-  int nchar = 8;
-  strycpy(sig, buffer, &nchar);
-  if ((sig[0] & 0xff)==0x89 &&
-      (sig[1] & 0xff)==0x48 &&
-      (sig[2] & 0xff)==0x44 &&
-      (sig[3] & 0xff)==0x46 &&
-      (sig[4] & 0xff)==0x0d &&
-      (sig[5] & 0xff)==0x0a ) {
-    return FORMAT_HDF5_EIGER;
-  } else {
-    return 0;
+  json_key(out, key);
+  out += '[';
+  for (int i = 0; i < n; i++) {
+    if (i>0) out += ',';
+    json_double(out, v[i]);
   }
+  out += ']';
+}
+
+// oscillation range as print_header reports it: end minus start of the
+// first axis (phi, omega, chi, kappa) that moves forward during the
+// image, to the 9 decimals it is printed with at most - otherwise the
+// one given in the header (if any)
+double header_oscillation(const image_header* h)
+{
+  double osc;
+  if (!isnan(h->phis) && !isnan(h->phie) && h->phie > h->phis &&
+      (h->phie != 0.0 || (h->phie-h->phis)<= 10.0)) osc = h->phie - h->phis;
+  else if (!isnan(h->omes) && !isnan(h->omee) && h->omee > h->omes) osc = h->omee - h->omes;
+  else if (!isnan(h->chis) && !isnan(h->chie) && h->chie > h->chis) osc = h->chie - h->chis;
+  else if (!isnan(h->kaps) && !isnan(h->kape) && h->kape > h->kaps) osc = h->kape - h->kaps;
+  else return h->osca;
+  return floor(osc*1.0e9 + 0.5)/1.0e9;
+}
+
+void print_header_ndjson(const imginfo_job* job, const image_header* h, const char* status, const vector<imginfo_diag>& diags,
+                         const imginfo_timings* t)
+{
+  static int buffered = 0;
+  if (!buffered) {
+    setvbuf(stdout, NULL, _IOFBF, 1024*1024);
+    buffered = 1;
+  }
+
+  string out = "{";
+  json_add_string(out, "file", job->path);
+  json_add_int   (out, "imgnum", job->imgnum);
+  json_add_string(out, "status", status);
+
+  if (h!=NULL) {
+    json_add_string(out, "format", h->format==FORMAT_HDF5_EIGER ? "HDF5/Eiger" : "N/A");
+    json_add_string(out, "date", h->date);
+    json_key(out, "epoch");
+    if (h->date!="N/A") {
+      json_double(out, (double) h->epoch + (h->msec>=0 ? h->msec/1000.0 : 0.0));
+    } else {
+      out += "null";
+    }
+    json_add_string(out, "detector_id", h->detn);
+    json_add_double(out, "distance", h->dist);
+    json_add_double(out, "wavelength", h->wave);
+    json_add_double(out, "oscillation", header_oscillation(h));
+    json_add_double(out, "phi_start", h->phis);
+    json_add_double(out, "phi_end", h->phie);
+    json_add_double(out, "omega_start", h->omes);
+    json_add_double(out, "omega_end", h->omee);
+    json_add_double(out, "chi_start", h->chis);
+    json_add_double(out, "chi_end", h->chie);
+    json_add_double(out, "kappa_start", h->kaps);
+    json_add_double(out, "kappa_end", h->kape);
+    json_add_double(out, "two_theta", h->twot);
+    json_add_double(out, "pixel_size_x", h->pixx);
+    json_add_double(out, "pixel_size_y", h->pixy);
+    json_add_int   (out, "pixels_x", h->numx);
+    json_add_int   (out, "pixels_y", h->numy);
+    json_add_double(out, "beam_centre_x", h->beax);
+    json_add_double(out, "beam_centre_y", h->beay);
+    json_add_int   (out, "overload", h->ovld);
+    json_add_double(out, "exposure_time", h->etime);
+    json_add_double(out, "flux", h->flux);
+    json_add_double(out, "sensor_thickness", h->thick);
+    json_add_string(out, "sensor_material", h->sensm);
+    json_add_double(out, "polarization_fraction", h->fpol);
+    json_add_int   (out, "nimages", h->nimg);
+    json_add_int   (out, "ntrigger", h->ntrg);
+    json_add_int   (out, "image_number", h->imgn);
+    json_add_int   (out, "last_image_number", h->imgl);
+    json_add_int   (out, "image_offset", h->imgo);
+    json_add_int   (out, "images_missing", h->nmis);
+    json_add_string(out, "rotation_axis", h->rota);
+    json_add_int   (out, "nsweeps", h->swps.size());
+    json_key(out, "filters");
+    out += '[';
+    for (size_t ifilt = 0; ifilt < h->filt.size(); ifilt++) {
+      out += '{';
+      json_add_int   (out, "id", h->filt[ifilt].id);
+      json_add_string(out, "name", h->filt[ifilt].name);
+      out += '}';
+      if (ifilt+1 < h->filt.size()) out += ',';
+    }
+    out += ']';
+    json_key(out, "data_files");
+    out += '[';
+    for (size_t ifile = 0; ifile < h->extf.size(); ifile++) {
+      if (ifile>0) out += ',';
+      json_string(out, h->extf[ifile]);
+    }
+    out += ']';
+  }
+
+  // warnings and errors only: everything else is in the fields above
+  json_key(out, "messages");
+  out += '[';
+  int nmsg = 0;
+  for (size_t idiag = 0; idiag < diags.size(); idiag++) {
+    if (diags[idiag].level<IMGINFO_WARNING) continue;
+    if (nmsg++>0) out += ',';
+    json_string(out, diags[idiag].text);
+  }
+  out += ']';
+  if (t!=NULL) json_add_timings(out, t);
+  out += "}\n";
+
+  if (h!=NULL) {
+    for (size_t isweep = 0; isweep < h->swps.size(); isweep++) {
+      const image_sweep *sw = &h->swps[isweep];
+      out += '{';
+      json_add_string (out, "file", job->path);
+      json_add_int    (out, "sweep", isweep+1);
+      json_key(out, "continuation");
+      out += sw->cont ? "true" : "false";
+      json_add_int    (out, "first_image", sw->img1);
+      json_add_int    (out, "last_image", sw->img2);
+      json_add_doubles(out, "omega", sw->omeg, 4);
+      json_add_doubles(out, "kappa", sw->kapp, 4);
+      json_add_doubles(out, "chi", sw->chi, 4);
+      json_add_doubles(out, "phi", sw->phi, 4);
+      json_add_doubles(out, "two_theta", sw->twot, 4);
+      out += "}\n";
+    }
+  }
+
+  fwrite(out.data(), 1, out.size(), stdout);
+  fflush(stdout);
 }
 
 // ==================================================================================================
-// get_header_XYZ
+// process_file: report for a single <file-N> argument (or one image of it)
+//   returns 1 on success, 0 if the file could not be read at all and -1
+//   if the header could not be extracted (which is fatal). The file is
+//   read through the given handle - shared by consecutive jobs for the
+//   same file (see same_file) - or through one of its own if NULL.
 // ==================================================================================================
+image_table image_tab;
 
-int get_header_eiger(const char* path, const int imgnum, image_header* h)
+imginfo_options job_options(const imginfo_job* job)
 {
+  imginfo_options opt = imginfo_default_options();
+  opt.iverb    = job->iverb;
+  opt.h5check  = job->h5check;
+  opt.h5jobs   = job->h5jobs;
+  opt.h5resume = job->h5resume;
+  opt.h5mem    = job->h5mem;
+  // what -h5check finds gives the image numbers of bad frames
+  opt.verify   = job->verify;
+  if (job->verify || job->output==OUTPUT_MANIFEST) opt.h5check = 1;
+  opt.timings  = job->timings;
+  opt.sweep_summary = job->sweep_summary;
+  if (job->output==OUTPUT_IMAGES || job->output==OUTPUT_IMAGES_RAW) {
+    opt.per_image     = image_table_rows;
+    opt.per_image_arg = &image_tab;
+  }
+  return opt;
+}
 
-  vector<string> fields;
+imginfo_file* open_job_file(const imginfo_job* job)
+{
+  imginfo_options opt = job_options(job);
+  return imginfo_open(job->path.c_str(), &opt);
+}
 
-  hid_t fid;
-  herr_t status;
+int same_file(const imginfo_job* a, const imginfo_job* b)
+{
+  return ( a->path==b->path && a->iverb==b->iverb && a->h5check==b->h5check && a->h5jobs==b->h5jobs &&
+           a->h5resume==b->h5resume && a->h5mem==b->h5mem && a->output==b->output &&
+           a->imglast==b->imglast && a->frame_threads==b->frame_threads && a->verify==b->verify &&
+           a->manifest==b->manifest && a->hashes==b->hashes && a->timings==b->timings &&
+           a->sweep_summary==b->sweep_summary );
+}
+
+int process_file(const imginfo_job* job, imginfo_file* file)
+{
+  imginfo_result res;
+  const char *path = job->path.c_str();
+
+  iverb = job->iverb;
+  if (job->output==OUTPUT_IMAGES || job->output==OUTPUT_IMAGES_RAW) {
+    return process_file_images(job, file);
+  }
+  if (job->output==OUTPUT_FRAMES) {
+    return process_file_frames(job, file);
+  }
+  if (job->output==OUTPUT_MANIFEST) {
+    return process_file_manifest(job, file);
+  }
+
+  // in NDJSON mode the warnings and errors reported while reading the
+  // file end up as "messages" in its JSON object
+  int ndjson = ( job->output==OUTPUT_NDJSON );
+  if (!ndjson) printf("\n\n ################# File = %s\n\n",path);
+
+  // with a header cache: report a valid entry straight away - otherwise
+  // store what imginfo_read reports afterwards
+  int use_cache = ( job->cache.size()>0 && cache_open(job->cache) );
+  file_stamp master;
+  if (use_cache) {
+    empty_header(&res.h);
+    if (cache_lookup(job, &res.h, res.report, res.diags)) {
+      if (ndjson) {
+        print_header_ndjson(job, &res.h, "ok", res.diags, NULL);
+      } else {
+        fwrite(res.report.data(), 1, res.report.size(), stdout);
+        print_header(&res.h,job->idet,job->inorm);
+      }
+      return 1;
+    }
+    get_file_stamp(path, &master);
+  }
 
-  // get directory part of input file (required for later reading data
-  // from external files)
-  char * t = (char *)malloc(strlen(path) + 1);
-  strcpy(t,path);
-  char *dir;
-  char epoch_date[20];
-  dir = dirname(t);
+  imginfo_file* own = ( file==NULL ) ? (file = open_job_file(job)) : NULL;
+  int status = imginfo_read_image(file, job->imgnum, &res);
+  imginfo_close(own);
+  const imginfo_timings *t = job->timings ? &res.timings : NULL;
 
-  // for units see: http://download.nexusformat.org/doc/html/nxdl-types.html
+  if (!ndjson) fwrite(res.report.data(), 1, res.report.size(), stdout);
 
-  // Open the file
-  if (iverb>1) printf("\n Opening file %s\n\n",path);
-  fid = H5Fopen(path, H5F_ACC_RDONLY, H5P_DEFAULT);
-  if (fid<0) {
-    printf("\n\n ERROR - unable to open file \"%s\"!\n\n",path);
+  switch (status) {
+  case IMGINFO_FATAL:
+    if (ndjson) print_header_ndjson(job, NULL, "error", res.diags, t);
+    fflush(stdout);
     exit(EXIT_FAILURE);
+  case IMGINFO_UNREADABLE:
+    if (ndjson) print_header_ndjson(job, NULL, "unreadable", res.diags, t);
+    return 0;
+  case IMGINFO_NO_HEADER:
+    if (ndjson) {
+      print_header_ndjson(job, NULL, "error", res.diags, t);
+    } else {
+      printf("\n\nError reading file header\n");
+    }
+    return -1;
   }
 
-#ifdef USE_BITSHUFFLE
-  if (bshuf_register_h5filter()<0) {
-    printf("\n\n ERROR - unable to register Bitshuffle filter!\n\n");
-    exit(EXIT_FAILURE);
-  }
-#endif
-#ifdef USE_LZ4
-  if (H5Zregister(H5Z_LZ4)<0) {
-    printf("\n\n ERROR - unable to register H5Z_LZ4!\n\n");
-    exit(EXIT_FAILURE);
-  }
-#endif
-
-  if (iverb>2)  {
-    hid_t cpl = H5Fget_create_plist(fid);
-    hdf5_list_filters(cpl);
-  }
-
-  if (iverb>2)              printf(" ... will read /entry/instrument/detector/description\n");
-  char *description          = hdf5_read_char(fid,"/entry/instrument/detector/description");
-  if (iverb>2)              printf(" ... will read /entry/instrument/detector/detector_number\n");
-  char *detector_number      = hdf5_read_char(fid,"/entry/instrument/detector/detector_number");
-  if (detector_number != NULL) {
-    h->detn = detector_number;
-  }
-  else {
-    if (iverb>2)         printf(" ... will read /entry/instrument/detector/serial_number\n");
-    detector_number      = hdf5_read_char(fid,"/entry/instrument/detector/serial_number");
-    if (detector_number != NULL) {
-      h->detn = detector_number;
-    }
-  }
-
-  if (iverb>2)              printf(" ... will read /entry/instrument/detector/sensor_material\n");
-  char *sensor_material      = hdf5_read_char(fid,"/entry/instrument/detector/sensor_material");
-  if (sensor_material!=NULL) {
-    h->sensm = sensor_material;
-    if (h->sensm != "Si" && h->sensm != "CdTe" && h->sensm != "Silicon" ) {
-      printf("\n WARNING: item \"/entry/instrument/detector/sensor_material\" gives material as \"%s\" when \"Silicon\" (or \"Si\" or \"CdTe\") seems more common!\n\n",sensor_material);
-    }
-  }
-  if (iverb>2)              printf(" ... will read /entry/instrument/detector/detectorSpecific/data_collection_date\n");
-  char *data_collection_date = hdf5_read_char(fid,"/entry/instrument/detector/detectorSpecific/data_collection_date");
-  if (iverb>2)              printf(" ... will read /entry/instrument/detector/detectorSpecific/eiger_fw_version\n");
-  char *eiger_fw_version     = hdf5_read_char(fid,"/entry/instrument/detector/detectorSpecific/eiger_fw_version");
-
-  if ( (data_collection_date == NULL) || (data_collection_date[0] == '\0') ) {
-
-    // check if we have /entry/start_time
-    if (iverb>2)        printf(" ... will read /entry/start_time\n");
-    data_collection_date = hdf5_read_char(fid,"/entry/start_time");
-
-    if ( (data_collection_date == NULL) || (data_collection_date[0] == '\0') ) {
-      // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
-      data_collection_date = strcpy(epoch_date,"1970-01-01T00:00:01");
-      if (iverb>2) printf("     Setting date to \"%s\"\n",data_collection_date);
-    }
-
-  }
-  fields = tokenise_cbf_header(data_collection_date);
-  if (fields[0].length()==13) {
-    if ( (fields[0].substr(4,1) == "-") && (fields[0].substr(7,1) == "-") && (fields[0].substr(10,1) == "T") ) {
-      // 2015-11-10T17:17:02.057611
-      if (stotime_t(h->epoch,data_collection_date,"%Y-%m-%dT%H:%M:%S")) {
-	if (fields[2].substr(2,1) == ".") {
-	  h->msec = rintf((my_stoi(fields[2].substr(3))/1000.0));
-	}
-	h->date = time_ttos(h->epoch);
-      }
-    }
-  }
-
-  if (iverb>2)  printf(" ... will read /entry/instrument/detector/detectorSpecific/nimages\n");
-  int nimages     = hdf5_read_int(fid,"/entry/instrument/detector/detectorSpecific/nimages");
-
-  if (nimages==INIT_INT||nimages<=0) {
-    // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
-    char *axes = hdf5_read_group_attribute(fid,"/entry/data","axes");
-    if (iverb>2) printf("     axes = \"%s\"\n",axes);
-    if ( axes != NULL && strcmp(axes,"omega")==0 ) {
-      if (iverb>2) printf("     will determine nimages from /entry/data/omega\n");
-      nimages     = hdf5_read_dataset_size(fid,"/entry/data/omega");
-      if (iverb>2) printf("     nimages = \"%d\"\n",nimages);
-    }
+  if (use_cache) cache_store(job, &master, &res.h, res.report, res.diags);
+  if (ndjson) {
+    print_header_ndjson(job, &res.h, "ok", res.diags, t);
   } else {
-    if (nimages==INIT_INT) {
-      status = H5Fclose(fid);
-      printf("\n ERROR: no item \"/entry/instrument/detector/detectorSpecific/nimages\" found!\n\n");
-      return 0;
-    }
-    if (nimages==0) {
-      status = H5Fclose(fid);
-      printf("\n ERROR: no images found (\"/entry/instrument/detector/detectorSpecific/nimages\" is 0)!\n\n");
-      return 0;
-    }
+    print_header(&res.h,job->idet,job->inorm);
+    if (t!=NULL) print_timings(t);
   }
+  return 1;
+}
 
-  int nimages_per_trigger = nimages;
-  if (iverb>2) printf(" ... will read /entry/instrument/detector/detectorSpecific/ntrigger\n");
-  int ntrigger   = hdf5_read_int(fid,"/entry/instrument/detector/detectorSpecific/ntrigger");
-  if (ntrigger==INIT_INT||ntrigger<0) {
-    // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
-    ntrigger = 1;
-  } else {
-    if (ntrigger!=INIT_INT) {
-      if (ntrigger==0) {
-	printf("\n WARNING: item \"/entry/instrument/detector/detectorSpecific/ntrigger\" is set to 0?\n");
-	ntrigger = 1;
-      }
-      else if (ntrigger<0) {
-	printf("\n WARNING: item \"/entry/instrument/detector/detectorSpecific/ntrigger\" is set to negative value %d?\n",ntrigger);
-	ntrigger = 1;
-      }
-      else {
-	nimages = nimages_per_trigger * ntrigger;
-	if (ntrigger>1) {
-	  printf("\n Note: assuming a total of %d images (based on %d images for each of the %d triggers)\n",nimages,nimages_per_trigger,ntrigger);
-	}
-      }
+// ==================================================================================================
+// -timings
+//   where the time of each file went (see imginfo_timings) and, at the
+//   end, of the whole run - CPU time and peak RSS then include worker
+//   processes (-j, -h5jobs)
+// ==================================================================================================
+void json_add_timings(string& out, const imginfo_timings* t)
+{
+  json_key(out, "timings");
+  out += '{';
+  for (int iphase = 0; iphase < IMGINFO_NPHASES; iphase++) {
+    json_key(out, imginfo_phase_name[iphase]);
+    out += '{';
+    json_add_double(out, "wall", t->wall[iphase]);
+    json_add_double(out, "cpu", t->cpu[iphase]);
+    json_key(out, "read");
+    if (t->nread[iphase]>=0.0) {
+      json_double(out, t->nread[iphase]);
     } else {
-      ntrigger = 1;
+      out += "null";
     }
+    out += '}';
   }
-
-  int ntrigger_use = ntrigger;
-
-  int img = 0;
-  int img2 = nimages_per_trigger - 1;
-  if (imgnum>0) {
-    img = imgnum - 1;
-    ntrigger_use = 1;
-    img2 = img;
-  }
-
-  double *omega_trigger_start = (double *)calloc(ntrigger*2,sizeof(double));
-  if (omega_trigger_start == NULL) {
-    printf("\n ERROR: unable to allocate omega_start(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *omega_trigger_end = (double *)calloc(ntrigger*2,sizeof(double));
-  if (omega_trigger_end == NULL) {
-    printf("\n ERROR: unable to allocate omega_end(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *kappa_trigger_start = (double *)calloc(ntrigger*2,sizeof(double));
-  if (kappa_trigger_start == NULL) {
-    printf("\n ERROR: unable to allocate kappa_start(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *kappa_trigger_end = (double *)calloc(ntrigger*2,sizeof(double));
-  if (kappa_trigger_end == NULL) {
-    printf("\n ERROR: unable to allocate kappa_end(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *phi_trigger_start = (double *)calloc(ntrigger*2,sizeof(double));
-  if (phi_trigger_start == NULL) {
-    printf("\n ERROR: unable to allocate phi_start(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *phi_trigger_end = (double *)calloc(ntrigger*2,sizeof(double));
-  if (phi_trigger_end == NULL) {
-    printf("\n ERROR: unable to allocate phi_end(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *chi_trigger_start = (double *)calloc(ntrigger*2,sizeof(double));
-  if (chi_trigger_start == NULL) {
-    printf("\n ERROR: unable to allocate chi_start(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *chi_trigger_end = (double *)calloc(ntrigger*2,sizeof(double));
-  if (chi_trigger_end == NULL) {
-    printf("\n ERROR: unable to allocate chi_end(ntrigger*2) array!\n\n");
-    return 0;
+  json_key(out, "calls");
+  out += '{';
+  for (int icall = 0; icall < IMGINFO_NCALLS; icall++) {
+    json_add_int(out, imginfo_call_name[icall], t->calls[icall]);
   }
-  double *two_theta_trigger_start = (double *)calloc(ntrigger*2,sizeof(double));
-  if (two_theta_trigger_start == NULL) {
-    printf("\n ERROR: unable to allocate two_theta_start(ntrigger*2) array!\n\n");
-    return 0;
-  }
-  double *two_theta_trigger_end = (double *)calloc(ntrigger*2,sizeof(double));
-  if (two_theta_trigger_end == NULL) {
-    printf("\n ERROR: unable to allocate two_theta_end(ntrigger*2) array!\n\n");
-    return 0;
-  }
-
-  int *nimage_to_imgnum = (int *)calloc(nimages,sizeof(int));
-  if (nimage_to_imgnum == NULL) {
-    printf("\n ERROR: unable to allocate nimage_to_imgnum(nimages) array!\n\n");
-    return 0;
-  }
-  for (int inimage_to_imgnum = 1; inimage_to_imgnum <= nimages; inimage_to_imgnum++ ) {
-    nimage_to_imgnum[inimage_to_imgnum-1]=inimage_to_imgnum;
-  }
-
-  int img_offset = 0;
-  if (img>nimages) {
-    // enforce HDF5 checking (for obvious reasons). Remember that we
-    // could still have an undetected offset - which is why autoPROC
-    // enforces h5check throughout.
-    h5check++;
-  }
-
-  if (h5check>0) {
-    // -------------------------------------------------------------------------
-    // need to check for accessibility of all nimages images
-    H5G_info_t group_info;
-    hid_t gid = H5Gopen2(fid,"/entry/data",H5P_DEFAULT);
-    if (gid < 0) {
-      printf("\n\n ERROR - in H5Gopen2 (group=\"/entry/data\")!\n\n");
-      return(-1);
-    }
-    if (H5Gget_info(gid,&group_info)<0) {
-      printf("\n\n ERROR - in H5Gget_info (group=\"/entry/data\")!\n\n");
-      return(-1);
-    }
-    if (iverb>2) {
-      printf("   nlinks in group /entry/data = %d\n", (int)group_info.nlinks);
-    }
-
-    // need to check each link to see if it is an external link
-    hsize_t n_external_links = 0;
-    for (hsize_t ilink=0; ilink<group_info.nlinks; ilink++) {
-
-      ssize_t link_size = 1 + H5Lget_name_by_idx (gid, ".", H5_INDEX_NAME, H5_ITER_INC,
-						  ilink, NULL, 0, H5P_DEFAULT);
-
-      char *link_name = (char *) malloc (link_size);
-
-      link_size = H5Lget_name_by_idx (gid, ".", H5_INDEX_NAME, H5_ITER_INC, ilink, link_name,
-				      (size_t) link_size, H5P_DEFAULT);
-
-      H5L_info_t link_info;
-      status = H5Lget_info_by_idx(gid, ".", H5_INDEX_NAME, H5_ITER_INC, ilink, &link_info, H5P_DEFAULT);
-      if (status<0) {
-	printf("\n\n ERROR - in H5Lget_info_by_idx (group=\"/entry/data\")!\n\n");
-	return(-1);
-      }
-
-      if (link_info.type==H5L_TYPE_EXTERNAL) {
-	n_external_links++;
-      }
-
-      if (iverb>2) {
-	if (link_info.type==H5L_TYPE_HARD) {
-	  printf ("     link #%d (hard) = \"%s\"\n", (int) ilink, link_name);
-	}
-	else if (link_info.type==H5L_TYPE_SOFT) {
-	  printf ("     link #%d (soft) = \"%s\"\n", (int) ilink, link_name);
-	}
-	else if (link_info.type==H5L_TYPE_EXTERNAL) {
-	  printf ("     link #%d (external) = \"%s\"\n", (int) ilink, link_name);
-	}
-	else if (link_info.type==H5L_TYPE_ERROR) {
-	  printf ("     link #%d (error) = \"%s\"\n", (int) ilink, link_name);
-	}
-	else {
-	  printf ("     link #%d gave error\n", (int) ilink);
-	}
-      }
-
-      free (link_name);
-    }
-
-    if (iverb>2) {
-      printf("\n");
-    }
-
-    if (H5Gclose(gid)<0) {
-      printf("\n\n ERROR - in H5Gclose!\n\n");
-      return(-1);
-    }
-
-    char link[27];
-
-    int nimages_found = 0;
-    int have_image_nr_high = 1;
-    for (hsize_t ilink = 1; ilink <= n_external_links; ilink++ ) {
-      sprintf(link,"/entry/data/data_%6.6d",ilink);
-      H5L_info_t link_info;
-      if (H5Lget_info(fid, link, &link_info, H5P_DEFAULT)<0) {
-	printf("\n\n ERROR - in H5Lget_info (link=%s)!\n\n",link);
-	return(-1);
-      }
-      if (link_info.type!=H5L_TYPE_EXTERNAL) {
-	fprintf(stderr,"\n\n ERROR: unsupported link type for %s !\n\n",link);
-	return(2);
-      }
-
-      // get full path of external file
-      H5L_info_t li;
-      const char *filename;
-      const char *path;
-      if (H5Lget_info(fid,link,&li,H5P_DEFAULT) < 0) {
-	printf("\n\n ERROR - in H5Lget_info!\n\n");
-	return(-1);
-      }
-
-      size_t val_size = li.u.val_size;
-      char *buf[val_size];
-      if (H5Lget_val(fid,link,(void *)buf,val_size,H5P_DEFAULT) < 0 ) {
-	printf("\n\n ERROR - in H5Lget_val!\n\n");
-	return(-1);
-      }
-      if ( H5Lunpack_elink_val(buf, val_size, NULL, &filename, &path) < 0 ) {
-	printf("\n\n ERROR - in H5Lunpack_elink_val!\n\n");
-	return(-1);
-      }
-      if (iverb>2) printf("     [link=%d] dir=%s filename=%s path=%s\n",ilink,dir,filename,path);
-      if (iverb>2) printf("     [link=%d] strlen(dir)=%lu strlen(filename)=%lu strlen(path)=%lu\n",ilink,strlen(dir),strlen(filename),strlen(path));
-
-      size_t f_size = strlen(dir) + 1 + strlen(filename) + 1;
-      char *f = (char *)malloc(f_size);
-      strcpy(f,dir);
-      strcat(f,"/");
-      strcat(f,filename);
-
-      // start reading from external file
-      hid_t eid = H5Fopen(f, H5F_ACC_RDONLY, H5P_DEFAULT);
-      if (eid<0) {
-	printf("\n\n ERROR - in H5Fopen (%s)!\n\n",f);
-	break;
-      }
-
-      int image_nr_low = 0;
-      int image_nr_high = 0;
-
-      hid_t did = H5Dopen2(eid, path, H5P_DEFAULT);
-      if (did<0) {
-	printf("\n\n ERROR - in H5Dopen2 (file=\"%s\" path=\"%s\")!\n\n",f,path);
-	return(-1);
-      }
-
-      if (ilink==1&&iverb>0) {
-        hid_t cpl = H5Dget_create_plist(did);
-        hdf5_list_filters(cpl);
-      }
-
-      status = H5Aexists(did,"image_nr_high");
-      if (status<=0) {
-	if (iverb>1&&have_image_nr_high==1) {
-	  printf("     WARNING: problem finding attribute \"%s\" in dataset \"%s\".\n","image_nr_high",f);
-	  printf("              We will assume images are starting at 1 and come in sequential order.\n");
-	}
-	have_image_nr_high=0;
-	hid_t space_id = H5Dget_space (did);
-	hsize_t dims_id[3] = {1,1,1};
-	int ndims_id = H5Sget_simple_extent_dims (space_id, dims_id, NULL);
-	if (iverb>2) {
-	  printf("     dims_id[0]=%llu\n",dims_id[0]);
-	}
-
-	for (hsize_t inimage_to_imgnum = nimages_found; inimage_to_imgnum < (nimages_found + dims_id[0]); inimage_to_imgnum++ ) {
-	  nimage_to_imgnum[inimage_to_imgnum] = inimage_to_imgnum + 1;
-	}
-	nimages_found = nimages_found + dims_id[0];
-
-      } else {
-	hid_t aid = H5Aopen_by_name(did,".","image_nr_high",H5P_DEFAULT,H5P_DEFAULT);
-	if (aid>0) {
-	  int    data_i[10];
-	  if (H5Aread(aid,H5T_NATIVE_INT,data_i) >= 0 ) {
-	    image_nr_high = data_i[0];
-	    hid_t aid2 = H5Aopen_by_name(did,".","image_nr_low",H5P_DEFAULT,H5P_DEFAULT);
-	    if (aid2>0) {
-	      if (H5Aread(aid2,H5T_NATIVE_INT,data_i) >= 0 ) {
-		image_nr_low = data_i[0];
-		if (iverb>2) {
-		  printf("     %s %s/image_nr_low  = %d\n",f,path,image_nr_low);
-		  printf("     %s %s/image_nr_high = %d\n",f,path,image_nr_high);
-		}
-		for (int inimage_to_imgnum = nimages_found; inimage_to_imgnum < (nimages_found + (image_nr_high - image_nr_low + 1)); inimage_to_imgnum++ ) {
-		  nimage_to_imgnum[inimage_to_imgnum]=image_nr_low + (inimage_to_imgnum-nimages_found);
-		}
-		nimages_found = nimages_found + (image_nr_high - image_nr_low + 1);
-	      }
-	      status = H5Aclose(aid2);
-	    }
-	  }
-	  status = H5Aclose(aid);
-	}
-      }
-    }
+  out += '}';
+  json_add_int(out, "peak_rss_kb", peak_rss_kb());
+  out += '}';
+}
 
-    if (nimages<nimages_found) {
-      printf("\n WARNING: there seem to be more images in the EXTERNAL LINK files (%d) than we\n",nimages_found);
-      printf("          expected (%d) - which doesn't make much sense. Please check with beamline\n",nimages);
-      printf("          staff and get back to us!\n");
-    }
-    else if (nimages>nimages_found) {
-      printf("\n WARNING: there seem to be fewer images in the EXTERNAL LINK files (%d) than we\n",nimages_found);
-      printf("          expected (%d) - which looks like an interupted data collection? We will\n",nimages);
-      printf("          assume that this smaller number is the correct one to use (but please check\n");
-      printf("          and get back to beamline staff or us)!\n");
-      nimages=nimages_found;
+void print_timings(const imginfo_timings* t)
+{
+  double wall = 0.0, cpu = 0.0, nread = 0.0;
+  printf("\n ===== Timings:\n");
+  printf(" phase                      wall [ms]    cpu [ms]   read [kB]\n");
+  for (int iphase = 0; iphase < IMGINFO_NPHASES; iphase++) {
+    printf(" %-22s %12.3f %11.3f",imginfo_phase_name[iphase],1000.0*t->wall[iphase],1000.0*t->cpu[iphase]);
+    if (t->nread[iphase]>=0.0) {
+      printf(" %11.1f\n",t->nread[iphase]/1024.0);
     } else {
-      if (iverb>1) {
-	printf("\n\n Good - expected and found number of images identical (%d)!\n\n",nimages);
-      }
+      printf(" %11s\n","N/A");
     }
-
+    wall  += t->wall[iphase];
+    cpu   += t->cpu[iphase];
+    nread += (t->nread[iphase]>0.0) ? t->nread[iphase] : 0.0;
   }
-
-  int img1use = img;
-  int img2use = img2;
-
-  if (img>nimages) {
-
-    // if we requested an image outside the 1..nimages range:
-    if (h5check>0) {
-      // is it within our array of images
-      for (int iimg = 0; iimg < nimages; iimg++ ) {
-	if (nimage_to_imgnum[iimg]==(img+1)) {
-	  img1use = iimg;
-	  img2use = iimg + (img2 - img);
-	  break;
-	}
-      }
-    }
-    if (img1use>nimages) {
-      printf("\n ERROR: requested image number %d but only %d images present!\n\n",(img+1),nimages);
-      return 0;
-    }
+  printf(" %-22s %12.3f %11.3f %11.1f\n","total",1000.0*wall,1000.0*cpu,nread/1024.0);
+  printf(" HDF5 calls                         =");
+  for (int icall = 0; icall < IMGINFO_NCALLS; icall++) {
+    printf(" %s %ld%s",imginfo_call_name[icall],t->calls[icall],(icall+1<IMGINFO_NCALLS) ? "," : "\n");
   }
+  printf(" peak RSS                      [MB] = %.1f\n",peak_rss_kb()/1024.0);
+}
 
-  double *omega, *omega_end, *omega_axis;
-  double omega_range_average, omega_range_total, omega_increment;
-  double *kappa, *kappa_end, *kappa_axis;
-  double kappa_range_average, kappa_range_total;
-  double *chi, *chi_end, *chi_axis;
-  double chi_range_average, chi_range_total;
-  double *phi, *phi_end, *phi_axis;
-  double phi_range_average, phi_range_total, phi_increment;
-  double *two_theta, *two_theta_end, *two_theta_axis;
-  double two_theta_range_average, two_theta_range_total;
-
-  double *detector_distance_vector, *fast_pixel_vector, *slow_pixel_vector;
-  int ihave_omega     = 0;
-  int ihave_kappa     = 0;
-  int ihave_chi       = 0;
-  int ihave_phi       = 0;
-  int ihave_two_theta = 0;
-  int esgo = 0;
-  int itrigger_prev = -1;
-  int ndatasets = 0;
-  for (int itrigger = 0; itrigger < ntrigger_use; itrigger++) {
-
-    int itrigger2 = itrigger+ntrigger_use;
-
-    if (itrigger==0) {
-      if (iverb>2)              printf(" ... check for /entry/sample\n");
-      if (H5Lexists(fid,"/entry/sample",H5P_DEFAULT)>0) {
-	if (iverb>2)              printf(" ... check for /entry/sample/goniometer\n");
-	if (H5Lexists(fid,"/entry/sample/goniometer",H5P_DEFAULT)>0) {
-       	  if (iverb>2)              printf(" ... check for /entry/sample/goniometer/omega\n");
-       	  if (H5Lexists(fid,"/entry/sample/goniometer/omega",H5P_DEFAULT)>0) {
-	    if (iverb>2)              printf(" ... will read /entry/sample/goniometer/omega\n");
-	    omega                   = hdf5_read_ndouble(fid,"/entry/sample/goniometer/omega","degree",&nimages);
-	    if (iverb>2)              printf(" ... will read /entry/sample/goniometer/omega_end\n");
-	    omega_end               = hdf5_read_ndouble(fid,"/entry/sample/goniometer/omega_end","degree",&nimages);
-	    if (iverb>2)              printf(" ... will read /entry/sample/goniometer/omega_range_average\n");
-	    omega_range_average     = hdf5_read_double (fid,"/entry/sample/goniometer/omega_range_average","degree");
-	    if (iverb>2)              printf(" ... will read /entry/sample/goniometer/omega_range_total\n");
-	    omega_range_total       = hdf5_read_double (fid,"/entry/sample/goniometer/omega_range_total","degree");
-	    if (iverb>2)              printf(" ... will read /entry/sample/goniometer/omega_increment\n");
-	    omega_increment         = hdf5_read_double (fid,"/entry/sample/goniometer/omega_increment","degree");
-	    if (isnan(omega_increment)&&nimages>1) {
-	      if (!isnan(omega[0])&&!isnan(omega[1])) {
-		omega_increment = omega[1]-omega[0];
-	      }
-	    }
-	    ihave_omega = 1;
-	    esgo = 1;
-	  }
-	}
-      }
-      if (ihave_omega==0) {
-	if (iverb>2) printf(" ... check axes\n");
-	// Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
-	char *axes = hdf5_read_group_attribute(fid,"/entry/data","axes");
-	if (iverb>2) printf("     axes = \"%s\"\n",axes);
-	
-	int check_for_omega = 0;
-        char omega_str[CHAR_ARRAY_LEN] = "/entry/data/omega";
-
-	if (axes==NULL) {
-	  if (iverb>2) printf("     axes undefined?\n");
-	  check_for_omega = 1;
-	}
-	else if (strcmp(axes,"omega")==0 ) {
-	  check_for_omega = 1;
-	}
-        // Diamond files (Mpro-P1623_2_master.h5, I04-1, 20210619 06:17) named that differently:
-	else if (strcmp(axes,"gonomega")==0 ) {
-	  check_for_omega = 2;
-          strcpy(omega_str,"/entry/data/gonomega");
-	}
-	if (check_for_omega>=1) {
-       	  if (H5Lexists(fid,omega_str,H5P_DEFAULT)>0) {
-	    if (iverb>2)              printf(" ... will read %s\n",omega_str);
-	    omega                   = hdf5_read_ndouble(fid,omega_str,"deg",&nimages);
-	    if (!isnan(omega[0])&&!isnan(omega[1])) {
-	      omega_increment = omega[1]-omega[0];
-	      if (iverb>2)              printf(" ... setting omega_increment to %f\n",omega_increment);
-	      omega_end       = hdf5_read_ndouble(fid,omega_str,"deg",&nimages);
-	      for(int i_image = 0; i_image < nimages; i_image++) {
-		omega_end[i_image] = omega_end[i_image] + omega_increment;
-	      }
-	      ihave_omega = 1;
-	      esgo = 0;
-	    }
-	  }
-	} else {
-	  if (iverb>2)              printf("     axes read/set as \"%s\"\n",axes);
-	}
-      }
-    }
-    if (ihave_omega==1) {
-      if (!isnan(omega[img1use])) {
-	if (itrigger==0) {
-	  h->omes = omega[img1use];
-	  if (!isnan(omega_end[img1use])) {
-	    h->omee = omega_end[img1use];
-	  } else {
-	    h->omee = h->omes;
-	  }
-	}
-	omega_trigger_start[itrigger] = omega[img1use];
-	omega_trigger_end[itrigger]   = omega[img1use];
-	if (!isnan(omega_end[img1use])) {
-	  omega_trigger_end[itrigger] = omega_end[img1use];
-	}
-      }
-      if (!isnan(omega[img2use])) {
-	omega_trigger_start[itrigger2] = omega[img2use];
-	omega_trigger_end[itrigger2]   = omega[img2use];
-	if (!isnan(omega_end[img2use])) {
-	  omega_trigger_end[itrigger2] = omega_end[img2use];
-	}
-      }
-    }
-
-    if (itrigger==0) {
-      if (esgo==1) {
-	if (H5Lexists(fid,"/entry/sample",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/goniometer",H5P_DEFAULT)>0) {
-	    if (H5Lexists(fid,"/entry/sample/goniometer/kappa",H5P_DEFAULT)>0) {
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/kappa\n");
-	      kappa                   = hdf5_read_ndouble(fid,"/entry/sample/goniometer/kappa","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/kappa_end\n");
-	      kappa_end               = hdf5_read_ndouble(fid,"/entry/sample/goniometer/kappa_end","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/kappa_range_average\n");
-	      kappa_range_average     = hdf5_read_double (fid,"/entry/sample/goniometer/kappa_range_average","degree");
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/kappa_range_total\n");
-	      kappa_range_total       = hdf5_read_double (fid,"/entry/sample/goniometer/kappa_range_total","degree");
-	      ihave_kappa = 1;
-	    }
-	  }
-	}
-      }
-      
-      if (esgo==0 && ihave_kappa==0) {
-	if (iverb>2) printf(" ... check /entry/sample/sample_kappa/kappa\n");
-	if (H5Lexists(fid,"/entry/sample/sample_kappa",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/sample_kappa/kappa",H5P_DEFAULT)>0) {
-	    if (iverb>2) {
-	      int nd = hdf5_read_dataset_size(fid,"/entry/sample/sample_kappa/kappa");
-	      printf(" ... will read %d item(s) /entry/sample/sample_kappa/kappa\n",nd);
-	    }
-	    kappa = hdf5_read_ndouble(fid,"/entry/sample/sample_kappa/kappa","degree",&nimages);
-	    kappa_end = (double *) malloc((nimages * sizeof (double)));
-	    for (int id=0; id<nimages;id++ ) {
-	      kappa_end[id]=kappa[id];
-	    }
-	    kappa_range_average = 0.0;
-	    kappa_range_total = 0.0;
-	    ihave_kappa=1;
-	  }
-	}
-      }
-
-    }
-    if (ihave_kappa==1) {
-      if (!isnan(kappa[img1use])) {
-	if (itrigger==0) {
-	  h->kaps = kappa[img1use];
-	  if (!isnan(kappa_end[img1use])) {
-	    h->kape = kappa_end[img1use];
-	  } else {
-	    h->kape = h->kaps;
-	  }
-	}
-	kappa_trigger_start[itrigger] = kappa[img1use];
-	kappa_trigger_end[itrigger]   = kappa[img1use];
-	if (!isnan(kappa_end[img1use])) {
-	  kappa_trigger_end[itrigger] = kappa_end[img1use];
-	}
-
-	if (!isnan(kappa[img2use])) {
-	  kappa_trigger_start[itrigger2] = kappa[img2use];
-	  kappa_trigger_end[itrigger2]   = kappa[img2use];
-	  if (!isnan(kappa_end[img2use])) {
-	    kappa_trigger_end[itrigger2] = kappa_end[img2use];
-	  }
-	}
-      }
-    }
-
-    if (itrigger==0) {
-      if (esgo==1) {
-	if (H5Lexists(fid,"/entry/sample",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/goniometer",H5P_DEFAULT)>0) {
-	    if (H5Lexists(fid,"/entry/sample/goniometer/chi",H5P_DEFAULT)>0) {
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/chi\n");
-	      chi                     = hdf5_read_ndouble(fid,"/entry/sample/goniometer/chi","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/chi_end\n");
-	      chi_end                 = hdf5_read_ndouble(fid,"/entry/sample/goniometer/chi_end","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/chi_range_average\n");
-	      chi_range_average       = hdf5_read_double (fid,"/entry/sample/goniometer/chi_range_average","degree");
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/chi_range_total\n");
-	      chi_range_total         = hdf5_read_double (fid,"/entry/sample/goniometer/chi_range_total","degree");
-	      ihave_chi = 1;
-	    }
-	  }
-	}
-      }
-
-      if (esgo==0 && ihave_chi==0) {
-	if (iverb>2) printf(" ... check /entry/sample/sample_chi/chi\n");
-	if (H5Lexists(fid,"/entry/sample/sample_chi",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/sample_chi/chi",H5P_DEFAULT)>0) {
-	    if (iverb>2) {
-	      int nd = hdf5_read_dataset_size(fid,"/entry/sample/sample_chi/chi");
-	      printf(" ... will read %d item(s) /entry/sample/sample_chi/chi\n",nd);
-	    }
-	    chi = hdf5_read_ndouble(fid,"/entry/sample/sample_chi/chi","degree",&nimages);
-	    chi_end = (double *) malloc((nimages * sizeof (double)));
-	    for (int id=0; id<nimages;id++ ) {
-	      chi_end[id]=chi[id];
-	    }
-	    chi_range_average = 0.0;
-	    chi_range_total = 0.0;
-	    ihave_chi=1;
-	  }
-	}
-      }
-    }
-
-    if (ihave_chi==1) {
-      if (!isnan(chi[img1use])) {
-	if (itrigger==0) {
-	  h->chis = chi[img1use];
-	  if (!isnan(chi_end[img1use])) {
-	    h->chie = chi_end[img1use];
-	  } else {
-	    h->chie = h->chis;
-	  }
-	}
-	chi_trigger_start[itrigger] = chi[img1use];
-	chi_trigger_end[itrigger]   = chi[img1use];
-	if (!isnan(chi_end[img1use])) {
-	  chi_trigger_end[itrigger] = chi_end[img1use];
-	}
-
-	if (!isnan(chi[img2use])) {
-	  chi_trigger_start[itrigger2] = chi[img2use];
-	  chi_trigger_end[itrigger2]   = chi[img2use];
-	  if (!isnan(chi_end[img2use])) {
-	    chi_trigger_end[itrigger2] = chi_end[img2use];
-	  }
-	}
-      }
-    }
-
-    if (itrigger==0) {
-      if (esgo==1) {
-	if (H5Lexists(fid,"/entry/sample",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/goniometer",H5P_DEFAULT)>0) {
-	    if (H5Lexists(fid,"/entry/sample/goniometer/phi",H5P_DEFAULT)>0) {
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/phi\n");
-	      phi                     = hdf5_read_ndouble(fid,"/entry/sample/goniometer/phi","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/phi_end\n");
-	      phi_end                 = hdf5_read_ndouble(fid,"/entry/sample/goniometer/phi_end","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/phi_range_average\n");
-	      phi_range_average       = hdf5_read_double (fid,"/entry/sample/goniometer/phi_range_average","degree");
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/phi_range_total\n");
-	      phi_range_total         = hdf5_read_double (fid,"/entry/sample/goniometer/phi_range_total","degree");
-	      if (iverb>2)              printf(" ... will read /entry/sample/goniometer/phi_increment\n");
-	      phi_increment           = hdf5_read_double (fid,"/entry/sample/goniometer/phi_increment","degree");
-	      if (isnan(phi_increment)&&nimages>1) {
-		if (!isnan(phi[0])&&!isnan(phi[1])) {
-		  phi_increment = phi[1]-phi[0];
-		}
-	      }
-	      ihave_phi = 1;
-	    }
-	  }
-	}
-      }
-
-      if (esgo==0 && ihave_phi==0) {
-	if (iverb>2) printf(" ... check /entry/sample/sample_phi/phi\n");
-	if (H5Lexists(fid,"/entry/sample/sample_phi",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/sample_phi/phi",H5P_DEFAULT)>0) {
-	    int nd = hdf5_read_dataset_size(fid,"/entry/sample/sample_phi/phi");
-	    if (iverb>2) {
-	      printf(" ... will read %d item(s) /entry/sample/sample_phi/phi\n",nd);
-	    }
-	    phi = hdf5_read_ndouble(fid,"/entry/sample/sample_phi/phi","degree",&nimages);
-	    phi_end = (double *) malloc((nimages * sizeof (double)));
-	    if (nd==1) {
-	      for (int id=0; id<nimages;id++ ) {
-		phi_end[id]=phi[id];
-	      }
-	      phi_range_average = 0.0;
-	      phi_range_total = 0.0;
-	      phi_increment = 0.0;
-	    } else {
-	      phi_increment = phi[1]-phi[0];
-	      for (int id=0; id<nimages;id++ ) {
-		phi_end[id]=phi[id]+phi_increment;
-	      }
-	      phi_range_average = phi_increment;
-	      phi_range_total = nimages*phi_increment;
-	    }
-	    ihave_phi=1;
-	  }
-	}
-      }
-    }
-
-    if (ihave_phi==1) {
-      if (!isnan(phi[img1use])) {
-	if (itrigger==0) {
-	  h->phis = phi[img1use];
-	  if (!isnan(phi_end[img1use])) {
-	    h->phie = phi_end[img1use];
-	  } else {
-	    h->phie = h->phis;
-	  }
-	}
-	phi_trigger_start[itrigger] = phi[img1use];
-	phi_trigger_end[itrigger]   = phi[img1use];
-	if (!isnan(phi_end[img1use])) {
-	  phi_trigger_end[itrigger] = phi_end[img1use];
-	}
-
-	if (!isnan(phi[img2use])) {
-	  phi_trigger_start[itrigger2] = phi[img2use];
-	  phi_trigger_end[itrigger2]   = phi[img2use];
-	  if (!isnan(phi_end[img2use])) {
-	    phi_trigger_end[itrigger2] = phi_end[img2use];
-	  }
-	}
-      }
-    }
-
-    if (itrigger==0) {
-      if (esgo==1) {
-	if (H5Lexists(fid,"/entry/sample",H5P_DEFAULT)>0) {
-	  if (H5Lexists(fid,"/entry/sample/goniometer",H5P_DEFAULT)>0) {
-	    if (H5Lexists(fid,"/entry/sample/goniometer/two_theta",H5P_DEFAULT)>0) {
-	      if (iverb>2)              printf(" ... will read /entry/instrument/detector/goniometer/two_theta\n");
-	      two_theta               = hdf5_read_ndouble(fid,"/entry/instrument/detector/goniometer/two_theta","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/instrument/detector/goniometer/two_theta_end\n");
-	      two_theta_end           = hdf5_read_ndouble(fid,"/entry/instrument/detector/goniometer/two_theta_end","degree",&nimages);
-	      if (iverb>2)              printf(" ... will read /entry/instrument/detector/goniometer/two_theta_range_average\n");
-	      two_theta_range_average = hdf5_read_double (fid,"/entry/instrument/detector/goniometer/two_theta_range_average","degree");
-	      if (iverb>2)              printf(" ... will read /entry/instrument/detector/goniometer/two_theta_range_total\n");
-	      two_theta_range_total   = hdf5_read_double (fid,"/entry/instrument/detector/goniometer/two_theta_range_total","degree");
-	      ihave_two_theta = 1;
-	    }
-	  }
-	}
-      }
-    }
-    if (ihave_two_theta==1) {
-      if (!isnan(two_theta[img1use])) {
-	if (itrigger==0) {
-	  h->twot = two_theta[img1use];
-	}
-	two_theta_trigger_start[itrigger] = two_theta[img1use];
-	two_theta_trigger_end[itrigger]   = two_theta[img1use];
-	if (!isnan(two_theta_end[img1use])) {
-	  two_theta_trigger_end[itrigger] = two_theta_end[img1use];
-	}
-
-	if (!isnan(two_theta[img2use])) {
-	  two_theta_trigger_start[itrigger2] = two_theta[img2use];
-	  two_theta_trigger_end[itrigger2]   = two_theta[img2use];
-	  if (!isnan(two_theta_end[img2use])) {
-	    two_theta_trigger_end[itrigger2] = two_theta_end[img2use];
-	  }
-	}
-      }
-    }
-
-    if (!isnan(omega_increment)) {
-      if (omega_increment>0.0) {
-	if (isnan(phi_increment)||phi_increment==0.0) {
-	  printf(" rotation axis = \"OMEGA\"\n");
-	}
-	else if (phi_increment>0.0) {
-	  printf("\n WARNING: it seems both OMEGA and PHI increments are set to non-zero values: %f %f ?\n",omega_increment,phi_increment);
-	}
-      }
-      else if (phi_increment>0.0) {
-	printf(" rotation axis = \"PHI\"\n");
-      }
-    }
-
-    // check if this sweep is a continuation (in terms of angles) of previous one
-    if (itrigger_prev>=0) {
-      double d_omega     = 0.0;
-      if (ihave_omega)     d_omega     =     omega_trigger_start[itrigger] -     omega_trigger_end[itrigger_prev];
-      double d_kappa     = 0.0;
-      if (ihave_kappa)     d_kappa     =     kappa_trigger_start[itrigger] -     kappa_trigger_end[itrigger_prev];
-      double d_phi       = 0.0;
-      if (ihave_phi)       d_phi       =       phi_trigger_start[itrigger] -       phi_trigger_end[itrigger_prev];
-      double d_chi       = 0.0;
-      if (ihave_chi)       d_chi       =       chi_trigger_start[itrigger] -       chi_trigger_end[itrigger_prev];
-      double d_two_theta = 0.0;
-      if (ihave_two_theta) d_two_theta = two_theta_trigger_start[itrigger] - two_theta_trigger_end[itrigger_prev];
-
-      if (sqrt(d_omega*d_omega)<0.001&&sqrt(d_kappa*d_kappa)<0.001&&sqrt(d_chi*d_chi)<0.001&&sqrt(d_phi*d_phi)<0.001&&sqrt(d_two_theta*d_two_theta)<0.001) {
-	printf(" Sweep-%-4d : continuation from previous\n",(itrigger+1));
-      } else {
-	printf("\n Sweep-%-4d : independent sweep\n",(itrigger+1));
-	ndatasets++;
-      }
-    } else {
-      if ((img+1)<(img2+1)) {
-	printf("\n Sweep-%-4d :\n",(itrigger+1));
-      }
-      ndatasets++;
-    }
-
-    if ((img+1)<(img2+1)) {
-      int imgnum_1 = (img +1);
-      int imgnum_2 = (img2+1);
-      if (h5check>0) {
-	img_offset = nimage_to_imgnum[img1use] - imgnum_1;
-	imgnum_1 = nimage_to_imgnum[img1use];
-	imgnum_2 = nimage_to_imgnum[img2use];
-      }
-      printf("   from image %6d : Omega= %8.3f .. %8.3f  Kappa= %8.3f .. %8.3f  Chi= %8.3f .. %8.3f  Phi= %8.3f .. %8.3f  2-Theta= %8.3f .. %8.3f\n",imgnum_1,omega_trigger_start[itrigger],omega_trigger_end[itrigger],kappa_trigger_start[itrigger],kappa_trigger_end[itrigger],chi_trigger_start[itrigger],chi_trigger_end[itrigger],phi_trigger_start[itrigger],phi_trigger_end[itrigger],two_theta_trigger_start[itrigger],two_theta_trigger_end[itrigger]);
-      printf("   to   image %6d : Omega= %8.3f .. %8.3f  Kappa= %8.3f .. %8.3f  Chi= %8.3f .. %8.3f  Phi= %8.3f .. %8.3f  2-Theta= %8.3f .. %8.3f\n",imgnum_2,omega_trigger_start[itrigger2],omega_trigger_end[itrigger2],kappa_trigger_start[itrigger2],kappa_trigger_end[itrigger2],chi_trigger_start[itrigger2],chi_trigger_end[itrigger2],phi_trigger_start[itrigger2],phi_trigger_end[itrigger2],two_theta_trigger_start[itrigger2],two_theta_trigger_end[itrigger2]);
-    }
+// wall[0..2] and cpu[0..2]: start, after the command line, end
+void print_run_timings(const double* wall, const double* cpu)
+{
+  printf("\n ===== Timings (all files):\n");
+  printf(" phase                      wall [ms]    cpu [ms]\n");
+  printf(" %-22s %12.3f %11.3f\n","command line",1000.0*(wall[1]-wall[0]),1000.0*(cpu[1]-cpu[0]));
+  printf(" %-22s %12.3f %11.3f\n","files",1000.0*(wall[2]-wall[1]),1000.0*(cpu[2]-cpu[1]));
+  printf(" %-22s %12.3f %11.3f\n","total",1000.0*(wall[2]-wall[0]),1000.0*(cpu[2]-cpu[0]));
+  printf(" peak RSS                      [MB] = %.1f\n",peak_rss_kb()/1024.0);
+}
 
-    itrigger_prev = itrigger2;
-    img  = img  + nimages_per_trigger;
-    img2 = img2 + nimages_per_trigger;
+// CPU time of this process and its (finished) worker processes
+double run_cpu(void)
+{
+  double cpu = 0.0;
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru)==0) {
+    cpu += ru.ru_utime.tv_sec + 1e-6*ru.ru_utime.tv_usec + ru.ru_stime.tv_sec + 1e-6*ru.ru_stime.tv_usec;
   }
-
-  if (ntrigger>1) {
-    if (ndatasets==ntrigger) {
-      printf("\n Note: it seems that we have %d independent datasets consisting of %d images each.\n",ndatasets,nimages_per_trigger);
-    }
-    else if (ndatasets==1) {
-      printf("\n Note: it seems that we have %d dataset consisting of %d images.\n",ndatasets,nimages);
-    }
-    else if (ndatasets>ntrigger) {
-      printf("\n WARNING: there seems to be more datasets (%d) defined than we have triggers (%d) - how is that possible?\n",ndatasets,ntrigger);
-    }
-    else {
-      printf("\n WARNING: there seems to be fewer datasets (%d) defined than we have triggers (%d) - a mixture of related and independent sweeps?\n",ndatasets,ntrigger);
-    }
-    printf("\n");
+  if (getrusage(RUSAGE_CHILDREN, &ru)==0) {
+    cpu += ru.ru_utime.tv_sec + 1e-6*ru.ru_utime.tv_usec + ru.ru_stime.tv_sec + 1e-6*ru.ru_stime.tv_usec;
   }
+  return cpu;
+}
 
-  int is_standard_eiger=0;
-  if (esgo==1) {
-    if (eiger_fw_version!=NULL) {
-      if (eiger_fw_version[0]!='\0') {
-	is_standard_eiger = 1;
-      }
-    }
+long peak_rss_kb(void)
+{
+  long rss = 0;
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru)==0) rss = ru.ru_maxrss;
+  if (getrusage(RUSAGE_CHILDREN, &ru)==0 && ru.ru_maxrss>rss) rss = ru.ru_maxrss;
+  return rss;
+}
+
+// ==================================================================================================
+// per-image table (-per-image and -per-image-raw)
+//   instead of the report: one line per image with image number (as
+//   named in the data files), trigger and start/end of omega, kappa, chi,
+//   phi and 2-theta - or the same as raw imginfo_image records. Rows come
+//   from imginfo_read in blocks and are written as they arrive, numbers
+//   are converted by format_fixed. Anything reported while reading a
+//   file that couldn't be handled goes to stderr.
+// ==================================================================================================
+// v with ndec (at most 9) decimals, right-aligned in width characters -
+// same as "%*.*f" (up to rounding of exact ties) but without the cost of
+// printf for tables with millions of numbers
+char* format_fixed(char* p, double v, int width, int ndec)
+{
+  static const double scale[] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9};
+  char tmp[32];
+  char *t = tmp + sizeof(tmp);
+  if (isnan(v)) {
+    *--t = 'n'; *--t = 'a'; *--t = 'n';
   }
-  if (is_standard_eiger==1) {
-    if (iverb>0) printf("\n Seems to be standard Eiger/HDF5 file\n\n");
+  else if (fabs(v)>=1e9 || ndec<0 || ndec>9) {
+    return p + sprintf(p, "%*.*f", width, ndec, v);
   }
   else {
-    if (iverb>0) printf("\n Seems to be non-standard Eiger/HDF5 file\n\n");
-  }
+    int neg = ( v<0.0 );
+    unsigned long long n = (unsigned long long) (fabs(v)*scale[ndec] + 0.5);
+    for (int idec = 0; idec < ndec; idec++) {
+      *--t = '0' + n%10;
+      n /= 10;
+    }
+    if (ndec>0) *--t = '.';
+    do {
+      *--t = '0' + n%10;
+      n /= 10;
+    } while (n>0);
+    if (neg) *--t = '-';
+  }
+  int len = tmp + sizeof(tmp) - t;
+  while (len<width) {
+    *p++ = ' ';
+    width--;
+  }
+  memcpy(p, t, len);
+  return p + len;
+}
 
+int image_table_rows(const imginfo_image* rows, int nrows, void* arg)
+{
+  image_table *tab = (image_table *) arg;
+  if (tab->raw) {
+    return (fwrite(rows, sizeof(imginfo_image), nrows, stdout)==(size_t) nrows) ? 0 : 1;
+  }
+  char line[CHAR_ARRAY_LEN*2];
+  tab->buf.clear();
+  for (int irow = 0; irow < nrows; irow++) {
+    const imginfo_image *r = &rows[irow];
+    const double *v[] = { r->omeg, r->kapp, r->chi, r->phi, r->twot };
+    char *p = line + sprintf(line, "%8d %4d", r->imgn, r->trig);
+    for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+      *p++ = ' ';
+      p = format_fixed(p, v[iaxis][0], 10, 4);
+      *p++ = ' ';
+      p = format_fixed(p, v[iaxis][1], 10, 4);
+    }
+    *p++ = '\n';
+    tab->buf.append(line, p-line);
+  }
+  return (fwrite(tab->buf.data(), 1, tab->buf.size(), stdout)==tab->buf.size()) ? 0 : 1;
+}
 
-  if (h5check>0) {
-    img_offset = nimage_to_imgnum[img1use] - (img1use + 1 );
-    printf("     Image number %d/%d\n\n",nimage_to_imgnum[img1use],nimage_to_imgnum[(nimages-1)]);
-  } else {
-    printf("     Image number %d/%d\n\n",(img1use+1),nimages);
-  }
+int process_file_images(const imginfo_job* job, imginfo_file* file)
+{
+  imginfo_result res;
+  image_tab.raw = ( job->output==OUTPUT_IMAGES_RAW );
+  image_tab.buf.reserve(IMGINFO_IMAGE_BLOCK*CHAR_ARRAY_LEN);
 
-  if (img_offset>0) {
-    printf("     Offset between image number name and image number position = %d\n\n",img_offset);
+  if (!image_tab.raw) {
+    printf("# file = %s\n",job->path.c_str());
+    printf("#  image trig omega_start  omega_end kappa_start  kappa_end  chi_start    chi_end  phi_start    phi_end   2th_start    2th_end\n");
   }
 
-  // get axis definitions
-  if (H5Lexists(fid,"/entry/sample",H5P_DEFAULT)>0) {
-    if (H5Lexists(fid,"/entry/sample/transformations",H5P_DEFAULT)>0) {
-      char omega_str[CHAR_ARRAY_LEN] = "";
-      if (H5Lexists(fid,"/entry/sample/transformations/omega",H5P_DEFAULT)>0) {
-        strcpy(omega_str,"/entry/sample/transformations/omega");
-      }
-      else if (H5Lexists(fid,"/entry/sample/transformations/gonomega",H5P_DEFAULT)>0) {
-        strcpy(omega_str,"/entry/sample/transformations/gonomega");
-      }
-      if (omega_str[0]!=0) {
-	omega_axis     = hdf5_read_axis_vector(fid,omega_str);
-        if (!isnan(omega_axis[0])&&!isnan(omega_axis[1])&&!isnan(omega_axis[2])) {
-          if (iverb>1) printf(" omega axis   = %8.5f %8.5f %8.5f\n",omega_axis[0],omega_axis[1],omega_axis[2]);
-        }
-      }
+  imginfo_file* own = ( file==NULL ) ? (file = open_job_file(job)) : NULL;
+  int status = imginfo_read_image(file, job->imgnum, &res);
+  imginfo_close(own);
+  fflush(stdout);
 
-      if (H5Lexists(fid,"/entry/sample/transformations/kappa",H5P_DEFAULT)>0) {
-	kappa_axis     = hdf5_read_axis_vector(fid,"/entry/sample/transformations/kappa");
-	if (!isnan(kappa_axis[0])&&!isnan(kappa_axis[1])&&!isnan(kappa_axis[2])) {
-	  if (iverb>1) printf(" kappa axis   = %8.5f %8.5f %8.5f\n",kappa_axis[0],kappa_axis[1],kappa_axis[2]);
-	}
-      }
-      if (H5Lexists(fid,"/entry/sample/transformations/chi",H5P_DEFAULT)>0) {
-	chi_axis       = hdf5_read_axis_vector(fid,"/entry/sample/transformations/chi");
-	if (!isnan(chi_axis[0])&&!isnan(chi_axis[1])&&!isnan(chi_axis[2])) {
-	  if (iverb>1) printf(" chi axis     = %8.5f %8.5f %8.5f\n",chi_axis[0],chi_axis[1],chi_axis[2]);
-	}
-      }
-      if (H5Lexists(fid,"/entry/sample/transformations/phi",H5P_DEFAULT)>0) {
-	phi_axis       = hdf5_read_axis_vector(fid,"/entry/sample/transformations/phi");
-	if (!isnan(phi_axis[0])&&!isnan(phi_axis[1])&&!isnan(phi_axis[2])) {
-	  if (iverb>1) printf(" phi axis     = %8.5f %8.5f %8.5f\n",phi_axis[0],phi_axis[1],phi_axis[2]);
-	}
-      }
-      if (H5Lexists(fid,"/entry/sample/transformations/two_theta",H5P_DEFAULT)>0) {
-	two_theta_axis = hdf5_read_axis_vector(fid,"/entry/sample/transformations/two_theta");
-	if (!isnan(two_theta_axis[0])&&!isnan(two_theta_axis[1])&&!isnan(two_theta_axis[2])) {
-	  if (iverb>1) printf(" 2-theta axis = %8.5f %8.5f %8.5f\n",two_theta_axis[0],two_theta_axis[1],two_theta_axis[2]);
-	}
-      }
-    }
+  if (status!=IMGINFO_OK) {
+    fprintf(stderr, "\n ################# File = %s\n%s", job->path.c_str(), res.report.c_str());
   }
-
-  if (H5Lexists(fid,"/entry/instrument",H5P_DEFAULT)>0) {
-    if (H5Lexists(fid,"/entry/instrument/detector",H5P_DEFAULT)>0) {
-      if (H5Lexists(fid,"/entry/instrument/detector/detector_distance",H5P_DEFAULT)>0) {
-	detector_distance_vector =  hdf5_read_axis_vector(fid,"/entry/instrument/detector/detector_distance");
-	if (!isnan(detector_distance_vector[0])&&!isnan(detector_distance_vector[1])&&!isnan(detector_distance_vector[2])) {
-	  if (iverb>1) printf(" detector distance vector = %8.5f %8.5f %8.5f\n",detector_distance_vector[0],detector_distance_vector[1],detector_distance_vector[2]);
-	}
-      }
-      if (H5Lexists(fid,"/entry/instrument/detector/module",H5P_DEFAULT)>0) {
-	if (H5Lexists(fid,"/entry/instrument/detector/module/fast_pixel_direction",H5P_DEFAULT)>0) {
-	  fast_pixel_vector =  hdf5_read_axis_vector(fid,"/entry/instrument/detector/module/fast_pixel_direction");
-	  if (!isnan(fast_pixel_vector[0])&&!isnan(fast_pixel_vector[1])&&!isnan(fast_pixel_vector[2])) {
-	    if (iverb>1) printf(" fast pixel vector = %8.5f %8.5f %8.5f\n",fast_pixel_vector[0],fast_pixel_vector[1],fast_pixel_vector[2]);
-	  }
-	}
-	if (H5Lexists(fid,"/entry/instrument/detector/module/slow_pixel_direction",H5P_DEFAULT)>0) {
-	  slow_pixel_vector =  hdf5_read_axis_vector(fid,"/entry/instrument/detector/module/slow_pixel_direction");
-	  if (!isnan(slow_pixel_vector[0])&&!isnan(slow_pixel_vector[1])&&!isnan(slow_pixel_vector[2])) {
-	    if (iverb>1) printf(" slow pixel vector = %8.5f %8.5f %8.5f\n",slow_pixel_vector[0],slow_pixel_vector[1],slow_pixel_vector[2]);
-	  }
-	}
-      }
-    }
+  switch (status) {
+  case IMGINFO_FATAL:
+    exit(EXIT_FAILURE);
+  case IMGINFO_UNREADABLE:
+    return 0;
+  case IMGINFO_NO_HEADER:
+    fprintf(stderr, "\n\nError reading file header\n");
+    return -1;
   }
+  return 1;
+}
 
-  if (iverb>2)  printf(" ... will read /entry/instrument/beam/incident_wavelength\n");
-  double wave  = hdf5_read_double(fid,"/entry/instrument/beam/incident_wavelength","angstrom");
-  if (!isnan(wave)) h->wave = (float) wave;
+// ==================================================================================================
+// process_file_frames: read (and decompress) the image data of a file
+//   (-frames) and report the rate achieved. With -verify the external
+//   files are checked first (-h5check) and every frame is decoded, the
+//   first one that can't be is reported (and makes this fail).
+// ==================================================================================================
+int process_file_frames(const imginfo_job* job, imginfo_file* file)
+{
+  imginfo_result res;
+  imginfo_frame_stats st;
+  printf("\n\n ################# File = %s\n\n",job->path.c_str());
 
-  if (iverb>2)  printf(" ... will read /entry/instrument/detector/beam_center_x\n");
-  double beamx = hdf5_read_double(fid,"/entry/instrument/detector/beam_center_x","pixel");
-  if (isnan(beamx)) {
-    beamx = hdf5_read_double(fid,"/entry/instrument/detector/beam_centre_x","pixel");
-  }
-  if (isnan(beamx)) {
-    beamx = hdf5_read_double(fid,"/entry/instrument/detector/beam_center_x","pixels");
-  }
-  if (isnan(beamx)) {
-    beamx = hdf5_read_double(fid,"/entry/instrument/detector/beam_centre_x","pixels");
+  imginfo_file* own = ( file==NULL ) ? (file = open_job_file(job)) : NULL;
+  int status = IMGINFO_OK;
+  if (job->verify) {
+    status = imginfo_read_image(file, job->imgnum, &res);
+    fwrite(res.report.data(), 1, res.report.size(), stdout);
   }
-  if (iverb>2)  printf(" ... will read /entry/instrument/detector/beam_center_y\n");
-  double beamy = hdf5_read_double(fid,"/entry/instrument/detector/beam_center_y","pixel");
-  if (isnan(beamy)) {
-    beamy = hdf5_read_double(fid,"/entry/instrument/detector/beam_centre_y","pixel");
+  if (status==IMGINFO_OK) {
+    status = imginfo_read_frames(file, job->imgnum, job->imglast, job->frame_threads, NULL, NULL, &st, &res);
+    fwrite(res.report.data(), 1, res.report.size(), stdout);
   }
-  if (isnan(beamy)) {
-    beamy = hdf5_read_double(fid,"/entry/instrument/detector/beam_center_y","pixels");
+  imginfo_close(own);
+
+  switch (status) {
+  case IMGINFO_FATAL:
+    fflush(stdout);
+    exit(EXIT_FAILURE);
+  case IMGINFO_UNREADABLE:
+    return 0;
+  case IMGINFO_NO_HEADER:
+    printf("\n\nError reading %s\n",job->verify ? "file header" : "frames");
+    return -1;
+  }
+
+  double seconds = ( st.seconds>0.0 ) ? st.seconds : 1.0e-9;
+  printf("\n ===== %s:\n",job->verify ? "Verification" : "Frames");
+  printf(" frames read                         = %ld (%ld as raw chunks)\n",st.nframes,st.ndirect);
+  if (job->verify) {
+    printf(" bad frames                          = %ld\n",st.nbad);
+    if (st.nbad>0) {
+      printf(" first bad frame                     = image %d in %s\n",st.bad_imgn,st.bad_file.c_str());
+      printf("                                       (%s)\n",st.bad_error.c_str());
+    }
+  }
+  printf(" decode threads                      = %d\n",st.nthreads);
+  printf(" read (compressed)              [GB] = %.3f\n",st.nraw/1.0e9);
+  printf(" decompressed                   [GB] = %.3f\n",st.nbytes/1.0e9);
+  printf(" time                      [seconds] = %.3f\n",st.seconds);
+  printf(" frames per second                   = %.1f\n",st.nframes/seconds);
+  printf(" decompressed data            [GB/s] = %.3f\n",st.nbytes/1.0e9/seconds);
+  printf(" read from file               [GB/s] = %.3f\n",st.nraw/1.0e9/seconds);
+  printf("\n");
+  fflush(stdout);
+  if (job->verify && st.nbad>0) {
+    printf("\nError - file failed verification\n");
+    return -1;
   }
-  if (isnan(beamy)) {
-    beamy = hdf5_read_double(fid,"/entry/instrument/detector/beam_centre_y","pixels");
+  return 1;
+}
+
+// ==================================================================================================
+// manifests (-manifest, -manifest-check)
+//   a master file and all data files it links to (as found by -h5check)
+//   are hashed in parallel and listed one line per file and hash in the
+//   BSD style of "sha256sum --tag" - i.e. "XXH64 (<file>) = <hex>" - so
+//   that the manifest can also be checked with sha256sum -c or xxhsum -c.
+//   File names are as given (master) or found next to it (data files).
+// ==================================================================================================
+int process_file_manifest(const imginfo_job* job, imginfo_file* file)
+{
+  imginfo_result res;
+  printf("\n\n ################# File = %s\n\n",job->path.c_str());
+
+  imginfo_file* own = ( file==NULL ) ? (file = open_job_file(job)) : NULL;
+  int status = imginfo_read_image(file, job->imgnum, &res);
+  imginfo_close(own);
+  fwrite(res.report.data(), 1, res.report.size(), stdout);
+
+  switch (status) {
+  case IMGINFO_FATAL:
+    fflush(stdout);
+    exit(EXIT_FAILURE);
+  case IMGINFO_UNREADABLE:
+    return 0;
+  case IMGINFO_NO_HEADER:
+    printf("\n\nError reading file header\n");
+    return -1;
+  }
+
+  vector<imginfo_hash> files(1 + res.h.extf.size());
+  files[0].path = job->path;
+  for (size_t ifile = 0; ifile < res.h.extf.size(); ifile++) files[ifile+1].path = res.h.extf[ifile];
+  double seconds;
+  int nfailed = imginfo_hash_files(&files, job->hashes, sysconf(_SC_NPROCESSORS_ONLN), &seconds);
+
+  string text;
+  double nbytes = 0.0;
+  for (size_t ifile = 0; ifile < files.size(); ifile++) {
+    const imginfo_hash& f = files[ifile];
+    if (f.status!=0) {
+      printf("\n ERROR - unable to read %s (%s)!\n",f.path.c_str(),strerror(f.status));
+      continue;
+    }
+    if (job->hashes & IMGINFO_HASH_XXH64)  text += "XXH64 ("  + f.path + ") = " + f.xxh64  + "\n";
+    if (job->hashes & IMGINFO_HASH_SHA256) text += "SHA256 (" + f.path + ") = " + f.sha256 + "\n";
+    nbytes += f.size;
+  }
+
+  if (seconds<=0.0) seconds = 1.0e-9;
+  printf("\n ===== Manifest:\n");
+  printf(" files hashed                        = %d\n",(int) files.size() - nfailed);
+  printf(" hashed                         [GB] = %.3f\n",nbytes/1.0e9);
+  printf(" time                      [seconds] = %.3f\n",seconds);
+  printf(" hashed data                  [GB/s] = %.3f\n",nbytes/1.0e9/seconds);
+  printf("\n");
+  fflush(stdout);
+
+  // an incomplete list of files is no use: nothing written then
+  if (nfailed>0) {
+    printf("\nError - no manifest entries written for %s\n",job->path.c_str());
+    return -1;
   }
-  if (!isnan(beamx)&&!isnan(beamy)) {
-    h->beax = (float) beamx;
-    h->beay = (float) beamy;
+  // one write, so entries from several worker processes don't mix
+  int fd = open(job->manifest.c_str(), O_WRONLY|O_APPEND|O_CREAT, 0666);
+  if (fd<0 || write_all(fd, text.data(), text.size())<0) {
+    printf("\n ERROR: unable to write manifest \"%s\" (%s)!\n\n",job->manifest.c_str(),strerror(errno));
+    if (fd>=0) close(fd);
+    return -1;
   }
+  close(fd);
+  return 1;
+}
 
-  if (iverb>2)  printf(" ... will read /entry/instrument/detector/detector_distance\n");
-  double dist  = hdf5_read_double(fid,"/entry/instrument/detector/detector_distance","m");
-  if (isnan(dist)) {
-    if (iverb>2)  printf(" ... will read /entry/instrument/detector_distance\n");
-    dist  = hdf5_read_double(fid,"/entry/instrument/detector_distance","m");
-    if (isnan(dist)) {
-      if (iverb>2)  printf(" ... will read /entry/instrument/detector/distance\n");
-      dist  = hdf5_read_double(fid,"/entry/instrument/detector/distance","m");
+// hash all files listed in a manifest again, reporting each one as
+// "<file>: OK" (or FAILED) - returns the exit status
+int check_manifest(const string& manifest)
+{
+  FILE *fp = fopen(manifest.c_str(), "r");
+  if (fp==NULL) {
+    printf("\n ERROR: unable to open manifest \"%s\" (%s)!\n\n",manifest.c_str(),strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  // files in the order they first appear, with the hashes given for them
+  vector<imginfo_hash> files;
+  vector<imginfo_hash> want;
+  map<string,size_t> index;
+  int which = 0;
+  int nbad_lines = 0;
+  char line[PATH_MAX+CHAR_ARRAY_LEN];
+  while (fgets(line, sizeof(line), fp)!=NULL) {
+    string l = line;
+    while (!l.empty() && (l[l.size()-1]=='\n' || l[l.size()-1]=='\r')) l.erase(l.size()-1);
+    if (l.empty() || l[0]=='#') continue;
+    size_t open_paren = l.find(" (");
+    size_t close_paren = l.rfind(") = ");
+    if (open_paren==string::npos || close_paren==string::npos || close_paren<open_paren) {
+      nbad_lines++;
+      continue;
+    }
+    string alg  = l.substr(0, open_paren);
+    string path = l.substr(open_paren+2, close_paren-open_paren-2);
+    string hex  = l.substr(close_paren+4);
+    int h = ( alg=="XXH64" ) ? IMGINFO_HASH_XXH64 : ( alg=="SHA256" ) ? IMGINFO_HASH_SHA256 : 0;
+    if (h==0) {
+      nbad_lines++;
+      continue;
+    }
+    if (index.find(path)==index.end()) {
+      index[path] = files.size();
+      imginfo_hash f;
+      f.path = path;
+      files.push_back(f);
+      want.push_back(f);
+    }
+    if (h==IMGINFO_HASH_XXH64) want[index[path]].xxh64 = hex;
+    else                       want[index[path]].sha256 = hex;
+    which |= h;
+  }
+  fclose(fp);
+
+  double seconds;
+  imginfo_hash_files(&files, which, sysconf(_SC_NPROCESSORS_ONLN), &seconds);
+
+  int nfailed = 0;
+  double nbytes = 0.0;
+  for (size_t ifile = 0; ifile < files.size(); ifile++) {
+    const imginfo_hash& f = files[ifile];
+    const imginfo_hash& w = want[ifile];
+    nbytes += f.size;
+    if (f.status!=0) {
+      printf("%s: FAILED open or read (%s)\n",f.path.c_str(),strerror(f.status));
+      nfailed++;
+    } else if ((!w.xxh64.empty() && w.xxh64!=f.xxh64) || (!w.sha256.empty() && w.sha256!=f.sha256)) {
+      printf("%s: FAILED\n",f.path.c_str());
+      nfailed++;
+    } else {
+      printf("%s: OK\n",f.path.c_str());
     }
   }
-  if (!isnan(dist)) h->dist = (float) dist*1000.0;
 
-  if (iverb>2)         printf(" ... will read /entry/instrument/detector/count_time\n");
-  double count_time   = hdf5_read_double(fid,"/entry/instrument/detector/count_time","s");
-  if (iverb>2)         printf(" ... will read /entry/instrument/detector/frame_time\n");
-  double frame_time   = hdf5_read_double(fid,"/entry/instrument/detector/frame_time","s");
-  if (isnan(frame_time)) {
-    if (iverb>2)         printf(" ... will read /entry/instrument/detector/count_time\n");
-    double count_time   = hdf5_read_double(fid,"/entry/instrument/detector/count_time","s");
-    h->etime = count_time;
-  } else {
-    h->etime = frame_time;
+  if (seconds<=0.0) seconds = 1.0e-9;
+  printf("\n ===== Manifest check:\n");
+  printf(" files checked                       = %d\n",(int) files.size());
+  printf(" failed                              = %d\n",nfailed);
+  if (nbad_lines>0) {
+    printf(" lines not understood                = %d\n",nbad_lines);
   }
-  if (iverb>2)         printf(" ... will read /entry/instrument/detector/detector_readout_time\n");
-  double readout_time = hdf5_read_double(fid,"/entry/instrument/detector/detector_readout_time","s");
+  printf(" hashed                         [GB] = %.3f\n",nbytes/1.0e9);
+  printf(" hashed data                  [GB/s] = %.3f\n",nbytes/1.0e9/seconds);
+  printf("\n");
+  return ( nfailed==0 && nbad_lines==0 && files.size()>0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-  int nx = INIT_INT;
-  int ny = INIT_INT;
-  if (H5Lexists(fid,"/entry/instrument/detector/detectorSpecific/x_pixels_in_detector",H5P_DEFAULT)>0) {
-    if (iverb>2) printf(" ... will read /entry/instrument/detector/detectorSpecific/x_pixels_in_detector\n");
-    nx   = hdf5_read_int   (fid,"/entry/instrument/detector/detectorSpecific/x_pixels_in_detector");
-    if (iverb>2) printf(" ... will read /entry/instrument/detector/detectorSpecific/y_pixels_in_detector\n");
-    ny   = hdf5_read_int   (fid,"/entry/instrument/detector/detectorSpecific/y_pixels_in_detector");
-  }
-  else if (H5Lexists(fid,"/entry/instrument/detector/detectorSpecific/x_pixels",H5P_DEFAULT)>0) {
-    if (iverb>2) printf(" ... will read /entry/instrument/detector/detectorSpecific/x_pixels\n");
-    nx   = hdf5_read_int   (fid,"/entry/instrument/detector/detectorSpecific/x_pixels");
-    if (iverb>2) printf(" ... will read /entry/instrument/detector/detectorSpecific/y_pixels\n");
-    ny   = hdf5_read_int   (fid,"/entry/instrument/detector/detectorSpecific/y_pixels");
+// exit status of a worker process handling one file
+#define TASK_FILE_DONE    0
+#define TASK_FILE_FAILED  1
+#define TASK_FILE_SKIPPED 2
+
+// one task per run of consecutive jobs for the same file
+void file_tasks_group(file_tasks* tasks, vector<imginfo_job>* jobs)
+{
+  tasks->jobs = jobs;
+  tasks->nfil = 0;
+  tasks->first.clear();
+  for (size_t ijob = 0; ijob < jobs->size(); ijob++) {
+    if (ijob==0 || !same_file(&(*jobs)[ijob-1], &(*jobs)[ijob])) tasks->first.push_back(ijob);
   }
-  else {
-    int n_nxny = 2;
-    int *nxny = hdf5_read_nint(fid,"/entry/instrument/detector/module/data_size",&n_nxny);
-    if (nxny[0]!=INIT_INT) {
-      // according to https://manual.nexusformat.org/classes/applications/NXmx.html
-      //   ... order of indices is the same as for data_origin.
-      //   The order of indices (i, j or i, j, k) is slow to fast.
-      // see also: https://manual.nexusformat.org/datarules.html#design-arraystorageorder
-      nx = nxny[1];
-      ny = nxny[0];
+  tasks->first.push_back(jobs->size());
+}
+
+// hands back the number of jobs done
+int process_file_task(int itask, int fd_result, void* arg)
+{
+  file_tasks *tasks = (file_tasks *) arg;
+  imginfo_file* file = open_job_file(&(*tasks->jobs)[tasks->first[itask]]);
+  int ndone = 0;
+  for (size_t ijob = tasks->first[itask]; ijob < tasks->first[itask+1]; ijob++) {
+    int file_success = process_file(&(*tasks->jobs)[ijob], file);
+    if (file_success<0) return TASK_FILE_FAILED;
+    ndone += file_success;
+  }
+  imginfo_close(file);
+  write_all(fd_result, (const char*) &ndone, sizeof(ndone));
+  if (ndone==0) return TASK_FILE_SKIPPED;
+  return TASK_FILE_DONE;
+}
+
+int report_file_task(int itask, int status, const string& output, const string& result, void* arg)
+{
+  file_tasks *tasks = (file_tasks *) arg;
+  fwrite(output.data(), 1, output.size(), stdout);
+  fflush(stdout);
+  if (WIFEXITED(status)) {
+    if (WEXITSTATUS(status)==TASK_FILE_DONE) {
+      int ndone = 1;
+      if (result.size()==sizeof(ndone)) memcpy(&ndone, result.data(), sizeof(ndone));
+      tasks->nfil += ndone;
+      return 0;
+    }
+    if (WEXITSTATUS(status)==TASK_FILE_SKIPPED) {
+      return 0;
     }
+  } else {
+    printf("\n\n ERROR - worker process terminated abnormally!\n\n");
+  }
+  return 1;
+}
+
+// ==================================================================================================
+// header cache (-cache <file> or IMGINFO_CACHE)
+//   everything get_header produces for a file - the filled image_header
+//   and the text reported while reading it (including any -h5check
+//   results) - is kept in a memory-mapped file that all imginfo
+//   processes share. An entry is keyed on device, inode, size and mtime
+//   of the master file (plus the path as given and the options that
+//   change the report). The same stamps are stored for every external
+//   (data) file looked at during -h5check and compared on every hit, so
+//   changing the master or any data file invalidates the entry.
+//
+//   The file is a small header followed by CACHE_NSLOT fixed-size slots,
+//   a key hashes to exactly one slot. Readers never lock: each slot has a
+//   sequence number that is odd while it is being written, a reader
+//   copies the slot and only trusts the copy if the sequence number was
+//   even and unchanged. Writers serialise through an exclusive flock()
+//   on the cache file.
+// ==================================================================================================
+#define CACHE_MAGIC      "IMGINFC4"   /* last character = version */
+#define CACHE_NSLOT      2048
+#define CACHE_SLOT_SIZE  32768
+
+typedef struct cache_file_header_s {
+  char     magic[8];
+  uint32_t nslot;
+  uint32_t slot_size;
+} cache_file_header;
+
+typedef struct cache_key_s {
+  file_stamp master;
+  uint64_t   path_hash;
+  int32_t    imgnum;
+  int32_t    iverb;
+  int32_t    h5check;
+  int32_t    sweep_summary;
+} cache_key;
+
+typedef struct cache_slot_s {
+  uint32_t  seq;     // odd while a writer updates this slot
+  uint32_t  len;     // length of payload following the slot header
+  cache_key key;
+} cache_slot;
+
+// the numerical part of an image_header as stored in the cache
+typedef struct cache_values_s {
+  int32_t format;
+  FLT64 dist, wave, osca, phis, phie, omes, omee, chis, chie, kaps, kape, twot;
+  FLT64 pixx, pixy;
+  INT32 numx, numy;
+  FLT64 beax, beay;
+  INT32 ovld;
+  int64_t epoch;
+  FLT64 etime, flux, thick, fpol;
+  INT32 msec;
+  INT32 nimg, ntrg, imgn, imgl, imgo, nmis;
+} cache_values;
+
+// mapping of the cache file in this process (forked workers open their
+// own: flock() locks are shared between duplicated descriptors)
+typedef struct header_cache_s {
+  string path;
+  pid_t  pid;
+  int    fd;
+  int    writable;
+  char*  map;
+  size_t size;
+} header_cache;
+
+header_cache hcache = { "", 0, -1, 0, NULL, 0 };
+
+uint64_t hash_bytes(const void* data, size_t n, uint64_t h)
+{
+  // FNV-1a
+  const unsigned char *p = (const unsigned char *) data;
+  for (size_t i = 0; i < n; i++) {
+    h ^= p[i];
+    h *= 1099511628211ULL;
   }
+  return h;
+}
 
-  if (nx!=INIT_INT&&ny!=INIT_INT) {
-    h->numx = nx;
-    h->numy = ny;
+
+int cache_open(const string& path)
+{
+  if (hcache.map!=NULL && hcache.pid==getpid() && hcache.path==path) return 1;
+  cache_close();
+
+  size_t size = sizeof(cache_file_header) + (size_t) CACHE_NSLOT * CACHE_SLOT_SIZE;
+  int writable = 1;
+  int fd = open(path.c_str(), O_RDWR|O_CREAT, 0666);
+  if (fd<0) {
+    writable = 0;
+    fd = open(path.c_str(), O_RDONLY);
+  }
+  if (fd<0) {
+    if (iverb>0) printf(" WARNING: unable to open cache file %s - not using cache!\n",path.c_str());
+    return 0;
   }
 
-  double px = INIT_DOUBLE;
-  double py = INIT_DOUBLE;
-  if (H5Lexists(fid,"/entry/instrument/detector/x_pixel_size",H5P_DEFAULT)>0) {
-    if (iverb>2) printf(" ... will read /entry/instrument/detector/x_pixel_size\n");
-    px   = hdf5_read_double(fid,"/entry/instrument/detector/x_pixel_size","m");
-    if (iverb>2) printf(" ... will read /entry/instrument/detector/y_pixel_size\n");
-    py   = hdf5_read_double(fid,"/entry/instrument/detector/y_pixel_size","m");
+  // initialise a new (empty) file or re-initialise one written by another
+  // version - as long as nobody else is writing to it. Anything else is
+  // not ours to overwrite
+  struct stat st;
+  cache_file_header fh;
+  int valid = ( fstat(fd, &st)==0 && (size_t) st.st_size==size &&
+                pread(fd, &fh, sizeof(fh), 0)==(ssize_t) sizeof(fh) &&
+                memcmp(fh.magic, CACHE_MAGIC, 8)==0 &&
+                fh.nslot==CACHE_NSLOT && fh.slot_size==CACHE_SLOT_SIZE );
+  if (!valid && writable) {
+    flock(fd, LOCK_EX);
+    valid = ( fstat(fd, &st)==0 && (size_t) st.st_size==size &&
+              pread(fd, &fh, sizeof(fh), 0)==(ssize_t) sizeof(fh) &&
+              memcmp(fh.magic, CACHE_MAGIC, 8)==0 &&
+              fh.nslot==CACHE_NSLOT && fh.slot_size==CACHE_SLOT_SIZE );
+    int ours = ( fstat(fd, &st)==0 &&
+                 (st.st_size==0 ||
+                  (pread(fd, &fh, sizeof(fh), 0)==(ssize_t) sizeof(fh) &&
+                   memcmp(fh.magic, CACHE_MAGIC, 7)==0)) );
+    if (!valid && !ours) {
+      flock(fd, LOCK_UN);
+      fprintf(stderr," WARNING: %s is not a cache file - not using cache (and leaving it alone)!\n",path.c_str());
+      close(fd);
+      return 0;
+    }
+    if (!valid && ftruncate(fd, 0)==0 && ftruncate(fd, size)==0) {
+      memcpy(fh.magic, CACHE_MAGIC, 8);
+      fh.nslot     = CACHE_NSLOT;
+      fh.slot_size = CACHE_SLOT_SIZE;
+      valid = ( pwrite(fd, &fh, sizeof(fh), 0)==(ssize_t) sizeof(fh) );
+    }
+    flock(fd, LOCK_UN);
   }
-  if (!isnan(px)&&!isnan(py)) {
-    h->pixx = (float) px*1000.0;
-    h->pixy = (float) py*1000.0;
+  if (!valid) {
+    if (iverb>0) printf(" WARNING: cache file %s not usable - not using cache!\n",path.c_str());
+    close(fd);
+    return 0;
   }
 
-  // given in m:
-  if (iverb>2)             printf(" ... will read /entry/instrument/detector/sensor_thickness\n");
-  double sensor_thickness = hdf5_read_double(fid,"/entry/instrument/detector/sensor_thickness","m");
-  if (!isnan(sensor_thickness)) {
-    h->thick = (float) sensor_thickness * 1000.0;
-    if (h->thick>=320.0) {
-      printf("\n WARNING: item \"/entry/instrument/detector/sensor_thickness\" gives value\n");
-      printf("          of %.2f mm - which doesn't make sense. We will adjust this\n",h->thick);
-      printf("          to %.5f, but please check your beamline/instrument!\n",(h->thick/1000.0));
-      h->thick = h->thick / 1000.0;
-    }
+  void *map = mmap(NULL, size, writable ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+  if (map==MAP_FAILED) {
+    if (iverb>0) printf(" WARNING: unable to map cache file %s - not using cache!\n",path.c_str());
+    close(fd);
+    return 0;
   }
 
-  if (iverb>2)             printf(" ... will read /entry/instrument/detector/threshold_energy\n");
-  double threshold_energy = hdf5_read_double(fid,"/entry/instrument/detector/threshold_energy","eV");
+  hcache.path     = path;
+  hcache.pid      = getpid();
+  hcache.fd       = fd;
+  hcache.writable = writable;
+  hcache.map      = (char *) map;
+  hcache.size     = size;
+  return 1;
+}
 
-  if (iverb>2)         printf(" ... will read /entry/instrument/detector/detectorSpecific/countrate_correction_count_cutoff\n");
-  int count_cutoff = hdf5_read_int(fid,"/entry/instrument/detector/detectorSpecific/countrate_correction_count_cutoff");
-  if (count_cutoff!=INIT_INT) {
-    h->ovld = count_cutoff;
-  } else {
-    if (iverb>2)         printf(" ... will read /entry/instrument/detector/saturation_value\n");
-    count_cutoff = hdf5_read_int(fid,"/entry/instrument/detector/saturation_value");
-    if (count_cutoff!=INIT_INT) {
-      h->ovld = count_cutoff;
-    }
-  }
-
-  if (iverb>2)  printf(" ... will read /entry/instrument/detector/detectorSpecific/nframes_sum\n");
-  int nframes_sum = hdf5_read_int(fid,"/entry/instrument/detector/detectorSpecific/nframes_sum");
-  if (iverb>2)  printf(" ... will read /entry/instrument/detector/detectorSpecific/nsequences\n");
-  int nsequences  = hdf5_read_int(fid,"/entry/instrument/detector/detectorSpecific/nsequences");
-
-  /* Close file */
-  status = H5Fclose(fid);
-
-  free(omega_trigger_start);
-  free(kappa_trigger_start);
-  free(chi_trigger_start);
-  free(phi_trigger_start);
-  free(two_theta_trigger_start);
-  free(omega_trigger_end);
-  free(kappa_trigger_end);
-  free(chi_trigger_end);
-  free(phi_trigger_end);
-  free(two_theta_trigger_end);
- 
+void cache_close()
+{
+  // a mapping inherited from the parent is left alone
+  if (hcache.map!=NULL && hcache.pid==getpid()) {
+    munmap(hcache.map, hcache.size);
+    close(hcache.fd);
+  }
+  hcache.path = "";
+  hcache.pid  = 0;
+  hcache.fd   = -1;
+  hcache.map  = NULL;
+}
+
+void cache_make_key(const imginfo_job* job, const file_stamp* master, cache_key* key)
+{
+  memset(key, 0, sizeof(cache_key));
+  key->master    = *master;
+  key->path_hash = hash_bytes(job->path.data(), job->path.size(), 14695981039346656037ULL);
+  key->imgnum    = job->imgnum;
+  key->iverb     = job->iverb;
+  key->h5check   = job->h5check;
+  key->sweep_summary = job->sweep_summary;
+}
+
+cache_slot* cache_slot_for(const cache_key* key)
+{
+  uint64_t h = hash_bytes(key, sizeof(cache_key), 14695981039346656037ULL);
+  return (cache_slot *) (hcache.map + sizeof(cache_file_header) + (size_t) (h % CACHE_NSLOT) * CACHE_SLOT_SIZE);
+}
+
+// payload: cache_values, strings detn/date/sensm and the report text (each
+// as length + bytes), number of external files and for each its stamp
+// and name, rotation axis, sweeps, filters and the warnings and errors
+// among the diagnostics
+void cache_put_string(string& buf, const string& s)
+{
+  uint32_t n = s.size();
+  buf.append((const char *) &n, sizeof(n));
+  buf.append(s);
+}
+
+int cache_get_string(const char** p, const char* end, string& s)
+{
+  uint32_t n;
+  if (end-*p < (ssize_t) sizeof(n)) return 0;
+  memcpy(&n, *p, sizeof(n));
+  *p += sizeof(n);
+  if (end-*p < (ssize_t) n) return 0;
+  s.assign(*p, n);
+  *p += n;
+  return 1;
+}
+
+int cache_lookup(const imginfo_job* job, image_header* h, string& text, vector<imginfo_diag>& diags)
+{
+  file_stamp master;
+  cache_key key;
+  get_file_stamp(job->path.c_str(), &master);
+  if (master.ino==0) return 0;
+  cache_make_key(job, &master, &key);
+
+  cache_slot *slot = cache_slot_for(&key);
+  volatile uint32_t *seq = &slot->seq;
+  string payload;
+
+  uint32_t seq1 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+  if (seq1 & 1) return 0;
+  if (memcmp(&slot->key, &key, sizeof(cache_key))!=0) return 0;
+  uint32_t len = slot->len;
+  if (len==0 || len > CACHE_SLOT_SIZE - sizeof(cache_slot)) return 0;
+  payload.assign((const char *) (slot+1), len);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (__atomic_load_n(seq, __ATOMIC_RELAXED)!=seq1) return 0;
+
+  const char *p   = payload.data();
+  const char *end = p + payload.size();
+  cache_values v;
+  uint32_t nfile;
+  if (end-p < (ssize_t) sizeof(v)) return 0;
+  memcpy(&v, p, sizeof(v));
+  p += sizeof(v);
+  if (!cache_get_string(&p, end, h->detn))  return 0;
+  if (!cache_get_string(&p, end, h->date))  return 0;
+  if (!cache_get_string(&p, end, h->sensm)) return 0;
+  if (!cache_get_string(&p, end, text))     return 0;
+  if (end-p < (ssize_t) sizeof(nfile)) return 0;
+  memcpy(&nfile, p, sizeof(nfile));
+  p += sizeof(nfile);
+  h->extf.clear();
+  for (uint32_t ifile = 0; ifile < nfile; ifile++) {
+    file_stamp stored, current;
+    string file;
+    if (end-p < (ssize_t) sizeof(stored)) return 0;
+    memcpy(&stored, p, sizeof(stored));
+    p += sizeof(stored);
+    if (!cache_get_string(&p, end, file)) return 0;
+    get_file_stamp(file.c_str(), &current);
+    if (memcmp(&stored, &current, sizeof(file_stamp))!=0) {
+      if (iverb>1) printf(" [debug] cache entry outdated: %s changed\n", file.c_str());
+      return 0;
+    }
+    h->extf.push_back(file);
+  }
+  uint32_t nsweep, nfilt;
+  if (!cache_get_string(&p, end, h->rota)) return 0;
+  if (end-p < (ssize_t) sizeof(nsweep)) return 0;
+  memcpy(&nsweep, p, sizeof(nsweep));
+  p += sizeof(nsweep);
+  if ((size_t) (end-p) < nsweep*sizeof(image_sweep)) return 0;
+  h->swps.resize(nsweep);
+  if (nsweep>0) memcpy(&h->swps[0], p, nsweep*sizeof(image_sweep));
+  p += nsweep*sizeof(image_sweep);
+  if (end-p < (ssize_t) sizeof(nfilt)) return 0;
+  memcpy(&nfilt, p, sizeof(nfilt));
+  p += sizeof(nfilt);
+  h->filt.resize(nfilt);
+  for (uint32_t ifilt = 0; ifilt < nfilt; ifilt++) {
+    if (end-p < (ssize_t) sizeof(INT32)) return 0;
+    memcpy(&h->filt[ifilt].id, p, sizeof(INT32));
+    p += sizeof(INT32);
+    if (!cache_get_string(&p, end, h->filt[ifilt].name)) return 0;
+  }
+  uint32_t ndiag;
+  if (end-p < (ssize_t) sizeof(ndiag)) return 0;
+  memcpy(&ndiag, p, sizeof(ndiag));
+  p += sizeof(ndiag);
+  diags.resize(ndiag);
+  for (uint32_t idiag = 0; idiag < ndiag; idiag++) {
+    if (end-p < (ssize_t) sizeof(int32_t)) return 0;
+    int32_t level;
+    memcpy(&level, p, sizeof(level));
+    p += sizeof(level);
+    diags[idiag].level = level;
+    if (!cache_get_string(&p, end, diags[idiag].text)) return 0;
+  }
+
+  h->format = (format_t) v.format;
+  h->dist   = v.dist;   h->wave  = v.wave;  h->osca  = v.osca;
+  h->phis   = v.phis;   h->phie  = v.phie;
+  h->omes   = v.omes;   h->omee  = v.omee;
+  h->chis   = v.chis;   h->chie  = v.chie;
+  h->kaps   = v.kaps;   h->kape  = v.kape;
+  h->twot   = v.twot;
+  h->pixx   = v.pixx;   h->pixy  = v.pixy;
+  h->numx   = v.numx;   h->numy  = v.numy;
+  h->beax   = v.beax;   h->beay  = v.beay;
+  h->ovld   = v.ovld;
+  h->epoch  = (time_t) v.epoch;
+  h->etime  = v.etime;  h->flux  = v.flux;
+  h->thick  = v.thick;  h->fpol  = v.fpol;
+  h->msec   = v.msec;
+  h->nimg   = v.nimg;   h->ntrg  = v.ntrg;
+  h->imgn   = v.imgn;   h->imgl  = v.imgl;  h->imgo  = v.imgo;
+  h->nmis   = v.nmis;
   return 1;
 }
 
+void cache_store(const imginfo_job* job, const file_stamp* master, const image_header* h, const string& text,
+                 const vector<imginfo_diag>& diags)
+{
+  if (!hcache.writable) return;
+
+  // the master file changed while we were reading it
+  file_stamp now;
+  get_file_stamp(job->path.c_str(), &now);
+  if (master->ino==0 || memcmp(master, &now, sizeof(file_stamp))!=0) return;
+
+  cache_values v;
+  memset(&v, 0, sizeof(v));
+  v.format = h->format;
+  v.dist   = h->dist;   v.wave  = h->wave;  v.osca  = h->osca;
+  v.phis   = h->phis;   v.phie  = h->phie;
+  v.omes   = h->omes;   v.omee  = h->omee;
+  v.chis   = h->chis;   v.chie  = h->chie;
+  v.kaps   = h->kaps;   v.kape  = h->kape;
+  v.twot   = h->twot;
+  v.pixx   = h->pixx;   v.pixy  = h->pixy;
+  v.numx   = h->numx;   v.numy  = h->numy;
+  v.beax   = h->beax;   v.beay  = h->beay;
+  v.ovld   = h->ovld;
+  v.epoch  = h->epoch;
+  v.etime  = h->etime;  v.flux  = h->flux;
+  v.thick  = h->thick;  v.fpol  = h->fpol;
+  v.msec   = h->msec;
+  v.nimg   = h->nimg;   v.ntrg  = h->ntrg;
+  v.imgn   = h->imgn;   v.imgl  = h->imgl;  v.imgo  = h->imgo;
+  v.nmis   = h->nmis;
+
+  string payload((const char *) &v, sizeof(v));
+  cache_put_string(payload, h->detn);
+  cache_put_string(payload, h->date);
+  cache_put_string(payload, h->sensm);
+  cache_put_string(payload, text);
+  uint32_t nfile = h->extf.size();
+  payload.append((const char *) &nfile, sizeof(nfile));
+  for (uint32_t ifile = 0; ifile < nfile; ifile++) {
+    file_stamp s;
+    get_file_stamp(h->extf[ifile].c_str(), &s);
+    payload.append((const char *) &s, sizeof(s));
+    cache_put_string(payload, h->extf[ifile]);
+  }
+  cache_put_string(payload, h->rota);
+  uint32_t nsweep = h->swps.size();
+  payload.append((const char *) &nsweep, sizeof(nsweep));
+  if (nsweep>0) payload.append((const char *) &h->swps[0], nsweep*sizeof(image_sweep));
+  uint32_t nfilt = h->filt.size();
+  payload.append((const char *) &nfilt, sizeof(nfilt));
+  for (uint32_t ifilt = 0; ifilt < nfilt; ifilt++) {
+    payload.append((const char *) &h->filt[ifilt].id, sizeof(INT32));
+    cache_put_string(payload, h->filt[ifilt].name);
+  }
+  uint32_t ndiag = 0;
+  for (size_t idiag = 0; idiag < diags.size(); idiag++) {
+    if (diags[idiag].level>=IMGINFO_WARNING) ndiag++;
+  }
+  payload.append((const char *) &ndiag, sizeof(ndiag));
+  for (size_t idiag = 0; idiag < diags.size(); idiag++) {
+    if (diags[idiag].level<IMGINFO_WARNING) continue;
+    int32_t level = diags[idiag].level;
+    payload.append((const char *) &level, sizeof(level));
+    cache_put_string(payload, diags[idiag].text);
+  }
+  if (payload.size() > CACHE_SLOT_SIZE - sizeof(cache_slot)) {
+    if (iverb>1) printf(" [debug] report too large for cache (%d bytes)\n", (int) payload.size());
+    return;
+  }
+
+  cache_key key;
+  cache_make_key(job, master, &key);
+  cache_slot *slot = cache_slot_for(&key);
+
+  // a slot left odd by a writer that died is simply taken over: nobody
+  // else can be writing while we hold the lock
+  if (flock(hcache.fd, LOCK_EX)<0) return;
+  uint32_t seq = slot->seq | 1;
+  __atomic_store_n(&slot->seq, seq, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  slot->len = payload.size();
+  slot->key = key;
+  memcpy(slot+1, payload.data(), payload.size());
+  __atomic_store_n(&slot->seq, seq+1, __ATOMIC_RELEASE);
+  flock(hcache.fd, LOCK_UN);
+}
 
 // ==================================================================================================
 // Report
 // ==================================================================================================
 void print_header(image_header *h, int idet, int inorm) {
+  trace_span span("output", "print_header", NULL);
 
   int nosc = 0;
   FLT64 d;
@@ -2334,805 +3100,3 @@ void print_header(image_header *h, int idet, int inorm) {
   printf("\n\n");
 }
 
-// ==================================================================================================
-// initialisation
-// ==================================================================================================
-void empty_header(image_header* h) {
-  h->format = FORMAT_UNKNOWN;
-  h->dist  = INIT_DOUBLE;
-  h->wave  = INIT_DOUBLE;
-  h->osca  = INIT_DOUBLE;
-  h->phis  = INIT_DOUBLE;
-  h->phie  = INIT_DOUBLE;
-  h->omes  = INIT_DOUBLE;
-  h->omee  = INIT_DOUBLE;
-  h->chis  = INIT_DOUBLE;
-  h->chie  = INIT_DOUBLE;
-  h->kaps  = INIT_DOUBLE;
-  h->kape  = INIT_DOUBLE;
-  h->twot  = INIT_DOUBLE;
-  h->pixx  = INIT_DOUBLE;
-  h->pixy  = INIT_DOUBLE;
-  h->numx  = 0;
-  h->numy  = 0;
-  h->beax  = INIT_DOUBLE;
-  h->beay  = INIT_DOUBLE;
-  h->ovld  = 0;
-  h->epoch = 0;
-  h->etime = INIT_DOUBLE;
-  h->flux  = INIT_DOUBLE;
-  h->thick = INIT_DOUBLE;
-  h->fpol  = INIT_DOUBLE;
-  h->msec  = -1;
-  h->detn  = "N/A";
-  h->date  = "N/A";
-  h->sensm = "N/A";
-}
-
-char *hdf5_read_char(hid_t fid, const char* item) {
-
-  if (iverb > 2) {
-    printf("Reading char: %s\n", item);
-  }
-
-  char* r = (char*)malloc(1);r[0] = '\0';
-  hid_t did, space_c, memtype_c, filetype_c;
-  hsize_t dims_c[1] = {1};
-  int ndims_c, sdim_c;
-  herr_t status;
-  
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0 ) {
-    did = H5Dopen2(fid,item, H5P_DEFAULT);
-
-    filetype_c = H5Dget_type(did);
-    sdim_c = H5Tget_size (filetype_c);
-    sdim_c++;                         /* Make room for null terminator */
-    space_c = H5Dget_space (did);
-    ndims_c = H5Sget_simple_extent_dims (space_c, dims_c, NULL);
-    memtype_c = H5Tcopy (H5T_C_S1);
-    
-    // if this is e.g. a variable-length string (e.g. 7OMC dataset):
-    if (H5Tis_variable_str(filetype_c)>0&&ndims_c==0) {
-      char *strdata = (char *) calloc(1024, sizeof(char));
-      status = H5Dread(did, filetype_c, H5S_ALL, H5S_ALL, H5P_DEFAULT, &strdata);
-      sdim_c = strlen(strdata);
-      sdim_c++;
-      r = (char *) malloc (dims_c[0] * sdim_c * sizeof (char));
-      if (status>=0) {
-        strncpy(r,strdata,sdim_c);
-      }
-      free(strdata);
-    }
-
-    // fixed length datatype
-    else {
-      status = H5Tset_size (memtype_c, sdim_c);
-      r = (char *) malloc (dims_c[0] * sdim_c * sizeof (char));
-      status = H5Dread(did, memtype_c, H5S_ALL, H5S_ALL, H5P_DEFAULT, r);
-    }
-
-    if (status>=0) {
-      if (iverb>1) printf("     %s = \"%s\"\n",item,r);
-    } else {
-      if (iverb>2) printf("     WARNING: problem reading %s\n",item);
-    }
-    status = H5Dclose(did);
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    if (iverb>1) {
-      printf("     WARNING: problem finding %s\n",item);
-    }
-  }
-  return(r);
-}
-
-char *hdf5_read_group_attribute(hid_t fid, const char* item, const char* attribute) {
-
-  char* r = (char*)malloc(1);r[0] = '\0';
-  hid_t gid, space_c, memtype_c, filetype_c;
-  hsize_t dims_c[1] = {1};
-  int ndims_c, sdim_c;
-  herr_t status;
-
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0) {
-    gid = H5Gopen2(fid,item, H5P_DEFAULT);
-
-    status = H5Aexists(gid,attribute);
-    if (status>0) {
-      hid_t attribute_id    = H5Aopen_name(gid,attribute);
-      hid_t attribute_type  = H5Aget_type(attribute_id);
-      hid_t attribute_space = H5Aget_space(attribute_id);
-      size_t attribute_n = H5Tget_size(attribute_type);
-      r = (char *)malloc(sizeof(char)*(attribute_n+1));
-      status = H5Aread(attribute_id, attribute_type, r);
-      // safety net (assume H5T_STR_NULLPAD)
-      // see also: https://github.com/h5py/h5py/issues/727
-      //           https://forum.hdfgroup.org/t/bug-writing-a-string-does-not-include-null-terminator/5281
-      //           https://docs.hdfgroup.org/hdf5/develop/group___h5_t.html#gae5f38bfd4a4c557496b3194b5180212c
-      r[attribute_n] = '\0';
-      if (status>=0) {
-	if (iverb>1) printf("     %s = \"%s\"\n",item,r);
-      } else {
-	if (iverb>2) printf("     WARNING: problem reading attribute %s from group %s\n",attribute,item);
-      }
-      H5Tclose(attribute_type);
-      H5Sclose(attribute_space);
-      H5Aclose(attribute_id);
-    } else {
-      if (iverb>1) {
-	printf("     WARNING: problem finding attribute \"%s\" in group %s\n",attribute,item);
-      }
-    }
-    status = H5Gclose(gid);
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    if (iverb>1) {
-      printf("     WARNING: problem finding %s\n",item);
-    }
-  }
-  return(r);
-}
-
-int hdf5_read_int(hid_t fid, const char* item) {
-
-  // supports H5T_NATIVE_INT
-  //          H5T_NATIVE_LONG
-  //          H5T_NATIVE_ULONG
-  //          H5T_NATIVE_USHORT
-  //          H5T_NATIVE_UINT
-  //          H5T_NATIVE_FLOAT
-  //          H5T_NATIVE_DOUBLE
-
-  if (iverb > 2) {
-    printf("Reading int: %s\n", item);
-  }
-
-  int r = INIT_INT;
-  hid_t did;
-  herr_t status;
-  int data_i[10];
-
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0 ) {
-    did = H5Dopen2(fid, item, H5P_DEFAULT);
-    hid_t ptyp = H5Dget_type(did);
-    size_t ptyp_size;
-    hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
-    if (H5Tequal(type,H5T_NATIVE_INT)) {
-      if (iverb>3) printf("     read INT from %s\n",item);
-      status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_i);
-    }
-    else if (H5Tequal(type,H5T_NATIVE_LONG)) {
-      if (iverb>3) printf("     read LONG from %s\n",item);
-      long data_d[10];
-      status = H5Dread(did, H5T_NATIVE_LONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
-      if (status>=0) {
-        data_i[0] = (int) data_d[0];
-      }
-    }
-    else if (H5Tequal(type,H5T_NATIVE_ULONG)) {
-      if (iverb>3) printf("     read UNSIGNED LONG from %s\n",item);
-      unsigned long data_d[10];
-      status = H5Dread(did, H5T_NATIVE_ULONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
-      if (status>=0) {
-        data_i[0] = (int) data_d[0];
-      }
-    }
-    else if (H5Tequal(type,H5T_NATIVE_USHORT)) {
-      if (iverb>3) printf("     read UNSIGNED SHORT from %s\n",item);
-      unsigned short data_d[10];
-      status = H5Dread(did, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
-      if (status>=0) {
-        data_i[0] = (int) data_d[0];
-      }
-    }
-    else if (H5Tequal(type,H5T_NATIVE_UINT)) {
-      if (iverb>3) printf("     read UNSIGNED INT from %s\n",item);
-      unsigned int data_d[10];
-      status = H5Dread(did, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
-      if (status>=0) {
-        data_i[0] = (int) data_d[0];
-      }
-    }
-    else if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
-      if (iverb>3) printf("     read DOUBLE from %s\n",item);
-      double data_d[10];
-      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
-      if (status>=0) {
-        data_i[0] = (int) data_d[0];
-      }
-    }
-    else if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
-      if (iverb>3) printf("     read FLOAT from %s\n",item);
-      float data_f[10];
-      status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_f);
-      if (status>=0) {
-        data_i[0] = (int) data_f[0];
-      }
-    }
-    else {
-      printf("     ERROR: unsupported datatype for item %s = %ld\n",item,type);
-    }
-    if (status>=0) {
-      r = data_i[0];
-      if (iverb>1) printf("     %s = %d\n",item,r);
-    } else {
-      if (iverb>2) printf("     WARNING: error when reading %s\n",item);
-    }
-    status = H5Dclose(did);
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    if (iverb>2) printf("     WARNING: %s doesn't exist\n",item);
-  }
-  return(r);
-
-}
-
-int hdf5_read_dataset_size(hid_t fid, const char* item) {
-
-  int r = INIT_INT;
-  hid_t did;
-  herr_t status;
-
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0 ) {
-    did = H5Dopen2(fid, item, H5P_DEFAULT);
-    hid_t sid = H5Dget_space(did);
-    r = (int) H5Sget_simple_extent_npoints(sid);
-    if (iverb>2) printf("     dataset \"%s\" has size %d\n",item,r);
-  } else {
-    if (iverb>2) printf("     WARNING: %s doesn't exist\n",item);
-  }
-  return(r);
-
-}
-
-double hdf5_read_double(hid_t fid, const char* item, const char* unit) {
-
-  double r = INIT_DOUBLE;
-  hid_t did;
-  herr_t status;
-  double data_d[10];
-  double fac = 1.0;
-
-  if (iverb > 2) {
-    printf("Reading double: %s\n", item);
-  }
-
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0 ) {
-    did = H5Dopen2(fid, item, H5P_DEFAULT);
-    hid_t ptyp = H5Dget_type(did);
-    size_t ptyp_size;
-    hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
-    if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
-      if (iverb>3) printf("     read DOUBLE from %s\n",item);
-      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
-    } else {
-      if (H5Tequal(type,H5T_NATIVE_INT)) {
-        if (iverb>3) printf("     read INT from %s\n",item);
-        int data_i[10];
-        status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_i);
-        if (status>=0) {
-          data_d[0] = (double) data_i[0];
-        }
-      }
-      else if (H5Tequal(type,H5T_NATIVE_LONG)) {
-        if (iverb>3) printf("     read LONG from %s\n",item);
-        long data_i[10];
-        status = H5Dread(did, H5T_NATIVE_LONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_i);
-        if (status>=0) {
-          data_d[0] = (double) data_i[0];
-        }
-      }
-      else if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
-        if (iverb>3) printf("     read FLOAT from %s\n",item);
-        float data_f[10];
-        status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_f);
-        if (status>=0) {
-          data_d[0] = (double) data_f[0];
-        }
-      }
-      else {
-        printf("     ERROR: unsupported datatype for item %s = %ld\n",item,type);
-      }
-    }
-
-    if (status>=0) {
-      r = data_d[0];
-      if (strcmp(unit,"NULL")!=0) {
-	int l = strlen(unit);
-	status = H5Aexists(did,"units");
-	if (status>0) {
-	  hid_t attribute_id    = H5Aopen_name(did,"units");
-	  hid_t attribute_type  = H5Aget_type(attribute_id);
-	  hid_t attribute_space = H5Aget_space(attribute_id);
-	  size_t attribute_n = H5Tget_size(attribute_type);
-	  char* string_array = (char *)malloc(sizeof(char)*(attribute_n+1));
-	  H5Aread(attribute_id, attribute_type, string_array);
-	  string_array[attribute_n] = '\0';
-	  if ( (l!=attribute_n) || (strncmp(unit,string_array,l)!=0)) {
-	    if      ((strcmp(unit,"m")==0)&&(strcmp(string_array,"mm")==0)) {
-	      fac = 0.001;
-	    }
-	    else if ((strcmp(unit,"mm")==0)&&(strcmp(string_array,"m")==0)) {
-	      fac = 1000.0;
-	    }
-	    // accept degree/deg "mismatch"
-	    else if ((strcmp(unit,"degree")==0)&&(strcmp(string_array,"deg")==0)) {
-	      fac = 1.0;
-	    }
-	    else if ((strcmp(unit,"deg")==0)&&(strcmp(string_array,"degree")==0)) {
-	      fac = 1.0;
-	    }
-	    else if (strncmp(unit,string_array,(l-1))!=0) {
-	      printf("\n WARNING: expected unit \"%s\" for item \"%s\" - but found unit \"%s\" (length=%d)!!\n\n",unit,item,string_array,l);
-	    }
-	  }
-	  if (iverb>1) {
-	    printf("     %s = %f %s\n",item,r,unit);
-	  }
-	  free(string_array);
-	  H5Tclose(attribute_type);
-	  H5Sclose(attribute_space);
-	  H5Aclose(attribute_id);
-	} else {
-	  if (iverb>1) {
-	    printf("     WARNING: problem finding attribute \"units\" in group %s\n",item);
-	  }
-	}
-      } else {
-	if (iverb>1) {
-	  printf("     %s = %f\n",item,r);
-	}
-      }
-    } else {
-      if (iverb>2) printf("     WARNING: problem when reading %s\n",item);
-    }
-    status = H5Dclose(did);
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    if (iverb>2) printf("     WARNING: %s doesn't exist\n",item);
-  }
-  return(r*fac);
-
-}
-
-double* hdf5_read_ndouble(hid_t fid, const char* item, const char* unit, int* n) {
-
-  int s = (*n * sizeof (double));
-  double *d = (double*) malloc(s);
-  hid_t did;
-  herr_t status;
-
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0 ) {
-    did = H5Dopen2(fid, item, H5P_DEFAULT);
-
-    hid_t sid = H5Dget_space(did);
-    hsize_t nid = H5Sget_simple_extent_npoints(sid);
-    if (nid>*n) {
-      if (iverb>1) printf("     WARNING: requested to read only %d items while data has size %llu\n",*n,nid);
-      s = (nid * sizeof (double));
-      double *d_tmp = (double*) malloc(s);
-      // check if these are truly H5T_NATIVE_DOUBLE
-      hid_t ptyp = H5Dget_type(did);
-      size_t ptyp_size;
-      hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
-      if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
-        if (iverb>3) printf("     read %llu DOUBLEs from %s\n",nid,item);
-        status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d_tmp);
-      } else {
-        if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
-          float *f_tmp = (float*) malloc(s);
-          if (iverb>3) printf("     read %llu FLOATs from %s\n",nid,item);
-          status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, f_tmp);
-          if (status>=0) {
-            for(int i=0; i<*n; i++) {
-              d_tmp[i]=(double) f_tmp[i];
-            }
-          }
-          free(f_tmp);
-        } else {
-          printf("     ERROR: unsupported datatype for item %s = %ld\n",item,type);
-        }
-      }
-      for(int i=0; i<*n; i++) {
-	d[i]=d_tmp[i];
-	if (iverb>3) printf("     setting d[%d] = d_tmp[%d] = %f\n",i,i,d[i]);
-      }
-      free(d_tmp);
-    }
-    else if (nid<*n) {
-      if (iverb>1) printf("     WARNING: requested to read %d items while data has only size %llu\n",*n,nid);
-      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d);
-      if (nid==1) {
-	if (iverb>1) printf("              will set all items to first/only one stored = %f\n",d[0]);
-	for(int i=1; i<*n; i++) {
-	  d[i]=d[0];
-	}
-      } else {
-	if (iverb>1) printf("              will set all items to last one stored = %f\n",d[(nid-1)]);
-	for(int i=nid; i<*n; i++) {
-	  d[i]=d[(nid-1)];
-	}
-      }
-    }
-    else {
-      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d);
-    }
-    if (status>=0) {
-      if (iverb>1) {
-	printf("     %s[0] = %f\n",item,d[0]);
-	if (*n>1) {
-	  printf("     %s[1] = %f\n",item,d[1]);
-	  if (*n>2) {
-	    printf("     %s[2] = %f\n",item,d[2]);
-	  }
-	} else {
-	  if (iverb>2) printf("     only one item to be read - not reporting further values\n");
-	}
-      }
-    } else {
-      if (iverb>2) printf("     WARNING: problem when reading %s\n",item);
-      d[0] = INIT_DOUBLE;
-    }
-    status = H5Dclose(did);
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    d[0] = INIT_DOUBLE;
-    if (iverb>2) printf("     %s[0] set to INIT_DOUBLE because it doesn't exist\n",item);
-  }
-
-  return(d);
-
-}
-
-int* hdf5_read_nint(hid_t fid, const char* item, int* n) {
-
-  // supports H5T_NATIVE_INT
-  //          H5T_NATIVE_LONG
-  //          H5T_NATIVE_ULONG
-  //          H5T_NATIVE_USHORT
-  //          H5T_NATIVE_UINT
-  //          H5T_NATIVE_FLOAT
-  //          H5T_NATIVE_DOUBLE
-
-  int s = (*n * sizeof (int));
-  int *d = (int*) malloc(s);
-  hid_t did;
-  herr_t status;
-
-  status = H5Lexists(fid,item,H5P_DEFAULT);
-  if (status > 0 ) {
-    did = H5Dopen2(fid, item, H5P_DEFAULT);
-    hid_t sid = H5Dget_space(did);
-    hsize_t nid = H5Sget_simple_extent_npoints(sid);
-    if (nid>*n) {
-      if (iverb>1) printf("     WARNING: requested to read only %d items while data has size %llu\n",*n,nid);
-      s = (nid * sizeof (int));
-      int *d_tmp = (int*) malloc(s);
-      // check if these are truly H5T_NATIVE_INT
-      hid_t ptyp = H5Dget_type(did);
-      size_t ptyp_size;
-      hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
-      if (H5Tequal(type,H5T_NATIVE_INT)) {
-        if (iverb>3) printf("     read INT from %s\n",item);
-        status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, d_tmp);
-      }
-      else {
-        if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
-          if (iverb>3) printf("     read DOUBLE from %s\n",item);
-          double *dd_tmp = (double*) malloc(s);
-          status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
-          // cast to int
-          for(int i=0; i<*n; i++) {
-            d_tmp[i]=(int) dd_tmp[i];
-          }
-          free(dd_tmp);
-        }
-        else if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
-          if (iverb>3) printf("     read FLOAT from %s\n",item);
-          float *dd_tmp = (float*) malloc(s);
-          status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
-          // cast to int
-          for(int i=0; i<*n; i++) {
-            d_tmp[i]=(int) dd_tmp[i];
-          }
-          free(dd_tmp);
-        }
-        else if (H5Tequal(type,H5T_NATIVE_LONG)) {
-          if (iverb>3) printf("     read LONG from %s\n",item);
-          long *dd_tmp = (long*) malloc(s);
-          status = H5Dread(did, H5T_NATIVE_LONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
-          // cast to int
-          for(int i=0; i<*n; i++) {
-            d_tmp[i]=(int) dd_tmp[i];
-          }
-          free(dd_tmp);
-        }
-        else if (H5Tequal(type,H5T_NATIVE_ULONG)) {
-          if (iverb>3) printf("     read UNSIGNED LONG from %s\n",item);
-          unsigned long *dd_tmp = (unsigned long*) malloc(s);
-          status = H5Dread(did, H5T_NATIVE_ULONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
-          // cast to int
-          for(int i=0; i<*n; i++) {
-            d_tmp[i]=(int) dd_tmp[i];
-          }
-          free(dd_tmp);
-        }
-        else if (H5Tequal(type,H5T_NATIVE_USHORT)) {
-          if (iverb>3) printf("     read UNSIGNED SHORT from %s\n",item);
-          unsigned short *dd_tmp = (unsigned short*) malloc(s);
-          status = H5Dread(did, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
-          // cast to int
-          for(int i=0; i<*n; i++) {
-            d_tmp[i]=(int) dd_tmp[i];
-          }
-          free(dd_tmp);
-        }
-        else if (H5Tequal(type,H5T_NATIVE_UINT)) {
-          if (iverb>3) printf("     read UNSIGNED INT from %s\n",item);
-          unsigned int *dd_tmp = (unsigned int*) malloc(s);
-          status = H5Dread(did, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
-          // cast to int
-          for(int i=0; i<*n; i++) {
-            d_tmp[i]=(int) dd_tmp[i];
-          }
-          free(dd_tmp);
-        }
-        else {
-          printf("     ERROR: unsupported datatype for item %s = %ld\n",item,type);
-        }
-      }
-      for(int i=0; i<*n; i++) {
-	d[i]=d_tmp[i];
-	if (iverb>3) printf("     setting d[%d] = d_tmp[%d] = %d\n",i,i,d[i]);
-      }
-      free(d_tmp);
-    } else {
-      status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, d);
-    }
-    if (status>=0) {
-      if (iverb>1) {
-	printf("     %s[0] = %d\n",item,d[0]);
-	if (*n>1) {
-	  printf("     %s[1] = %d\n",item,d[1]);
-	  if (*n>2) {
-	    printf("     %s[2] = %d\n",item,d[2]);
-	  }
-	} else {
-	  if (iverb>2) printf("     only one item to be read - not reporting further values\n");
-	}
-      }
-    } else {
-      if (iverb>2) printf("     WARNING: problem when reading %s\n",item);
-      d[0] = INIT_INT;
-    }
-    status = H5Dclose(did);
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    d[0] = INIT_INT;
-    if (iverb>2) printf("     %s[0] set to INIT_DOUBLE because it doesn't exist\n",item);
-  }
-
-  return(d);
-
-}
-double* hdf5_read_axis_vector(hid_t fid, const char* item) {
-
-  int s = (3 * sizeof (double));
-  double *d = (double*) malloc(s);
-
-  d[0]=INIT_DOUBLE;
-  d[1]=INIT_DOUBLE;
-  d[2]=INIT_DOUBLE;
-
-  hid_t gid;
-  herr_t status;
-  double data_d[10];
-  H5O_info_t info;
-
-  if (H5Lexists(fid,item,H5P_DEFAULT)>0) {
-    status = H5Oget_info_by_name(fid,item,&info,H5P_DEFAULT);
-    switch (info.type) {
-      case H5O_TYPE_DATASET:
-	gid = H5Dopen2(fid, item, H5P_DEFAULT);
-	if (gid < 0) {
-	  printf("\n\n ERROR - group/dataset=\"%s\" doesn't exist!\n\n",item);
-	  return(d);
-	}
-	break;
-      case H5O_TYPE_GROUP:
-	gid = H5Gopen2(fid, item, H5P_DEFAULT);
-	if (gid < 0) {
-	  printf("\n\n ERROR - in H5Gopen2 (group=\"%s\")!\n\n",item);
-	  return(d);
-	}
-	break;
-    }
-
-    if (H5Aexists(gid,"vector")>0) {
-      hid_t attribute_id    = H5Aopen_name(gid,"vector");
-      hid_t attribute_type  = H5Aget_type(attribute_id);
-      hid_t attribute_space = H5Aget_space(attribute_id);
-      size_t attribute_n    = H5Tget_size(attribute_type);
-
-      if (H5Aread(attribute_id,H5T_NATIVE_DOUBLE,data_d) >= 0 ) {
-	if (iverb>2) printf("     %s vector = %f %f %f\n",item,data_d[0],data_d[1],data_d[2]);
-	d[0]=data_d[0];
-	d[1]=data_d[1];
-	d[2]=data_d[2];
-      }
-      H5Tclose(attribute_type);
-      H5Sclose(attribute_space);
-      H5Aclose(attribute_id);
-    }
-    switch (info.type) {
-      case H5O_TYPE_DATASET:
-	status = H5Dclose(gid);
-	break;
-      case H5O_TYPE_GROUP:
-	status = H5Gclose(gid);
-	break;
-    }
-    if (status<0) {
-      if (iverb>2) printf("     WARNING: problem when closing %s\n",item);
-    } else {
-      if (iverb>3) printf("     successfully closed %s\n",item);
-    }
-  } else {
-    if (iverb>2) printf("     WARNING: %s doesn't exist\n",item);
-  }
-  return(d);
-
-}
-int hdf5_list_filters (hid_t plist) {
-    int nfilt = H5Pget_nfilters(plist);
-    if (nfilt<=0) return(1);
-    unsigned ifilt;
-    unsigned     filt_flags;          /* filter flags */
-    H5Z_filter_t filt_id;             /* filter identification number */
-    unsigned     filt_cd_values[20];  /* filter client data values */
-    filt_cd_values[0] =  1;
-    filt_cd_values[1] =  2;
-    filt_cd_values[2] =  3;
-    filt_cd_values[3] =  4;
-    filt_cd_values[4] =  5;
-    size_t       filt_cd_nelmts = 0;  /* filter client number of values */
-    char         filt_name[256];      /* filter name */
-    unsigned     filt_config;         /* Bit field, as described in H5Zget_filter_info. */
-    htri_t avail;
-
-    if (iverb>2) printf(" Number of filters in file = %d\n",nfilt);
-
-    for (ifilt = 0; ifilt < nfilt; ifilt++ ) {
-      filt_id = H5Pget_filter(plist,ifilt,&filt_flags,&filt_cd_nelmts,filt_cd_values,sizeof(filt_name),filt_name,&filt_config);
-      if (iverb>=0) printf(" Filter-%d : %s (%d)\n",ifilt,filt_name,filt_id);
-      switch (filt_id) {
-      case H5Z_FILTER_DEFLATE:
-	if (iverb>=1) printf("   natively supported filter = H5Z_FILTER_DEFLATE\n");
-	avail = H5Zfilter_avail(filt_id);
-	if (!avail) {
-	  printf ("\n\n ERROR - gzip filter not available.\n");
-	  exit(EXIT_FAILURE);
-	}
-	break;
-      case H5Z_FILTER_SHUFFLE:
-	if (iverb>=1) printf("   natively supported filter = H5Z_FILTER_SHUFFLE\n");
-	avail = H5Zfilter_avail(filt_id);
-	if (!avail) {
-	  printf ("\n\n ERROR - Shuffle filter not available.\n");
-	  exit(EXIT_FAILURE);
-	}
-	break;
-      case H5Z_FILTER_FLETCHER32:
-	if (iverb>=1) printf("   natively supported filter = H5Z_FILTER_FLETCHER32\n");
-	avail = H5Zfilter_avail(filt_id);
-	if (!avail) {
-	  printf ("\n\n ERROR - fletcher32 filter not available.\n");
-	  exit(EXIT_FAILURE);
-	}
-	break;
-      case H5Z_FILTER_SZIP:
-	if (iverb>=1) printf("   natively supported filter = H5Z_FILTER_SZIP\n");
-	avail = H5Zfilter_avail(filt_id);
-	if (!avail) {
-	  printf ("\n\n ERROR - szip filter not available.\n");
-	  exit(EXIT_FAILURE);
-	}
-	break;
-      case H5Z_FILTER_NBIT:
-	if (iverb>=1) printf("   natively supported filter = H5Z_FILTER_NBIT\n");
-	avail = H5Zfilter_avail(filt_id);
-	if (!avail) {
-	  printf ("\n\n ERROR - n-bit filter not available.\n");
-	  exit(EXIT_FAILURE);
-	}
-	break;
-      case H5Z_FILTER_SCALEOFFSET:
-	if (iverb>=1) printf("   natively supported filter = H5Z_FILTER_SCALEOFFSET\n");
-	avail = H5Zfilter_avail(filt_id);
-	if (!avail) {
-	  printf ("\n\n ERROR - scale-offset filter not available.\n");
-	  exit(EXIT_FAILURE);
-	}
-      default:
-#ifdef USE_BITSHUFFLE
-#ifdef USE_LZ4
-	if ( filt_id!=LZ4_FILTER && filt_id!=BSHUF_H5FILTER ) {
-	  printf("\n\n ERROR - unsupported filter Filter-%d : %s (%d)!\n",ifilt,filt_name,filt_id);
-	  printf("         supported filters are BITSHUFFLE (%d) and LZ4 (%d)\n\n",BSHUF_H5FILTER,LZ4_FILTER);
-	  exit(EXIT_FAILURE);
-	} else {
-          if (iverb>=1&&filt_id==LZ4_FILTER    ) {
-            printf("   supported filter = LZ4_FILTER\n");
-          }
-          else if (iverb>=1&&filt_id==BSHUF_H5FILTER) {
-            printf("   supported filter = BSHUF_H5FILTER\n");
-          }
-          else {
-            printf("   unsupported filter = %d\n",filt_id);
-          }
-        }
-#else
-	if ( filt_id!=BSHUF_H5FILTER ) {
-	  printf("\n\n ERROR - unsupported filter Filter-%d : %s (%d)!\n",ifilt,filt_name,filt_id);
-	  printf("         supported filter is BITSHUFFLE (%d)\n",BSHUF_H5FILTER);
-	  exit(EXIT_FAILURE);
-	} else {
-          if (iverb>=1&&filt_id==BSHUF_H5FILTER) {
-            printf("   supported filter = BSHUF_H5FILTER\n");
-          }
-          else {
-            printf("   unsupported filter = %d\n",filt_id);
-          }
-        }
-#endif
-#else
-#ifdef USE_LZ4
-	if ( filt_id!=LZ4_FILTER ) {
-	  printf("\n\n ERROR - unsupported filter Filter-%d : %s (%d)!\n",ifilt,filt_name,filt_id);
-	  printf("         supported filter is LZ4 (%d)\n",LZ4_FILTER);
-	  exit(EXIT_FAILURE);
-	} else {
-          if (iverb>=1&&filt_id==LZ4_FILTER    ) {
-            printf("   supported filter = LZ4_FILTER\n");
-          }
-          else {
-            printf("   unsupported filter = %d\n",filt_id);
-          }
-        }
-#endif
-#endif
-      }
-    }
-    return(1);
-}
-
@@ -15,11 +15,84 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
 
 #include "image_headers.h"
+#include "libimginfo.h"
 
+#define CHUNK 16384
+
+#ifdef NaN
+#define INIT_FLOAT  NaN
+#ifdef NaN64
+#define INIT_DOUBLE NaN64
+#else
+#define INIT_DOUBLE NaN
+#endif
+#else
+#define INIT_FLOAT  0.0
+#define INIT_DOUBLE 0.0
+#endif
+#define INIT_INT    INT_MIN
+
+#define CHAR_ARRAY_LEN 128
+
+// number of external files kept open per master file
+#define ELINK_FILE_CACHE_SIZE 128
+
+// -h5check without -h5jobs: up to H5JOBS_MAX worker processes (no more
+// than there are CPUs), and only one for every H5JOBS_LINKS external
+// files - fewer are checked in-process, where forking would cost more
+// than it saves
+#define H5JOBS_MAX    8
+#define H5JOBS_LINKS 16
+
+// images that can be given with a file (x_master.h5,1-3600:100)
+#define IMAGE_SPEC_MAX 1000000
+
+// default -h5mem threshold: master files up to this size (MB) are read
+// into memory
+#define H5MEM_DEFAULT_MB 64
+
+// https://en.wikipedia.org/wiki/Machine_epsilon#Values_for_standard_hardware_floating_point_arithmetics
+#define EPSILON32 1.19e-07
+#define EPSILON64 2.22e-16
+
+/* output formats */
+#define OUTPUT_TEXT       0
+#define OUTPUT_NDJSON     1
+#define OUTPUT_IMAGES     2 /* -per-image     */
+#define OUTPUT_IMAGES_RAW 3 /* -per-image-raw */
+#define OUTPUT_FRAMES     4 /* -frames        */
+#define OUTPUT_MANIFEST   5 /* -manifest      */
+
+/* one <file-N> argument together with the options in effect for it */
+typedef struct imginfo_job_s {
+  string path;
+  int imgnum;
+  int iverb;
+  int idet;
+  int inorm;
+  int h5check;
+  int h5jobs;     /* -h5check worker processes           */
+  string cache;   /* header cache file (empty = no cache) */
+  string h5resume;/* -h5check state file (empty = none)   */
+  long   h5mem;   /* -h5mem threshold in bytes (0 = off)  */
+  int output;     /* OUTPUT_TEXT, OUTPUT_NDJSON, ...      */
+  int imglast;    /* -frames: last image (0 = all)        */
+  int frame_threads; /* -frames: decode threads           */
+  int verify;     /* -verify (implies -h5check)           */
+  string manifest;/* -manifest file (implies -h5check)    */
+  int hashes;     /* IMGINFO_HASH_* for the manifest      */
+  int timings;    /* -timings                             */
+  int sweep_summary; /* -sweep-summary                    */
+} imginfo_job;
+
+#include <pthread.h>
 #include <string>
 #include <map>
+#include <deque>
+#include <algorithm>
 #include <vector>
 #include <iostream>
 using std::string;
@@ -28,27 +101,542 @@ using std::vector;
 using std::cout;
 using std::endl;
 
+/* one imginfo_read call: its options and where its report goes */
+/* what get_header_eiger and the hdf5_read_* helpers hand back lives
+   in the arena of the file handle until the image has been read, and is
+   then released in one step (keeping the first block for the next
+   image) */
+#define ARENA_BLOCK 65536
+
+typedef struct arena_block_s {
+  char*  p;
+  size_t size;
+} arena_block;
+
+typedef struct imginfo_arena_s {
+  vector<arena_block> blocks;
+  size_t used;     /* of the last block                            */
+} imginfo_arena;
+
+void*     arena_alloc      (imginfo_arena* a, size_t n);
+void*     arena_calloc     (imginfo_arena* a, size_t n, size_t size);
+char*     arena_strdup     (imginfo_arena* a, const char* s);
+void      arena_reset      (imginfo_arena* a);
+void      arena_free       (imginfo_arena* a);
+
+typedef struct imginfo_ctx_s {
+  int iverb;
+  int h5check;
+  int h5jobs;
+  string h5resume;
+  long   h5mem;
+  int    sweep_summary;
+  imginfo_image_fn per_image;
+  void* per_image_arg;
+  int fatal;       /* the imginfo program would have stopped here */
+  imginfo_result* res;
+  imginfo_file* file; /* file handle the call was made through      */
+  imginfo_arena* arena; /* its arena (NULL = plain malloc)          */
+  imginfo_timings* t; /* -timings (NULL = off) and the phase now     */
+  int    phase;
+  double phase_wall, phase_cpu, phase_nread;
+} imginfo_ctx;
+
+void      imginfo_log      (imginfo_ctx* ctx, int level, const char* fmt, ...) __attribute__((format(printf,3,4)));
+void      imginfo_log_text (imginfo_ctx* ctx, const string& report, const vector<imginfo_diag>& diags);
+void      imginfo_ctx_init (imginfo_ctx* ctx, imginfo_file* file, imginfo_result* res);
+int       imginfo_file_buffer(imginfo_file* file);
+
+void      timing_start     (imginfo_ctx* ctx, imginfo_timings* t);
+void      timing_phase     (imginfo_ctx* ctx, int phase);
+void      timing_count     (int call);
+double    timing_nread     (void);
+double    timing_cpu       (void);
+double    timing_wall      (void);
+
+/* --trace: spans held between flushes (one per file) */
+#define TRACE_EVENTS 65536
+
+/* --trace: a span from construction to destruction (nothing is recorded
+   unless imginfo_trace_open was called) - arg must stay valid until
+   then */
+struct trace_span {
+  double      t0;
+  const char* cat;
+  const char* name;
+  const char* arg;
+  trace_span(const char* cat, const char* name, const char* arg);
+  ~trace_span();
+};
+
+void      trace_record     (const char* cat, const char* name, const char* arg, double t0, double t1);
+void      trace_forked     (void);
+int       trace_tid        (void);
+void      trace_json_string(string& out, const char* s);
+
 char* strycpy(char* out, const char* in, int* nchars);
+vector<string> tokenise          (const char* line);
+vector<string> tokenise_cbf_header(const char* line);
+vector<string> tokenise_file_name (const char* line);
 
 void      empty_header(image_header* h);
 
 int       get_buffer(const char* path, char* buffer);
+int       get_file_image(const char* path, string& image);
+int       read_all(int fd, string& data);
+int       gunzip_image(const string& in, string& out);
+int       bunzip2_image(const string& in, string& out);
 
-int       get_header            (const char* buffer, image_header* h, const char* path, const int imgnum);
-int       get_header_eiger      (const char* path, const int imgnum, image_header* h);
+int       get_header            (imginfo_ctx* ctx, const char* buffer, image_header* h, const char* path, const int imgnum);
+int       get_header_eiger      (imginfo_ctx* ctx, const char* path, const int imgnum, image_header* h);
 
-format_t  get_format(const char* buffer);
+format_t  get_format(imginfo_ctx* ctx, const char* buffer);
 
 int       is_hdf5_eiger     (const char* buffer);
 
+int       register_filters (imginfo_ctx* ctx);
+
 void      print_header     (image_header* h, int i, int j);
 
-char*     hdf5_read_char           (hid_t fid, const char* item);
-int       hdf5_read_int            (hid_t fid, const char* item);
-int*      hdf5_read_nint           (hid_t fid, const char* item, int* n);
-double    hdf5_read_double         (hid_t fid, const char* item, const char* unit);
-double*   hdf5_read_ndouble        (hid_t fid, const char* item, const char* unit, int* n);
-double*   hdf5_read_axis_vector    (hid_t fid, const char* item);
-char*     hdf5_read_group_attribute(hid_t fid, const char* item, const char* attribute);
-int       hdf5_read_dataset_size   (hid_t fid, const char* item);
-int       hdf5_list_filters        (hid_t plist);
+int       imginfo_main     (int argc, char* argv[]);
+int       parse_image_spec (const string& spec, vector<int>& images);
+imginfo_options job_options(const imginfo_job* job);
+imginfo_file* open_job_file(const imginfo_job* job);
+int       same_file        (const imginfo_job* a, const imginfo_job* b);
+int       process_file     (const imginfo_job* job, imginfo_file* file);
+int       process_file_images(const imginfo_job* job, imginfo_file* file);
+int       process_file_frames(const imginfo_job* job, imginfo_file* file);
+int       process_file_manifest(const imginfo_job* job, imginfo_file* file);
+int       check_manifest   (const string& manifest);
+char*     format_fixed     (char* p, double v, int width, int ndec);
+
+/* -per-image: the table being written */
+typedef struct image_table_s {
+  int    raw;
+  string buf;
+} image_table;
+
+int       image_table_rows (const imginfo_image* rows, int nrows, void* arg);
+
+/* header cache: identity and state of a file on disk */
+typedef struct file_stamp_s {
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  uint64_t mtime_sec;
+  uint64_t mtime_nsec;
+} file_stamp;
+
+void      get_file_stamp   (const char* path, file_stamp* s);
+int       cache_open       (const string& path);
+void      cache_close      ();
+int       cache_lookup     (const imginfo_job* job, image_header* h, string& text, vector<imginfo_diag>& diags);
+void      cache_store      (const imginfo_job* job, const file_stamp* master, const image_header* h, const string& text,
+                            const vector<imginfo_diag>& diags);
+
+/* -watch: report new master files in a directory */
+int       watch_directory  (const string& dir, const imginfo_job* opts, int njobs);
+int       watch_file_report(int itask, int status, const string& output, const string& result, void* arg);
+
+/* -scan: report all master files below a directory */
+#define SCAN_THREADS 16
+
+typedef struct scan_pool_s {
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;   /* dirs, found or done changed               */
+  std::deque<string> dirs; /* directories still to be read            */
+  int             nbusy;  /* threads reading a directory               */
+  int             done;   /* all directories read                      */
+  int             stop;   /* give up (reading a file failed)           */
+  vector<string>  found;  /* master files, in the order found          */
+  map<string,int> seen;   /* their real paths (a file can be found
+                             again through a symbolic link)           */
+  long            ndirs;
+  long            nentries;
+  long            nunreadable; /* directories that couldn't be read    */
+} scan_pool;
+
+int       scan_directory   (const string& dir, const imginfo_job* opts, int njobs);
+void*     scan_worker      (void* arg);
+long      scan_read_dir    (const string& dir, vector<string>& dirs, vector<string>& found);
+int       scan_is_master   (const char* name);
+
+/* resident server and its client */
+int       serve            (const char* path);
+int       client           (const char* path, int argc, char* argv[]);
+int       write_all        (int fd, const char* data, size_t n);
+int       serve_task       (int itask, int fd_result, void* arg);
+int       serve_report     (int itask, int status, const string& output, const string& result, void* arg);
+int       serve_answer     (int fd, int exit_status, const string& report, const string& errors);
+void      serve_connection (int fd);
+
+/* NDJSON output */
+void      json_string      (string& out, const string& s);
+void      json_double      (string& out, double v);
+void      json_key         (string& out, const char* key);
+void      json_add_string  (string& out, const char* key, const string& v);
+void      json_add_double  (string& out, const char* key, double v);
+void      json_add_int     (string& out, const char* key, long v);
+void      json_add_doubles (string& out, const char* key, const double* v, int n);
+double    header_oscillation(const image_header* h);
+void      print_header_ndjson(const imginfo_job* job, const image_header* h, const char* status, const vector<imginfo_diag>& diags,
+                             const imginfo_timings* t);
+void      json_add_timings (string& out, const imginfo_timings* t);
+void      print_timings    (const imginfo_timings* t);
+void      print_run_timings(const double* wall, const double* cpu);
+double    run_cpu          (void);
+long      peak_rss_kb      (void);
+
+/* batch of jobs handed out to worker processes (-j) */
+typedef struct file_tasks_s {
+  vector<imginfo_job>* jobs;
+  vector<size_t> first; /* first job of each task (and end of last) */
+  int nfil;
+} file_tasks;
+
+void      file_tasks_group (file_tasks* tasks, vector<imginfo_job>* jobs);
+int       process_file_task(int itask, int fd_result, void* arg);
+int       report_file_task (int itask, int status, const string& output, const string& result, void* arg);
+
+/* -per-image: where the per-image values of an axis come from */
+#define AXIS_OMEGA               0
+#define AXIS_KAPPA               1
+#define AXIS_CHI                 2
+#define AXIS_PHI                 3
+#define AXIS_TWO_THETA           4
+#define NAXIS                    5
+
+#define AXIS_END_DATASET         0 /* end angles in a dataset of their own */
+#define AXIS_END_START           1 /* end = start                          */
+#define AXIS_END_INC             2 /* end = start + increment              */
+
+typedef struct axis_source_s {
+  string start;    /* dataset with the start angles (empty = none) */
+  string end;      /* dataset with the end angles                  */
+  int    end_rule;
+  double inc;
+} axis_source;
+
+typedef struct hdf5_stream_s {
+  hid_t   did;
+  hid_t   sid;
+  hsize_t nid;
+  double  last;    /* padding beyond the stored values */
+} hdf5_stream;
+
+void      axis_source_set      (axis_source* a, const char* start, const char* end, int end_rule, double inc);
+int       hdf5_stream_open     (imginfo_ctx* ctx, hid_t fid, const string& item, hdf5_stream* st);
+void      hdf5_stream_read     (hdf5_stream* st, hsize_t first, hsize_t count, double* d);
+void      hdf5_stream_close    (hdf5_stream* st);
+int       eiger_per_image      (imginfo_ctx* ctx, hid_t fid, const axis_source* src, int first, int count,
+                                int nimages, int nimages_per_trigger, const int* nimage_to_imgnum);
+
+/* frame reading (imginfo_read_frames): how the chunks of a dataset are
+   stored */
+#define FRAME_CODEC_NONE         0 /* unfiltered: chunk = frame            */
+#define FRAME_CODEC_BSHUF        1 /* bitshuffle without compression       */
+#define FRAME_CODEC_BSHUF_LZ4    2 /* bitshuffle + LZ4 (as from Eiger)     */
+#define FRAME_CODEC_LZ4          3 /* HDF5 LZ4 filter                      */
+#define FRAME_CODEC_HDF5         4 /* read and decoded through H5Dread     */
+
+/* what happened to a frame in a decode thread */
+#define FRAME_OK                 0
+#define FRAME_FAILED             1 /* couldn't be decoded                  */
+#define FRAME_STOPPED            2 /* callback asked to stop               */
+
+typedef struct frame_slot_s {
+  vector<char> raw;  /* chunk as stored (kept between frames) */
+  size_t nraw;
+  int    imgn;
+  int    nx;
+  int    ny;
+  int    elem_size;
+  size_t block;      /* bitshuffle block size (0 = default)   */
+  int    codec;
+  int    isrc;       /* link in /entry/data it came from      */
+} frame_slot;
+
+typedef struct frame_pool_s {
+  pthread_mutex_t lock;
+  pthread_cond_t  filled; /* slot ready for decoding (or stop) */
+  pthread_cond_t  freed;  /* slot can be filled again          */
+  vector<frame_slot> slots;
+  std::deque<int> todo;   /* filled slots, in reading order    */
+  vector<int>     idle;   /* free slots                        */
+  int    stop;            /* no more frames coming             */
+  int    failed;          /* FRAME_FAILED or FRAME_STOPPED     */
+  string error;           /* why decoding failed               */
+  imginfo_frame_fn fn;
+  void*  arg;
+  long   nframes;
+  double nbytes;
+  int    verify;          /* carry on past bad frames          */
+  long   nbad;
+  int    bad_imgn;        /* first bad frame (0 = none)        */
+  int    bad_src;
+  string bad_error;
+  int    link_frames;     /* frames in the last dataset read   */
+} frame_pool;
+
+double    frame_clock          (void);
+uint64_t  frame_be64           (const char* p);
+uint32_t  frame_be32           (const char* p);
+int       frame_codec          (hid_t dcpl, size_t elem_size, size_t* block);
+int       frame_decode         (const frame_slot* s, char* out, size_t nbytes, string& error);
+void*     frame_worker         (void* arg);
+void      frame_bad            (frame_pool* p, int imgn, int isrc, const string& error);
+int       frame_slot_get       (frame_pool* p);
+void      frame_slot_put       (frame_pool* p, int islot, int filled);
+int       frame_read_dataset   (imginfo_ctx* ctx, hid_t fid, const string& item, int isrc, int* imgn, int first, int last,
+                                frame_pool* p, imginfo_frame_stats* stats);
+
+/* hashing (imginfo_hash_files) */
+#define HASH_BLOCK (8*1024*1024) /* bytes read at a time */
+
+typedef struct xxh64_state_s {
+  uint64_t v[4];
+  uint64_t total;
+  unsigned char mem[32];  /* partial stripe */
+  size_t   nmem;
+} xxh64_state;
+
+typedef struct sha256_state_s {
+  uint32_t h[8];
+  uint64_t total;
+  unsigned char mem[64];  /* partial block  */
+  size_t   nmem;
+} sha256_state;
+
+typedef struct hash_pool_s {
+  pthread_mutex_t lock;
+  vector<imginfo_hash>* files;
+  int    which;           /* IMGINFO_HASH_* */
+  size_t next;            /* next file to take */
+} hash_pool;
+
+uint64_t  xxh_rotl             (uint64_t x, int r);
+uint64_t  xxh_read64           (const unsigned char* p);
+uint32_t  xxh_read32           (const unsigned char* p);
+uint64_t  xxh_round            (uint64_t acc, uint64_t input);
+uint64_t  xxh_merge            (uint64_t acc, uint64_t val);
+void      xxh64_init           (xxh64_state* s);
+void      xxh64_update         (xxh64_state* s, const void* data, size_t len);
+uint64_t  xxh64_digest         (const xxh64_state* s);
+uint32_t  sha_rotr             (uint32_t x, int r);
+void      sha256_block         (sha256_state* s, const unsigned char* p);
+void      sha256_init          (sha256_state* s);
+void      sha256_update        (sha256_state* s, const void* data, size_t len);
+void      sha256_digest        (sha256_state* s, unsigned char out[32]);
+void      hash_file            (imginfo_hash* f, int which, vector<char>& buf);
+void*     hash_worker          (void* arg);
+
+/* h5check: one external link in /entry/data and what we found in it */
+#define H5CHECK_LINK_OK          0
+#define H5CHECK_LINK_NO_FILE     1
+#define H5CHECK_LINK_NO_DATASET  2
+#define H5CHECK_LINK_FATAL       3 /* e.g. unsupported filter */
+
+#define H5CHECK_NR_NONE          0 /* no image_nr_high: count dataset dimensions */
+#define H5CHECK_NR_READ          1 /* image_nr_low/image_nr_high read            */
+#define H5CHECK_NR_FAILED        2 /* attributes present but unreadable          */
+
+/* ranges of frames without data kept per external file (see h5check_chunks) */
+#define H5CHECK_GAPS             8
+
+typedef struct h5check_result_s {
+  int status;
+  int image_nr;
+  int image_nr_low;
+  int image_nr_high;
+  unsigned long long dims0;
+  unsigned long long nmissing; /* frames with no chunk written          */
+  int ngaps;                   /* ranges of such frames                 */
+  unsigned long long gap[H5CHECK_GAPS][2]; /* first/last frame (from 0) */
+  unsigned long long gap_last; /* last frame of the last range         */
+} h5check_result;
+
+typedef struct h5_link_s {
+  string name;     /* link name within /entry/data      */
+  int    type;     /* H5L_type_t                        */
+  string filename; /* target file (external links only) */
+  string path;     /* target dataset                    */
+} h5_link;
+
+typedef struct h5_census_s {
+  imginfo_ctx* ctx;
+  vector<h5_link> links;
+} h5_census;
+
+typedef struct h5check_link_s {
+  string link;     /* full path of link in master file  */
+  string dir;      /* directory of master file          */
+  string filename; /* external file as given in link    */
+  string file;     /* full path of external file        */
+  string path;     /* dataset within external file      */
+  file_stamp stamp;/* external file when it was checked */
+  h5check_result r;
+} h5check_link;
+
+/* what to do after checking the links */
+#define H5CHECK_CONTINUE         0
+#define H5CHECK_BREAK            1 /* external file missing: stop checking  */
+#define H5CHECK_RETURN           2 /* dataset missing: give up on this file */
+#define H5CHECK_EXIT             3 /* fatal (e.g. unsupported filter)       */
+
+typedef struct h5check_state_s {
+  imginfo_ctx* ctx;
+  hid_t fid;       /* master file (serial checks only)  */
+  vector<h5check_link>* links;
+  int* nimage_to_imgnum;
+  int  nimages;
+  int  nimages_found;
+  int  have_image_nr_high;
+  int  action;
+  int  first;      /* links before this one known from -h5resume  */
+  int  nverified;  /* leading links found complete and consistent */
+  unsigned long long nmissing; /* images not written (all links)   */
+} h5check_state;
+
+herr_t    h5check_census_link  (hid_t gid, const char* name, const H5L_info_t* info, void* op_data);
+void      h5check_external_link(imginfo_ctx* ctx, hid_t fid, const h5check_link* l, int list_filters, h5check_result* r);
+void      h5check_chunks       (hid_t did, h5check_result* r);
+void      h5check_add_gap      (h5check_result* r, unsigned long long first, unsigned long long last);
+void      h5check_print_gaps   (imginfo_ctx* ctx, const h5check_link* l, unsigned long long imgnum0);
+int       h5check_merge_link   (h5check_state* hc, int ilink);
+void      h5check_print_link   (imginfo_ctx* ctx, const h5check_link* l, int ilink);
+int       h5check_link_task    (int itask, int fd_result, void* arg);
+void      h5check_put_string   (string& buf, const string& s);
+int       h5check_get_string   (const char** p, const char* end, string& s);
+int       h5check_link_report  (int itask, int status, const string& output, const string& result, void* arg);
+void      h5check_links        (h5check_state* hc, int nworker);
+
+/* -h5resume: what earlier runs found in the external files of a master file */
+typedef struct h5resume_link_s {
+  string link;
+  file_stamp stamp;
+  h5check_result r;
+} h5resume_link;
+
+typedef struct h5resume_entry_s {
+  file_stamp master;
+  vector<h5resume_link> links;
+} h5resume_entry;
+
+void      h5resume_read        (int fd, map<string,h5resume_entry>& entries);
+int       h5resume_load        (imginfo_ctx* ctx, const string& file, const char* master, vector<h5check_link>* links);
+void      h5resume_save        (imginfo_ctx* ctx, const string& file, const char* master, const vector<h5check_link>* links, int nverified);
+
+int       run_workers      (int ntask, int nworker,
+                            int (*task)(int itask, int fd_result, void* arg),
+                            int (*report)(int itask, int status, const string& output, const string& result, void* arg),
+                            void* arg);
+
+/* imginfo_file: what was read from a file for one image and can be
+   reused for the next one */
+typedef struct hdf5_memo_s {
+  int    done;
+  int    isnull;   /* NULL returned                                */
+  int    i;
+  double d;
+  string s;
+  vector<int>    iv;
+  vector<double> dv;
+  size_t report0;  /* report and diags before the read             */
+  size_t diags0;
+  string report;   /* reported during the read                     */
+  vector<imginfo_diag> diags;
+} hdf5_memo;
+
+/* hdf5_read_ndouble_sel_h5 reads the whole dataset instead of a point
+   selection for more than HDF5_SEL_MAX_POINTS points that make up more
+   than 1/HDF5_SEL_MAX_FRACTION of it */
+#define HDF5_SEL_MAX_POINTS     64
+#define HDF5_SEL_MAX_FRACTION   16
+
+#define HDF5_ARRAY_UNREAD        0
+#define HDF5_ARRAY_MISSING       1 /* dataset doesn't exist             */
+#define HDF5_ARRAY_NO_OPEN       2 /* dataset can't be opened           */
+#define HDF5_ARRAY_NO_READ       3 /* dataset can't be read             */
+#define HDF5_ARRAY_READ          4
+
+typedef struct hdf5_array_s {
+  int    state;
+  int    image;    /* 1 + image it was read for (through a selection) */
+  hssize_t nid;
+  int    rank;
+  vector<double> v;
+} hdf5_array;
+
+typedef struct h5check_memo_s {
+  int    done;
+  int    nimages;  /* as returned by eiger_h5check                 */
+  vector<int> nimage_to_imgnum;
+  map<string,int> nframes; /* frames found behind each link         */
+  vector<string> extf;
+  vector<image_filter> filt;
+  INT32  nmis;
+  string report;
+  vector<imginfo_diag> diags;
+} h5check_memo;
+
+struct imginfo_file_s {
+  string path;
+  imginfo_options opt;
+  int    nread;    /* images read so far                           */
+  int    buflen;   /* 0 = not read yet                             */
+  char   buffer[CHUNK+1];
+  hid_t  fid;      /* master file (-1 = not open)                  */
+  hid_t  lapl;     /* link, dataset and group access for it (when  */
+  hid_t  dapl;     /* held in memory: -1 = default)                */
+  hid_t  gapl;
+  string image;    /* decompressed master file (or stdin) until    */
+                   /* opened from memory                           */
+  map<string,int>        links;  /* link exists (1) or not (0)  */
+  map<string,hid_t>      groups; /* open groups (-1 = none)     */
+  map<string,hdf5_memo>  memo;
+  map<string,hdf5_array> arrays;
+  h5check_memo check;
+  imginfo_arena arena;
+};
+
+int       hdf5_exists              (imginfo_ctx* ctx, hid_t fid, const char* item);
+hid_t     hdf5_group               (imginfo_ctx* ctx, hid_t fid, const string& path);
+hid_t     hdf5_loc                 (imginfo_ctx* ctx, hid_t fid, const char* item, string& name);
+hid_t     hdf5_open_dataset        (imginfo_ctx* ctx, hid_t fid, const char* item);
+hid_t     hdf5_open_group          (imginfo_ctx* ctx, hid_t fid, const char* item);
+hdf5_memo* hdf5_memo_get           (imginfo_ctx* ctx, hid_t fid, const string& key);
+void      hdf5_memo_keep           (imginfo_ctx* ctx, hdf5_memo* m);
+void      hdf5_memo_replay         (imginfo_ctx* ctx, const hdf5_memo* m);
+void      hdf5_array_load          (imginfo_ctx* ctx, hid_t fid, const char* item, hdf5_array* a);
+double*   hdf5_array_sel           (imginfo_ctx* ctx, const hdf5_array* a, const char* item, int n, const int* idx, int nidx);
+void      hdf5_sel_positions       (const int* idx, int nidx, hssize_t nid, vector<hsize_t>& pos, vector<hsize_t>& upos);
+int       eiger_h5check            (imginfo_ctx* ctx, hid_t fid, const char* path, const char* dir,
+                                    int nimages, int* nimage_to_imgnum, image_header* h);
+int       eiger_h5check_file       (imginfo_ctx* ctx, hid_t fid, const char* path, const char* dir,
+                                    int nimages, int* nimage_to_imgnum, image_header* h);
+void      eiger_close              (imginfo_ctx* ctx, hid_t fid);
+hid_t     eiger_open               (imginfo_ctx* ctx, const char* path);
+void      eiger_elink_apl          (imginfo_file* file);
+hid_t     hdf5_apl                 (imginfo_ctx* ctx, hid_t fid, hid_t cls);
+
+char*     hdf5_read_char           (imginfo_ctx* ctx, hid_t fid, const char* item);
+int       hdf5_read_int            (imginfo_ctx* ctx, hid_t fid, const char* item);
+int*      hdf5_read_nint           (imginfo_ctx* ctx, hid_t fid, const char* item, int* n);
+double    hdf5_read_double         (imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit);
+double*   hdf5_read_ndouble        (imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit, int* n);
+double*   hdf5_read_ndouble_sel    (imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit, int n, const int* idx, int nidx);
+double*   hdf5_read_axis_vector    (imginfo_ctx* ctx, hid_t fid, const char* item);
+char*     hdf5_read_group_attribute(imginfo_ctx* ctx, hid_t fid, const char* item, const char* attribute);
+int       hdf5_read_dataset_size   (imginfo_ctx* ctx, hid_t fid, const char* item);
+int       hdf5_list_filters        (imginfo_ctx* ctx, hid_t plist);
+void      hdf5_get_filters         (hid_t plist, vector<image_filter>& filters);
+
+/* the reads themselves (hdf5_read_* remember their results per file) */
+char*     hdf5_read_char_h5           (imginfo_ctx* ctx, hid_t fid, const char* item);
+int       hdf5_read_int_h5            (imginfo_ctx* ctx, hid_t fid, const char* item);
+int*      hdf5_read_nint_h5           (imginfo_ctx* ctx, hid_t fid, const char* item, int* n);
+double    hdf5_read_double_h5         (imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit);
+double*   hdf5_read_ndouble_sel_h5    (imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit, int n, const int* idx, int nidx);
+double*   hdf5_read_axis_vector_h5    (imginfo_ctx* ctx, hid_t fid, const char* item);
+char*     hdf5_read_group_attribute_h5(imginfo_ctx* ctx, hid_t fid, const char* item, const char* attribute);
+int       hdf5_read_dataset_size_h5   (imginfo_ctx* ctx, hid_t fid, const char* item);
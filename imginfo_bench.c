@@ -0,0 +1,690 @@
+//     **********************************************************************
+//
+//      Copyright (c) 2017, 2024 Global Phasing Ltd.
+//
+//      This Source Code Form is subject to the terms of the Mozilla Public
+//      License, v. 2.0. If a copy of the MPL was not distributed with this
+//      file, you can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//      Authors: Clemens Vonrhein, Claus Flensburg, Thomas Womack and Gerard Bricogne
+//
+//     **********************************************************************
+
+// imginfo_bench: write synthetic Eiger/NXmx master files (and their
+// external-link data files) and time libimginfo on them - header
+// extraction, single-image queries and -h5check. Runs without any real
+// data, so "make bench" can be used to catch performance regressions.
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#include "hdf5.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef USE_BITSHUFFLE
+#include "bshuf_h5filter.h"
+#include "bitshuffle.h"
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#include "libimginfo.h"
+
+/* layout flavours of the master file */
+#define BENCH_DECTRIS     0 /* detectorSpecific, /entry/sample/goniometer             */
+#define BENCH_DIAMOND     1 /* /entry/data/omega (axes="omega"), module/data_size       */
+#define BENCH_GONOMEGA    2 /* /entry/data/gonomega (axes="gonomega"), detectorSpecific */
+#define BENCH_SAMPLE_PHI  3 /* as Diamond, plus /entry/sample/sample_{phi,kappa,chi}    */
+#define BENCH_NFLAVOURS   4
+
+const char* bench_flavour_name[BENCH_NFLAVOURS] = { "dectris", "diamond", "gonomega", "sample_phi" };
+
+typedef struct bench_params_s {
+  int flavour;
+  int nimages;     /* images per trigger                        */
+  int ntrigger;
+  int nperfile;    /* images per data file (= links)            */
+  int numx;        /* detector size as given in the master file */
+  int numy;
+  int framex;      /* size of the frames in the data files      */
+  int framey;
+  int runs;        /* repeats of each timing                    */
+  int queries;     /* single-image queries                      */
+} bench_params;
+
+double bench_clock(void);
+hid_t  bench_group(hid_t loc, const char* name);
+void   bench_string(hid_t loc, const char* name, const char* value);
+void   bench_string_attribute(hid_t loc, const char* name, const char* value);
+void   bench_double(hid_t loc, const char* name, double value, const char* units);
+void   bench_int(hid_t loc, const char* name, int value);
+void   bench_int_attribute(hid_t loc, const char* name, int value);
+void   bench_array(hid_t loc, const char* name, const double* v, hsize_t n, const char* units);
+void   bench_axis(hid_t loc, const char* name, double x, double y, double z);
+void   bench_frame_chunk(const bench_params* bp, string& chunk, int* filtered);
+int    bench_data_file(const bench_params* bp, const char* path, int first, int nframes, const string& chunk, int filtered);
+int    bench_generate(const bench_params* bp, const char* dir, const char* name);
+void   bench_time(const char* label, const char* master, int nimg, int single, const imginfo_options* opt, const bench_params* bp);
+void   bench_time_file(const char* label, const char* master, int nimg, const imginfo_options* opt, const bench_params* bp);
+int    bench_check(const char* master, const imginfo_options* opt, int nimg);
+int    bench_corrupt(const bench_params* bp, const char* dir);
+void   bench_remove(const char* dir);
+void   bench_usage(void);
+
+double bench_clock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// ==================================================================================================
+// writing HDF5 items
+// ==================================================================================================
+hid_t bench_group(hid_t loc, const char* name)
+{
+  return H5Gcreate2(loc, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+}
+
+void bench_string(hid_t loc, const char* name, const char* value)
+{
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, strlen(value)+1);
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t did = H5Dcreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite(did, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, value);
+  H5Dclose(did);
+  H5Sclose(space);
+  H5Tclose(type);
+}
+
+void bench_string_attribute(hid_t loc, const char* name, const char* value)
+{
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, strlen(value));
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t aid = H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(aid, type, value);
+  H5Aclose(aid);
+  H5Sclose(space);
+  H5Tclose(type);
+}
+
+void bench_double(hid_t loc, const char* name, double value, const char* units)
+{
+  bench_array(loc, name, &value, 0, units);
+}
+
+void bench_int(hid_t loc, const char* name, int value)
+{
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t did = H5Dcreate2(loc, name, H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &value);
+  H5Dclose(did);
+  H5Sclose(space);
+}
+
+void bench_int_attribute(hid_t loc, const char* name, int value)
+{
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t aid = H5Acreate2(loc, name, H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(aid, H5T_NATIVE_INT, &value);
+  H5Aclose(aid);
+  H5Sclose(space);
+}
+
+// n = 0: scalar
+void bench_array(hid_t loc, const char* name, const double* v, hsize_t n, const char* units)
+{
+  hid_t space = (n==0) ? H5Screate(H5S_SCALAR) : H5Screate_simple(1, &n, NULL);
+  hid_t did = H5Dcreate2(loc, name, H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, v);
+  if (units!=NULL) bench_string_attribute(did, "units", units);
+  H5Dclose(did);
+  H5Sclose(space);
+}
+
+// rotation axis definition (NXtransformations) - as a scalar dataset
+// carrying the "vector" attribute
+void bench_axis(hid_t loc, const char* name, double x, double y, double z)
+{
+  bench_double(loc, name, 0.0, "deg");
+  hid_t did = H5Dopen2(loc, name, H5P_DEFAULT);
+  double vector[3] = { x, y, z };
+  hsize_t three = 3;
+  hid_t space = H5Screate_simple(1, &three, NULL);
+  hid_t aid = H5Acreate2(did, "vector", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(aid, H5T_NATIVE_DOUBLE, vector);
+  H5Aclose(aid);
+  H5Sclose(space);
+  bench_string_attribute(did, "transformation_type", "rotation");
+  H5Dclose(did);
+}
+
+// ==================================================================================================
+// synthetic data
+//   every frame is the same chunk - compressed once (bitshuffle/LZ4 as
+//   written by the detector) and then written with H5Dwrite_chunk, so
+//   even a million images take seconds. The frames are much smaller
+//   than the detector given in the master file (-frame), which nothing
+//   in header extraction or -h5check looks at.
+// ==================================================================================================
+void bench_frame_chunk(const bench_params* bp, string& chunk, int* filtered)
+{
+  size_t nelem = (size_t) bp->framex*bp->framey;
+  vector<unsigned int> frame(nelem);
+  // mostly low counts with some Bragg-like peaks
+  for (size_t i = 0; i < nelem; i++) {
+    frame[i] = (i*7)%5 + ((i%997==0) ? 1000 : 0);
+  }
+  *filtered = 0;
+#if defined(USE_BITSHUFFLE)
+  size_t elem_size = sizeof(unsigned int);
+  size_t block = bshuf_default_block_size(elem_size);
+  vector<char> out(12 + bshuf_compress_lz4_bound(nelem, elem_size, block));
+  int64_t n = bshuf_compress_lz4(&frame[0], &out[12], nelem, elem_size, block);
+  if (n>0) {
+    // uncompressed size (8 bytes) and block size in bytes (4 bytes), big-endian
+    unsigned long long nbytes = nelem*elem_size;
+    for (int i = 0; i < 8; i++) out[i]   = (char) (nbytes >> (8*(7-i)));
+    for (int i = 0; i < 4; i++) out[8+i] = (char) ((block*elem_size) >> (8*(3-i)));
+    chunk.assign(&out[0], 12 + n);
+    *filtered = 1;
+    return;
+  }
+#endif
+  chunk.assign((const char*) &frame[0], nelem*sizeof(unsigned int));
+}
+
+int bench_data_file(const bench_params* bp, const char* path, int first, int nframes, const string& chunk, int filtered)
+{
+  hid_t fid = H5Fcreate(path, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (fid<0) return 0;
+  hid_t gid1 = bench_group(fid, "entry");
+  hid_t gid2 = bench_group(gid1, "data");
+  hsize_t dims[3]  = { (hsize_t) nframes, (hsize_t) bp->framey, (hsize_t) bp->framex };
+  hsize_t cdims[3] = { 1, (hsize_t) bp->framey, (hsize_t) bp->framex };
+  hid_t space = H5Screate_simple(3, dims, NULL);
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl, 3, cdims);
+#if defined(USE_BITSHUFFLE)
+  if (filtered) {
+    unsigned int cd[2] = { 0, BSHUF_H5_COMPRESS_LZ4 };
+    H5Pset_filter(dcpl, BSHUF_H5FILTER, H5Z_FLAG_OPTIONAL, 2, cd);
+  }
+#endif
+  hid_t did = H5Dcreate2(gid2, "data", H5T_NATIVE_UINT, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+  int ok = (did>=0);
+  for (int iframe = 0; ok && iframe < nframes; iframe++) {
+    hsize_t offset[3] = { (hsize_t) iframe, 0, 0 };
+    ok = (H5Dwrite_chunk(did, H5P_DEFAULT, 0, offset, chunk.size(), chunk.data())>=0);
+  }
+  // Dectris data files say which images they hold, the others are
+  // counted from the dataset dimensions
+  if (ok && bp->flavour==BENCH_DECTRIS) {
+    bench_int_attribute(did, "image_nr_low",  first);
+    bench_int_attribute(did, "image_nr_high", first + nframes - 1);
+  }
+  if (did>=0) H5Dclose(did);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+  H5Gclose(gid2);
+  H5Gclose(gid1);
+  if (H5Fclose(fid)<0) ok = 0;
+  return ok;
+}
+
+// <dir>/<name>_master.h5 and <dir>/<name>_data_NNNNNN.h5
+int bench_generate(const bench_params* bp, const char* dir, const char* name)
+{
+  int ntotal = bp->nimages*bp->ntrigger;
+  char path[2*PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%s_master.h5", dir, name);
+  hid_t fid = H5Fcreate(path, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (fid<0) {
+    printf("\n ERROR: unable to create %s!\n\n",path);
+    return 0;
+  }
+
+  hid_t entry = bench_group(fid, "entry");
+  bench_string_attribute(entry, "NX_class", "NXentry");
+  bench_string(entry, "definition", "NXmx");
+  hid_t instrument = bench_group(entry, "instrument");
+  hid_t beam       = bench_group(instrument, "beam");
+  hid_t detector   = bench_group(instrument, "detector");
+  bench_double(beam, "incident_wavelength", 0.9762, "angstrom");
+  bench_string(detector, "description", "Dectris EIGER2 Si 16M");
+  bench_string(detector, "detector_number", "E-32-0123");
+  bench_string(detector, "sensor_material", "Si");
+  bench_double(detector, "sensor_thickness", 0.00045, "m");
+  bench_double(detector, "x_pixel_size", 75e-6, "m");
+  bench_double(detector, "y_pixel_size", 75e-6, "m");
+  bench_double(detector, "beam_center_x", 0.5*bp->numx + 12.5, "pixel");
+  bench_double(detector, "beam_center_y", 0.5*bp->numy - 20.25, "pixel");
+  bench_double(detector, "detector_distance", 0.2, "m");
+  bench_double(detector, "count_time", 0.00999, "s");
+  bench_double(detector, "frame_time", 0.01, "s");
+  bench_int(detector, "saturation_value", 65535);
+
+  // the sweeps: one per trigger, 0.1 degree per image
+  vector<double> start(ntotal), end(ntotal), zero(ntotal, 0.0);
+  for (int itrigger = 0; itrigger < bp->ntrigger; itrigger++) {
+    for (int iimage = 0; iimage < bp->nimages; iimage++) {
+      int i = itrigger*bp->nimages + iimage;
+      start[i] = fmod(10.0 + 45.0*itrigger, 360.0) + 0.1*iimage;
+      end[i]   = start[i] + 0.1;
+    }
+  }
+
+  hid_t sample = bench_group(entry, "sample");
+  hid_t data   = bench_group(entry, "data");
+  bench_string_attribute(data, "NX_class", "NXdata");
+  // Diamond files with gonomega (I04-1) still come with detectorSpecific
+  if (bp->flavour==BENCH_DECTRIS || bp->flavour==BENCH_GONOMEGA) {
+    hid_t specific = bench_group(detector, "detectorSpecific");
+    bench_int(specific, "nimages", bp->nimages);
+    bench_int(specific, "ntrigger", bp->ntrigger);
+    bench_int(specific, "x_pixels_in_detector", bp->numx);
+    bench_int(specific, "y_pixels_in_detector", bp->numy);
+    bench_string(specific, "data_collection_date", "2024-03-01T12:34:56.789");
+    bench_string(specific, "eiger_fw_version", "release-2022.1.2");
+    bench_int(specific, "countrate_correction_count_cutoff", 65535);
+    H5Gclose(specific);
+  }
+  if (bp->flavour==BENCH_DECTRIS) {
+
+    hid_t goniometer = bench_group(sample, "goniometer");
+    bench_array(goniometer, "omega", &start[0], ntotal, "degree");
+    bench_array(goniometer, "omega_end", &end[0], ntotal, "degree");
+    bench_double(goniometer, "omega_range_average", 0.1, "degree");
+    bench_double(goniometer, "omega_range_total", 0.1*bp->nimages, "degree");
+    bench_double(goniometer, "omega_increment", 0.1, "degree");
+    bench_array(goniometer, "kappa", &zero[0], ntotal, "degree");
+    bench_array(goniometer, "kappa_end", &zero[0], ntotal, "degree");
+    bench_array(goniometer, "chi", &zero[0], ntotal, "degree");
+    bench_array(goniometer, "chi_end", &zero[0], ntotal, "degree");
+    bench_array(goniometer, "phi", &zero[0], ntotal, "degree");
+    bench_array(goniometer, "phi_end", &zero[0], ntotal, "degree");
+    bench_double(goniometer, "phi_increment", 0.0, "degree");
+    H5Gclose(goniometer);
+  } else {
+    hid_t module = bench_group(detector, "module");
+    int data_size[2] = { bp->numy, bp->numx };
+    hsize_t two = 2;
+    hid_t space = H5Screate_simple(1, &two, NULL);
+    hid_t did = H5Dcreate2(module, "data_size", H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_size);
+    H5Dclose(did);
+    H5Sclose(space);
+    H5Gclose(module);
+    bench_string(entry, "start_time", "2024-03-01T12:34:56.789");
+
+    const char* omega = (bp->flavour==BENCH_GONOMEGA) ? "gonomega" : "omega";
+    bench_string_attribute(data, "axes", omega);
+    bench_array(data, omega, &start[0], ntotal, "deg");
+    hid_t transformations = bench_group(sample, "transformations");
+    bench_axis(transformations, omega, -1.0, 0.0, 0.0);
+    bench_axis(transformations, "kappa", -0.914, 0.279, -0.297);
+    bench_axis(transformations, "chi", 0.0, 0.0, -1.0);
+    bench_axis(transformations, "phi", -1.0, 0.0, 0.0);
+    H5Gclose(transformations);
+
+    if (bp->flavour==BENCH_SAMPLE_PHI) {
+      hid_t gid = bench_group(sample, "sample_phi");
+      bench_double(gid, "phi", 30.0, "deg");
+      H5Gclose(gid);
+      gid = bench_group(sample, "sample_kappa");
+      bench_double(gid, "kappa", 0.0, "deg");
+      H5Gclose(gid);
+      gid = bench_group(sample, "sample_chi");
+      bench_double(gid, "chi", 0.0, "deg");
+      H5Gclose(gid);
+    }
+  }
+
+  string chunk;
+  int filtered;
+  bench_frame_chunk(bp, chunk, &filtered);
+  int ok = 1;
+  int nfiles = (ntotal + bp->nperfile - 1)/bp->nperfile;
+  for (int ifile = 0; ok && ifile < nfiles; ifile++) {
+    char link[64], file[128];
+    snprintf(link, sizeof(link), "data_%06d", ifile+1);
+    snprintf(file, sizeof(file), "%s_data_%06d.h5", name, ifile+1);
+    H5Lcreate_external(file, "/entry/data/data", data, link, H5P_DEFAULT, H5P_DEFAULT);
+    int first   = ifile*bp->nperfile + 1;
+    int nframes = (ntotal - first + 1 < bp->nperfile) ? ntotal - first + 1 : bp->nperfile;
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+    if (!bench_data_file(bp, path, first, nframes, chunk, filtered)) {
+      printf("\n ERROR: unable to write %s!\n\n",path);
+      ok = 0;
+    }
+  }
+
+  H5Gclose(data);
+  H5Gclose(sample);
+  H5Gclose(detector);
+  H5Gclose(beam);
+  H5Gclose(instrument);
+  H5Gclose(entry);
+  if (H5Fclose(fid)<0) ok = 0;
+  return ok;
+}
+
+// ==================================================================================================
+// timings
+//   each one repeated bp->runs times, giving mean and best - HDF5 keeps
+//   nothing open between imginfo_read calls, but the operating system
+//   will have the files in its page cache after the first run.
+// ==================================================================================================
+int bench_check(const char* master, const imginfo_options* opt, int nimg)
+{
+  imginfo_result res;
+  int status = imginfo_read(master, 0, opt, &res);
+  if (status!=IMGINFO_OK || res.h.nimg!=nimg) {
+    printf("\n ERROR: %s read with status %d and %d images (expected %d)!\n\n",master,status,res.h.nimg,nimg);
+    printf("%s",res.report.c_str());
+    return 0;
+  }
+  return 1;
+}
+
+// imginfo_read of the header (imgnum = 0) or, with single, of
+// bp->queries random images
+void bench_time(const char* label, const char* master, int nimg, int single, const imginfo_options* opt, const bench_params* bp)
+{
+  double total = 0.0, best = 0.0;
+  int nqueries = single ? bp->queries : 1;
+  for (int irun = 0; irun < bp->runs; irun++) {
+    double t0 = bench_clock();
+    for (int iquery = 0; iquery < nqueries; iquery++) {
+      imginfo_result res;
+      int imgnum = single ? 1 + (int) (drand48()*nimg) : 0;
+      imginfo_read(master, imgnum, opt, &res);
+    }
+    double t = (bench_clock() - t0)/nqueries;
+    total += t;
+    if (irun==0 || t<best) best = t;
+  }
+  printf(" %-34s [ms] = %10.3f  (best %10.3f)\n",label,1000.0*total/bp->runs,1000.0*best);
+}
+
+// bp->queries random images through one file handle
+void bench_time_file(const char* label, const char* master, int nimg, const imginfo_options* opt, const bench_params* bp)
+{
+  double total = 0.0, best = 0.0;
+  for (int irun = 0; irun < bp->runs; irun++) {
+    double t0 = bench_clock();
+    imginfo_file* file = imginfo_open(master, opt);
+    for (int iquery = 0; iquery < bp->queries; iquery++) {
+      imginfo_result res;
+      imginfo_read_image(file, 1 + (int) (drand48()*nimg), &res);
+    }
+    imginfo_close(file);
+    double t = (bench_clock() - t0)/bp->queries;
+    total += t;
+    if (irun==0 || t<best) best = t;
+  }
+  printf(" %-34s [ms] = %10.3f  (best %10.3f)\n",label,1000.0*total/bp->runs,1000.0*best);
+}
+
+// ==================================================================================================
+// -check: damaged chunks
+//   five images, of which the 2nd is truncated, the 3rd has a block
+//   whose compressed size points past the end of the chunk and the 4th
+//   a block size of 0 - imginfo_read_frames with verify has to report
+//   exactly those as bad (and carry on to the 5th)
+// ==================================================================================================
+int bench_corrupt(const bench_params* bp, const char* dir)
+{
+  bench_params p = *bp;
+  p.flavour  = BENCH_DECTRIS;
+  p.nimages  = 5;
+  p.ntrigger = 1;
+  p.nperfile = 5;
+  printf("\n ===== Check: damaged bitshuffle/LZ4 chunks (-verify)\n");
+
+  string chunk;
+  int filtered;
+  bench_frame_chunk(&p, chunk, &filtered);
+  if (!filtered) {
+    printf(" skipped - no bitshuffle/LZ4 compression available\n");
+    return 1;
+  }
+  if (!bench_generate(&p, dir, "bench_corrupt")) return 0;
+
+  char path[2*PATH_MAX];
+  snprintf(path, sizeof(path), "%s/bench_corrupt_data_000001.h5", dir);
+  string damaged[3];
+  damaged[0] = chunk.substr(0, chunk.size()/2);
+  damaged[1] = chunk;
+  for (int i = 0; i < 4; i++) damaged[1][12+i] = (char) 0x7f;
+  damaged[2] = chunk;
+  for (int i = 0; i < 4; i++) damaged[2][8+i] = 0;
+  hid_t fid = H5Fopen(path, H5F_ACC_RDWR, H5P_DEFAULT);
+  hid_t did = (fid>=0) ? H5Dopen2(fid, "/entry/data/data", H5P_DEFAULT) : -1;
+  int ok = (did>=0);
+  for (int i = 0; ok && i < 3; i++) {
+    hsize_t offset[3] = { (hsize_t) i+1, 0, 0 };
+    ok = (H5Dwrite_chunk(did, H5P_DEFAULT, 0, offset, damaged[i].size(), damaged[i].data())>=0);
+  }
+  if (did>=0) H5Dclose(did);
+  if (fid>=0 && H5Fclose(fid)<0) ok = 0;
+  if (!ok) {
+    printf("\n ERROR: unable to write damaged chunks to %s!\n\n",path);
+    return 0;
+  }
+
+  imginfo_options opt = imginfo_default_options();
+  opt.verify = 1;
+  snprintf(path, sizeof(path), "%s/bench_corrupt_master.h5", dir);
+  imginfo_file* file = imginfo_open(path, &opt);
+  imginfo_result res;
+  imginfo_frame_stats st;
+  imginfo_read_frames(file, 0, 0, 1, NULL, NULL, &st, &res);
+  imginfo_close(file);
+  printf(" %-34s      = %ld (expected 3)\n","bad frames",st.nbad);
+  printf(" %-34s      = %d (expected 2)\n","first bad frame",st.bad_imgn);
+  printf(" %-34s      = %ld (expected 2)\n","frames read",st.nframes);
+  if (st.nbad!=3 || st.bad_imgn!=2 || st.nframes!=2) {
+    printf("\n ERROR: damaged chunks not reported as such!\n\n");
+    printf("%s",res.report.c_str());
+    return 0;
+  }
+  return 1;
+}
+
+void bench_remove(const char* dir)
+{
+  DIR* d = opendir(dir);
+  if (d==NULL) return;
+  struct dirent* e;
+  while ((e = readdir(d))!=NULL) {
+    if (strncmp(e->d_name, "bench_", 6)!=0) continue;
+    string path = string(dir) + "/" + e->d_name;
+    unlink(path.c_str());
+  }
+  closedir(d);
+  rmdir(dir);
+}
+
+void bench_usage(void)
+{
+  printf("\n USAGE: imginfo_bench [-flavour dectris|diamond|gonomega|sample_phi|all] [-nimages <N>] [-ntrigger <N>]\n");
+  printf("                      [-nperfile <N>] [-detector <X>x<Y>] [-frame <X>x<Y>] [-runs <N>] [-queries <N>]\n");
+  printf("                      [-dir <dir>] [-generate] [-check]\n");
+  printf("\n");
+  printf("        -flavour <name>         : layout of the master file (default = all)\n");
+  printf("                                    dectris    - detectorSpecific and /entry/sample/goniometer\n");
+  printf("                                    diamond    - /entry/data/omega (\"axes\" attribute) and module/data_size\n");
+  printf("                                    gonomega   - /entry/data/gonomega and detectorSpecific\n");
+  printf("                                    sample_phi - as diamond, plus /entry/sample/sample_phi etc\n");
+  printf("\n");
+  printf("        -nimages <N>            : images per trigger (default = 3600, up to 1000000 in total)\n");
+  printf("        -ntrigger <N>           : triggers (dectris only, default = 1)\n");
+  printf("        -nperfile <N>           : images per data file (default = 1000)\n");
+  printf("        -detector <X>x<Y>       : detector size given in the master file (default = 4148x4362)\n");
+  printf("        -frame <X>x<Y>          : size of the frames actually written (default = 64x64)\n");
+  printf("\n");
+  printf("        -runs <N>               : repeat each timing N times (default = 5)\n");
+  printf("        -queries <N>            : random single-image queries per run (default = 20)\n");
+  printf("\n");
+  printf("        -dir <dir>              : write the files into <dir> and keep them (default = temporary\n");
+  printf("                                  directory, removed afterwards)\n");
+  printf("        -generate               : only write the files (needs -dir)\n");
+  printf("        -check                  : instead of the timings, check that damaged chunks are reported as\n");
+  printf("                                  such when reading frames with verify\n");
+  printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+  bench_params bp;
+  bp.flavour  = -1;
+  bp.nimages  = 3600;
+  bp.ntrigger = 1;
+  bp.nperfile = 1000;
+  bp.numx     = 4148;
+  bp.numy     = 4362;
+  bp.framex   = 64;
+  bp.framey   = 64;
+  bp.runs     = 5;
+  bp.queries  = 20;
+  const char* dir = NULL;
+  int generate_only = 0;
+  int check_only = 0;
+
+  for (int iarg = 1; iarg < argc; iarg++) {
+    const char* arg = argv[iarg];
+    const char* value = (iarg+1<argc) ? argv[iarg+1] : NULL;
+    int n = 0;
+    if (strcmp(arg,"-h")==0 || strcmp(arg,"--help")==0) {
+      bench_usage();
+      return EXIT_SUCCESS;
+    }
+    else if (strcmp(arg,"-generate")==0 || strcmp(arg,"--generate")==0) {
+      generate_only = 1;
+      continue;
+    }
+    else if (strcmp(arg,"-check")==0 || strcmp(arg,"--check")==0) {
+      check_only = 1;
+      continue;
+    }
+    if (value==NULL) {
+      printf("\n ERROR: option \"%s\" requires a value!\n\n",arg);
+      return EXIT_FAILURE;
+    }
+    iarg++;
+    if (strcmp(arg,"-flavour")==0 || strcmp(arg,"--flavour")==0) {
+      bp.flavour = -2;
+      for (int iflavour = 0; iflavour < BENCH_NFLAVOURS; iflavour++) {
+        if (strcmp(value,bench_flavour_name[iflavour])==0) bp.flavour = iflavour;
+      }
+      if (strcmp(value,"all")==0) bp.flavour = -1;
+      n = (bp.flavour!=-2);
+    }
+    else if (strcmp(arg,"-nimages")==0  || strcmp(arg,"--nimages")==0)  n = sscanf(value,"%d",&bp.nimages)==1 && bp.nimages>0;
+    else if (strcmp(arg,"-ntrigger")==0 || strcmp(arg,"--ntrigger")==0) n = sscanf(value,"%d",&bp.ntrigger)==1 && bp.ntrigger>0;
+    else if (strcmp(arg,"-nperfile")==0 || strcmp(arg,"--nperfile")==0) n = sscanf(value,"%d",&bp.nperfile)==1 && bp.nperfile>0;
+    else if (strcmp(arg,"-detector")==0 || strcmp(arg,"--detector")==0) n = sscanf(value,"%dx%d",&bp.numx,&bp.numy)==2 && bp.numx>0 && bp.numy>0;
+    else if (strcmp(arg,"-frame")==0    || strcmp(arg,"--frame")==0)    n = sscanf(value,"%dx%d",&bp.framex,&bp.framey)==2 && bp.framex>0 && bp.framey>0;
+    else if (strcmp(arg,"-runs")==0     || strcmp(arg,"--runs")==0)     n = sscanf(value,"%d",&bp.runs)==1 && bp.runs>0;
+    else if (strcmp(arg,"-queries")==0  || strcmp(arg,"--queries")==0)  n = sscanf(value,"%d",&bp.queries)==1 && bp.queries>0;
+    else if (strcmp(arg,"-dir")==0      || strcmp(arg,"--dir")==0)      n = 1, dir = value;
+    else {
+      printf("\n ERROR: unknown option \"%s\"!\n",arg);
+      bench_usage();
+      return EXIT_FAILURE;
+    }
+    if (!n) {
+      printf("\n ERROR: invalid value \"%s\" for option \"%s\"!\n\n",value,arg);
+      return EXIT_FAILURE;
+    }
+  }
+  if ((long) bp.nimages*bp.ntrigger > 1000000) {
+    printf("\n ERROR: at most 1000000 images in total!\n\n");
+    return EXIT_FAILURE;
+  }
+  if (generate_only && dir==NULL) {
+    printf("\n ERROR: option \"-generate\" requires \"-dir\"!\n\n");
+    return EXIT_FAILURE;
+  }
+
+  char tmpdir[PATH_MAX];
+  int keep = (dir!=NULL);
+  if (dir==NULL) {
+    const char* tmp = getenv("TMPDIR");
+    snprintf(tmpdir, sizeof(tmpdir), "%s/imginfo_bench.XXXXXX", (tmp!=NULL&&tmp[0]!=0) ? tmp : "/tmp");
+    if (mkdtemp(tmpdir)==NULL) {
+      printf("\n ERROR: unable to create temporary directory %s (%s)!\n\n",tmpdir,strerror(errno));
+      return EXIT_FAILURE;
+    }
+    dir = tmpdir;
+  } else {
+    mkdir(dir, 0777);
+  }
+
+#if defined(USE_BITSHUFFLE)
+  // so the data files can be created with the bitshuffle filter set
+  bshuf_register_h5filter();
+#endif
+  srand48(1);
+
+  int status = EXIT_SUCCESS;
+  if (check_only) {
+    if (!bench_corrupt(&bp, dir)) status = EXIT_FAILURE;
+    printf("\n");
+    if (!keep) bench_remove(dir);
+    return status;
+  }
+  for (int iflavour = 0; iflavour < BENCH_NFLAVOURS; iflavour++) {
+    if (bp.flavour>=0 && bp.flavour!=iflavour) continue;
+    bench_params p = bp;
+    p.flavour = iflavour;
+    // only the Dectris layout records triggers
+    if (iflavour!=BENCH_DECTRIS) p.ntrigger = 1;
+    int nimg = p.nimages*p.ntrigger;
+    char name[64], master[2*PATH_MAX];
+    snprintf(name, sizeof(name), "bench_%s", bench_flavour_name[iflavour]);
+    snprintf(master, sizeof(master), "%s/%s_master.h5", dir, name);
+
+    printf("\n ===== Benchmark: %s (%d images, %d trigger(s), %d data files)\n",
+           bench_flavour_name[iflavour],nimg,p.ntrigger,(nimg + p.nperfile - 1)/p.nperfile);
+    double t0 = bench_clock();
+    if (!bench_generate(&p, dir, name)) {
+      status = EXIT_FAILURE;
+      break;
+    }
+    printf(" %-34s [ms] = %10.3f\n","generate files",1000.0*(bench_clock()-t0));
+    if (generate_only) continue;
+
+    imginfo_options opt = imginfo_default_options();
+    imginfo_options opt_check = opt;
+    opt_check.h5check = 1;
+    if (!bench_check(master, &opt, nimg) || !bench_check(master, &opt_check, nimg)) {
+      status = EXIT_FAILURE;
+      continue;
+    }
+    bench_time("header", master, nimg, 0, &opt, &bp);
+    bench_time("single image", master, nimg, 1, &opt, &bp);
+    bench_time_file("single image (file handle)", master, nimg, &opt, &bp);
+    bench_time("header with -h5check", master, nimg, 0, &opt_check, &bp);
+    bench_time("single image with -h5check", master, nimg, 1, &opt_check, &bp);
+    bench_time_file("... (file handle)", master, nimg, &opt_check, &bp);
+  }
+  printf("\n");
+
+  if (!keep) bench_remove(dir);
+  return status;
+}
@@ -0,0 +1,5158 @@
+//     **********************************************************************
+//
+//      Copyright (c) 2017, 2024 Global Phasing Ltd.
+//
+//      This Source Code Form is subject to the terms of the Mozilla Public
+//      License, v. 2.0. If a copy of the MPL was not distributed with this
+//      file, you can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//      Authors: Clemens Vonrhein, Claus Flensburg, Thomas Womack and Gerard Bricogne
+//
+//     **********************************************************************
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <locale.h>
+#include <libgen.h> //basename and dirname
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+
+#if defined(__APPLE__) && defined(__MACH__)
+#include <libgen.h>
+#include <xlocale.h>
+#endif
+
+#if defined(USE_HDF5)
+#include "hdf5.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef USE_BITSHUFFLE
+#include "bshuf_h5filter.h"
+#include "bitshuffle.h"
+#endif
+#ifdef USE_LZ4
+#include "lz4.h"
+extern const H5Z_class2_t H5Z_LZ4[1];
+#define LZ4_FILTER 32004
+#endif
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// compile with -lz -lbz2 //
+#include <zlib.h>
+#include <bzlib.h>
+
+#include "imginfo.h"
+
+#if defined(USE_HDF5)
+// -timings: count the main HDF5 calls (while a call is being timed)
+#define H5Fopen(...)   (timing_count(IMGINFO_CALL_H5FOPEN),  H5Fopen(__VA_ARGS__))
+#define H5Dopen2(...)  (timing_count(IMGINFO_CALL_H5DOPEN),  H5Dopen2(__VA_ARGS__))
+#define H5Lexists(...) (timing_count(IMGINFO_CALL_H5LEXISTS),H5Lexists(__VA_ARGS__))
+#define H5Dread(...)   (timing_count(IMGINFO_CALL_H5DREAD),  H5Dread(__VA_ARGS__))
+#define H5Aread(...)   (timing_count(IMGINFO_CALL_H5AREAD),  H5Aread(__VA_ARGS__))
+#endif
+
+// ==================================================================================================
+// libimginfo: imginfo_read and the messages it collects
+//   all state of a call lives in its imginfo_ctx (passed down to every
+//   routine that reads or reports something), nothing is printed and
+//   nothing ends the process: an error the imginfo program can't carry on
+//   after sets ctx->fatal and makes the routines return early. What can
+//   be reused for another image of the same file is kept in the
+//   imginfo_file the call was made through.
+// ==================================================================================================
+imginfo_options imginfo_default_options(void)
+{
+  imginfo_options opt;
+  opt.iverb   = 0;
+  opt.h5check = 0;
+  opt.h5jobs  = 1;
+  opt.h5mem   = 0;
+  opt.verify  = 0;
+  opt.timings = 0;
+  opt.sweep_summary = 0;
+  opt.per_image     = NULL;
+  opt.per_image_arg = NULL;
+  return opt;
+}
+
+int imginfo_read(const char* path, int imgnum, const imginfo_options* opt, imginfo_result* res)
+{
+  imginfo_file* file = imginfo_open(path, opt);
+  int status = imginfo_read_image(file, imgnum, res);
+  imginfo_close(file);
+  return status;
+}
+
+// nothing is read until the first image is asked for
+imginfo_file* imginfo_open(const char* path, const imginfo_options* opt)
+{
+  imginfo_file* file = new imginfo_file;
+  file->path   = path;
+  file->opt    = *opt;
+  file->nread  = 0;
+  file->buflen = 0;
+  file->fid    = -1;
+  file->lapl   = -1;
+  file->dapl   = -1;
+  file->gapl   = -1;
+  file->check.done = 0;
+  file->arena.used = 0;
+  return file;
+}
+
+// a call through a file handle: its options, an empty result
+void imginfo_ctx_init(imginfo_ctx* ctx, imginfo_file* file, imginfo_result* res)
+{
+  const imginfo_options* opt = &file->opt;
+  ctx->iverb    = opt->iverb;
+  ctx->h5check  = opt->h5check;
+  ctx->h5jobs   = opt->h5jobs;
+  ctx->h5resume = opt->h5resume;
+  ctx->h5mem    = opt->h5mem;
+  ctx->sweep_summary = opt->sweep_summary;
+  ctx->per_image     = opt->per_image;
+  ctx->per_image_arg = opt->per_image_arg;
+  ctx->fatal    = 0;
+  ctx->res      = res;
+  ctx->file     = file;
+  ctx->arena    = &file->arena;
+  ctx->t        = NULL;
+  ctx->phase    = -1;
+
+  res->report.clear();
+  res->diags.clear();
+  empty_header(&res->h);
+}
+
+// the start of the file (to tell its format), read only once per handle
+int imginfo_file_buffer(imginfo_file* file)
+{
+  const char* path = file->path.c_str();
+  if (file->buflen==0) {
+    memset(file->buffer, 0, CHUNK);
+    int image = get_file_image(path, file->image);
+    if (image>0) {
+      file->buflen = ( file->image.size()<CHUNK ) ? file->image.size() : CHUNK;
+      memcpy(file->buffer, file->image.data(), file->buflen);
+    } else if (image==0) {
+      file->buflen = get_buffer(path, file->buffer);
+    } else {
+      file->buflen = -1;
+    }
+    // protect overflow when scanning buffer using strycpy
+    if (file->buflen>0) file->buffer[file->buflen - 1] = EOF;
+  }
+  return file->buflen;
+}
+
+int imginfo_read_image(imginfo_file* file, int imgnum, imginfo_result* res)
+{
+  const char* path = file->path.c_str();
+  imginfo_ctx ctx;
+  imginfo_ctx_init(&ctx, file, res);
+  if (file->opt.timings) timing_start(&ctx, &res->timings);
+  trace_span span("file", "imginfo_read_image", path);
+
+  timing_phase(&ctx, IMGINFO_PHASE_BUFFER);
+  int buflen = imginfo_file_buffer(file);
+  if (ctx.iverb>1) imginfo_log(&ctx, IMGINFO_DEBUG, " [debug] get_buffer send back buflen=%i\n", buflen);
+  if (buflen<=0) {
+    timing_phase(&ctx, -1);
+    res->status = IMGINFO_UNREADABLE;
+    return res->status;
+  }
+
+  if (ctx.iverb>1) imginfo_log(&ctx, IMGINFO_DEBUG, " [debug] buffer_size=%i\n", buflen - 1);
+  if (ctx.iverb>2) imginfo_log(&ctx, IMGINFO_DEBUG, " [debug] calling get_header\n");
+  int header_success = get_header(&ctx, file->buffer, &res->h, path, imgnum);
+  if (ctx.iverb>2) imginfo_log(&ctx, IMGINFO_DEBUG, " [debug] header_success=%d\n", header_success);
+  file->nread++;
+  arena_reset(&file->arena);
+  timing_phase(&ctx, -1);
+
+  if (ctx.fatal) {
+    res->status = IMGINFO_FATAL;
+  } else if (header_success == 0) {
+    res->status = IMGINFO_NO_HEADER;
+  } else {
+    res->status = IMGINFO_OK;
+  }
+  return res->status;
+}
+
+void imginfo_close(imginfo_file* file)
+{
+  if (file==NULL) return;
+#if defined(USE_HDF5)
+  for (map<string,hid_t>::iterator it = file->groups.begin(); it != file->groups.end(); it++) {
+    if (it->second>=0) H5Gclose(it->second);
+  }
+  if (file->fid>=0) H5Fclose(file->fid);
+  if (file->lapl>=0) H5Pclose(file->lapl);
+  if (file->dapl>=0) H5Pclose(file->dapl);
+  if (file->gapl>=0) H5Pclose(file->gapl);
+#endif
+  arena_free(&file->arena);
+  delete file;
+}
+
+// add one message to the report (verbatim) and to the diagnostics (without
+// the blank lines and indentation around it)
+void imginfo_log(imginfo_ctx* ctx, int level, const char* fmt, ...)
+{
+  char line[CHAR_ARRAY_LEN*8];
+  string text;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  if (n<0) return;
+  if (n<(int) sizeof(line)) {
+    text.assign(line, n);
+  } else {
+    vector<char> buf(n+1);
+    va_start(ap, fmt);
+    vsnprintf(&buf[0], buf.size(), fmt, ap);
+    va_end(ap);
+    text.assign(&buf[0], n);
+  }
+
+  ctx->res->report += text;
+  size_t b = text.find_first_not_of(" \t\r\n");
+  if (b==string::npos) return;
+  size_t e = text.find_last_not_of(" \t\r\n");
+  // continuation lines of a warning or error belong to the same message
+  vector<imginfo_diag>& diags = ctx->res->diags;
+  if (level>=IMGINFO_WARNING && !diags.empty() && diags.back().level==level && text[0]!='\n' &&
+      text.compare(b, 7, "WARNING")!=0 && text.compare(b, 5, "ERROR")!=0) {
+    diags.back().text += "\n" + text.substr(b, e-b+1);
+    return;
+  }
+  imginfo_diag d;
+  d.level = level;
+  d.text  = text.substr(b, e-b+1);
+  ctx->res->diags.push_back(d);
+}
+
+// add what was collected elsewhere (e.g. in a worker process)
+void imginfo_log_text(imginfo_ctx* ctx, const string& report, const vector<imginfo_diag>& diags)
+{
+  ctx->res->report += report;
+  ctx->res->diags.insert(ctx->res->diags.end(), diags.begin(), diags.end());
+}
+
+// ==================================================================================================
+// per-file arena
+//   a bump allocator: blocks of ARENA_BLOCK bytes (or one of its own for
+//   anything larger) that are only ever released all together - so that
+//   reading thousands of files one after the other needs no more memory
+//   than the largest of them, and no malloc call for most items read
+// ==================================================================================================
+void* arena_alloc(imginfo_arena* a, size_t n)
+{
+  if (a==NULL) return malloc(n);
+  n = (n + 15) & ~((size_t) 15);
+  if (a->blocks.empty() || a->used + n > a->blocks.back().size) {
+    arena_block b;
+    b.size = ( n>ARENA_BLOCK ) ? n : ARENA_BLOCK;
+    b.p    = (char*) malloc(b.size);
+    if (b.p==NULL) return NULL;
+    a->blocks.push_back(b);
+    a->used = 0;
+  }
+  void* p = a->blocks.back().p + a->used;
+  a->used += n;
+  return p;
+}
+
+void* arena_calloc(imginfo_arena* a, size_t n, size_t size)
+{
+  void* p = arena_alloc(a, n*size);
+  if (p!=NULL) memset(p, 0, n*size);
+  return p;
+}
+
+char* arena_strdup(imginfo_arena* a, const char* s)
+{
+  size_t n = strlen(s) + 1;
+  char* p = (char*) arena_alloc(a, n);
+  if (p!=NULL) memcpy(p, s, n);
+  return p;
+}
+
+void arena_reset(imginfo_arena* a)
+{
+  while (a->blocks.size()>1) {
+    free(a->blocks.back().p);
+    a->blocks.pop_back();
+  }
+  a->used = 0;
+}
+
+void arena_free(imginfo_arena* a)
+{
+  arena_reset(a);
+  if (!a->blocks.empty()) free(a->blocks[0].p);
+  a->blocks.clear();
+}
+
+// ==================================================================================================
+// -timings
+//   a timed call goes through a sequence of phases, each switch adding
+//   wall and CPU time (of the calling thread) and bytes read (by the
+//   whole process, from /proc/self/io - Linux only) since the last one
+//   to the phase that ends. The HDF5 calls counted (see the macros at
+//   the top) go to the call being timed in the same thread.
+// ==================================================================================================
+const char* imginfo_phase_name[IMGINFO_NPHASES] = {
+  "buffer", "open", "metadata", "h5check", "goniometer", "per_image", "close"
+};
+const char* imginfo_call_name[IMGINFO_NCALLS] = {
+  "H5Fopen", "H5Dopen2", "H5Lexists", "H5Dread", "H5Aread"
+};
+
+__thread imginfo_timings* timing_calls = NULL;
+__thread double timing_proc_bytes = 0.0;
+
+void timing_start(imginfo_ctx* ctx, imginfo_timings* t)
+{
+  for (int iphase = 0; iphase < IMGINFO_NPHASES; iphase++) {
+    t->wall[iphase]  = 0.0;
+    t->cpu[iphase]   = 0.0;
+    t->nread[iphase] = 0.0;
+  }
+  for (int icall = 0; icall < IMGINFO_NCALLS; icall++) t->calls[icall] = 0;
+  ctx->t = t;
+  ctx->phase = -1;
+  timing_calls = t;
+}
+
+// end the current phase and start the next one (-1 = done)
+void timing_phase(imginfo_ctx* ctx, int phase)
+{
+  if (ctx->t==NULL) return;
+  double wall  = timing_wall();
+  double cpu   = timing_cpu();
+  double nread = timing_nread();
+  if (ctx->phase>=0) {
+    ctx->t->wall[ctx->phase] += wall - ctx->phase_wall;
+    ctx->t->cpu[ctx->phase]  += cpu  - ctx->phase_cpu;
+    if (nread<0.0 || ctx->phase_nread<0.0 || ctx->t->nread[ctx->phase]<0.0) {
+      ctx->t->nread[ctx->phase] = -1.0;
+    } else {
+      ctx->t->nread[ctx->phase] += nread - ctx->phase_nread;
+    }
+  }
+  ctx->phase       = phase;
+  ctx->phase_wall  = wall;
+  ctx->phase_cpu   = cpu;
+  ctx->phase_nread = nread;
+  if (phase<0) timing_calls = NULL;
+}
+
+void timing_count(int call)
+{
+  if (timing_calls!=NULL) timing_calls->calls[call]++;
+}
+
+// bytes read by this process so far - leaving out what reading
+// /proc/self/io itself added
+double timing_nread(void)
+{
+  int fd = open("/proc/self/io", O_RDONLY);
+  if (fd<0) return -1.0;
+  char buf[CHAR_ARRAY_LEN*4];
+  ssize_t n = read(fd, buf, sizeof(buf)-1);
+  close(fd);
+  if (n<=0) return -1.0;
+  buf[n] = 0;
+  const char *p = strstr(buf, "rchar:");
+  if (p==NULL) return -1.0;
+  double nread = strtod(p+6, NULL) - timing_proc_bytes;
+  timing_proc_bytes += n;
+  return nread;
+}
+
+double timing_cpu(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+double timing_wall(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// ==================================================================================================
+// --trace
+//   spans go into a ring buffer allocated once: a slot is claimed with
+//   an atomic increment and filled in place. The thread that opened the
+//   trace flushes the ring as soon as it is full, spans recorded by other
+//   threads meanwhile may overwrite the oldest ones. Each flush appends one
+//   complete event per line (each followed by a comma) to the trace file
+//   opened with O_APPEND, so that worker processes can add theirs with
+//   a single write each; closing adds the final (metadata) event and
+//   the closing bracket. All of this is process-global state, not part of
+//   an imginfo_ctx: opening, flushing and closing are not thread-safe.
+// ==================================================================================================
+#define TRACE_ARG_LEN 96
+
+typedef struct trace_event_s {
+  const char* cat;
+  const char* name;
+  double t0;
+  double t1;
+  int    tid;
+  char   arg[TRACE_ARG_LEN];
+} trace_event;
+
+trace_event*  trace_ring  = NULL;
+unsigned long trace_size  = 0;
+unsigned long trace_next  = 0;
+unsigned long trace_first = 0; /* not flushed yet        */
+int           trace_fd    = -1;
+int           trace_named = 0; /* process_name written   */
+pid_t         trace_pid   = 0; /* process that opened it  */
+int           trace_owner = 0; /* thread flushing a full ring */
+__thread int  trace_thread_id = 0;
+
+int imginfo_trace_open(const char* path, long nevents)
+{
+  imginfo_trace_close();
+  if (nevents<=0) return -1;
+  trace_fd = open(path, O_WRONLY|O_CREAT|O_TRUNC|O_APPEND, 0666);
+  if (trace_fd<0) return -1;
+  trace_ring = (trace_event*) calloc(nevents, sizeof(trace_event));
+  if (trace_ring==NULL || write(trace_fd, "[\n", 2)!=2) {
+    free(trace_ring);
+    trace_ring = NULL;
+    close(trace_fd);
+    trace_fd = -1;
+    return -1;
+  }
+  trace_size  = nevents;
+  trace_pid   = getpid();
+  trace_owner = trace_tid();
+  trace_next  = 0;
+  trace_first = 0;
+  trace_named = 0;
+  return 0;
+}
+
+void imginfo_trace_flush(void)
+{
+  if (trace_ring==NULL) return;
+  int pid = getpid();
+  unsigned long next = trace_next;
+  string out;
+  char line[CHAR_ARRAY_LEN*4];
+  if (!trace_named) {
+    snprintf(line, sizeof(line), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"imginfo %d\"}},\n",pid,pid);
+    out += line;
+    trace_named = 1;
+  }
+  if (next-trace_first>trace_size) {
+    snprintf(line, sizeof(line), "{\"name\":\"dropped\",\"ph\":\"i\",\"s\":\"p\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"args\":{\"events\":%lu}},\n",
+             pid,trace_tid(),1e6*trace_ring[next%trace_size].t0,next-trace_first-trace_size);
+    out += line;
+    trace_first = next - trace_size;
+  }
+  for (unsigned long ievent = trace_first; ievent < next; ievent++) {
+    const trace_event* e = &trace_ring[ievent%trace_size];
+    snprintf(line, sizeof(line), "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+             e->name,e->cat,pid,e->tid,1e6*e->t0,1e6*(e->t1-e->t0));
+    out += line;
+    if (e->arg[0]!=0) {
+      out += ",\"args\":{\"arg\":";
+      trace_json_string(out, e->arg);
+      out += '}';
+    }
+    out += "},\n";
+  }
+  trace_first = next;
+  size_t nwritten = 0;
+  while (nwritten<out.size()) {
+    ssize_t n = write(trace_fd, out.data()+nwritten, out.size()-nwritten);
+    if (n<0 && errno==EINTR) continue;
+    if (n<=0) break;
+    nwritten += n;
+  }
+}
+
+void imginfo_trace_close(void)
+{
+  if (trace_ring==NULL) return;
+  imginfo_trace_flush();
+  // a worker process exiting early leaves finishing the file to the
+  // process that opened it
+  if (getpid()==trace_pid) {
+    char line[CHAR_ARRAY_LEN*4];
+    snprintf(line, sizeof(line), "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"sort_index\":0}}\n]\n",(int) trace_pid);
+    ssize_t n = write(trace_fd, line, strlen(line));
+    (void) n;
+  }
+  close(trace_fd);
+  free(trace_ring);
+  trace_ring = NULL;
+  trace_fd   = -1;
+}
+
+// a forked worker process: what the parent recorded is the parent's to
+// write out
+void trace_forked(void)
+{
+  if (trace_ring==NULL) return;
+  trace_first = trace_next;
+  trace_named = 0;
+  trace_thread_id = 0;
+  trace_owner = trace_tid();
+}
+
+void trace_record(const char* cat, const char* name, const char* arg, double t0, double t1)
+{
+  if (trace_ring==NULL) return;
+  unsigned long ievent = __sync_fetch_and_add(&trace_next, 1);
+  trace_event* e = &trace_ring[ievent%trace_size];
+  e->cat  = cat;
+  e->name = name;
+  e->t0   = t0;
+  e->t1   = t1;
+  e->tid  = trace_tid();
+  if (arg!=NULL) {
+    strncpy(e->arg, arg, TRACE_ARG_LEN-1);
+    e->arg[TRACE_ARG_LEN-1] = 0;
+  } else {
+    e->arg[0] = 0;
+  }
+  if (ievent+1-trace_first>=trace_size && e->tid==trace_owner) imginfo_trace_flush();
+}
+
+int trace_tid(void)
+{
+  if (trace_thread_id==0) trace_thread_id = syscall(SYS_gettid);
+  return trace_thread_id;
+}
+
+void trace_json_string(string& out, const char* s)
+{
+  out += '"';
+  for (const char* p = s; *p; p++) {
+    if (*p=='"' || *p=='\\') {
+      out += '\\';
+      out += *p;
+    } else if ((unsigned char) *p<0x20) {
+      char u[8];
+      snprintf(u, sizeof(u), "\\u%04x", (unsigned char) *p);
+      out += u;
+    } else {
+      out += *p;
+    }
+  }
+  out += '"';
+}
+
+trace_span::trace_span(const char* cat, const char* name, const char* arg)
+{
+  this->t0   = ( trace_ring!=NULL ) ? timing_wall() : 0.0;
+  this->cat  = cat;
+  this->name = name;
+  this->arg  = arg;
+}
+
+trace_span::~trace_span()
+{
+  if (trace_ring!=NULL && t0>0.0) trace_record(cat, name, arg, t0, timing_wall());
+}
+
+// ==================================================================================================
+// tokenising and file stamps (also used by the imginfo program)
+// ==================================================================================================
+vector<string> tokenise(const char* line)
+{
+  // split into space-separated strings
+  vector<string> V;
+  int lptr = 0;
+  int sptr = 0;
+  // skip initial spaces
+  while (line[lptr] == 32) lptr++;
+  while (2 != 3)
+    {
+      sptr = lptr;
+      while (line[lptr]!=32 && line[lptr]!=0 && line[lptr]!=10 && line[lptr]!=13) lptr++;
+      V.push_back(string(line+sptr, lptr-sptr));
+      if (line[lptr] == 0 ||line[lptr]==10 || line[lptr]==13) {
+        // mark end of array with an empty item
+        V.push_back("");
+        return V;
+      }
+      while (line[lptr]==32) lptr++;
+    }
+}
+
+vector<string> tokenise_cbf_header(const char* line)
+{
+  // split into space-separated strings
+  // according to manual version 1.2 the following are equivalent to space: '#=:,()'
+  // ascii decimal table from: http://www.asciitable.com/
+  //  0 == NUL (null)
+  // 10 == LF  (line feed, new line)
+  // 13 == CR  (carriage return)
+  // 32 == space
+  // 35 == '#'
+  // 40 == '('
+  // 41 == ')'
+  // 44 == ','
+  // 58 == ':'
+  // 61 == '='
+  vector<string> V;
+  int lptr = 0;
+  int sptr = 0;
+  // skip initial spaces
+  while (line[lptr] == 32) lptr++;
+  while (2 != 3)
+    {
+      sptr = lptr;
+      while (line[lptr]!=32 && line[lptr]!=0  && line[lptr]!=10 && line[lptr]!=13 &&
+             line[lptr]!=35 && line[lptr]!=40 && line[lptr]!=41 && line[lptr]!=44 && 
+             line[lptr]!=58 && line[lptr]!=61) lptr++;
+      V.push_back(string(line+sptr, lptr-sptr));
+      if (line[lptr] == 0 || line[lptr]==10 || line[lptr]==13) {
+        // mark end of array with an empty item
+        V.push_back("");
+        return V;
+      }
+      while (line[lptr]==32 || line[lptr]==35 || line[lptr]==40 || line[lptr]==41 || line[lptr]==44 || line[lptr]==58 || line[lptr]==61) lptr++;
+    }
+}
+
+vector<string> tokenise_file_name(const char* line)
+{
+  // split into space-separated strings
+  // ascii decimal table from: http://www.asciitable.com/
+  //  0 == NUL (null)
+  // 10 == LF  (line feed, new line)
+  // 13 == CR  (carriage return)
+  // 32 == space
+  // 44 == ','
+  vector<string> V;
+  int lptr = 0;
+  int sptr = 0;
+  // skip initial spaces
+  while (line[lptr] == 32) lptr++;
+  while (2 != 3)
+    {
+      sptr = lptr;
+      while (line[lptr]!=32 && line[lptr]!=0  && line[lptr]!=10 && line[lptr]!=13 &&
+             line[lptr]!=44 ) lptr++;
+      V.push_back(string(line+sptr, lptr-sptr));
+      if (line[lptr] == 0 || line[lptr]==10 || line[lptr]==13) {
+        // mark end of array with an empty item
+        V.push_back("");
+        return V;
+      }
+      while (line[lptr]==32 || line[lptr]==44 ) lptr++;
+    }
+}
+
+void get_file_stamp(const char* path, file_stamp* s)
+{
+  struct stat st;
+  memset(s, 0, sizeof(file_stamp));
+  if (stat(path, &st)==0) {
+    s->dev        = st.st_dev;
+    s->ino        = st.st_ino;
+    s->size       = st.st_size;
+    s->mtime_sec  = st.st_mtim.tv_sec;
+    s->mtime_nsec = st.st_mtim.tv_nsec;
+  }
+}
+
+// ==================================================================================================
+// worker processes
+//   run ntask tasks in at most nworker forked processes. Whatever a task
+//   writes to stdout is captured, as is anything it writes to the
+//   separate result descriptor it is given. Both are handed to report()
+//   strictly in task order - as soon as that task and all earlier ones
+//   have finished. A non-zero return from report() stops everything
+//   (remaining workers are killed) and is passed back to the caller.
+// ==================================================================================================
+typedef struct worker_s {
+  pid_t  pid;
+  int    fd[2];    // read ends of the worker's stdout and result pipes
+  int    done;     // all output collected and worker reaped
+  int    status;   // as returned by waitpid
+  string output;
+  string result;
+} worker;
+
+int run_workers(int ntask, int nworker,
+                int (*task)(int itask, int fd_result, void* arg),
+                int (*report)(int itask, int status, const string& output, const string& result, void* arg),
+                void* arg)
+{
+  vector<worker> w(ntask);
+  int next_start  = 0;
+  int next_report = 0;
+  int nrunning    = 0;
+  int ret         = 0;
+  char chunk[CHUNK];
+
+  while (next_report<ntask && ret==0) {
+
+    // start as many workers as allowed
+    while (nrunning<nworker && next_start<ntask) {
+      int fds_out[2], fds_res[2];
+      if (pipe(fds_out)<0) {
+        ret = -1;
+        break;
+      }
+      if (pipe(fds_res)<0) {
+        close(fds_out[0]);
+        close(fds_out[1]);
+        ret = -1;
+        break;
+      }
+      // nothing buffered may be duplicated into the child
+      fflush(stdout);
+      pid_t pid = fork();
+      if (pid<0) {
+        close(fds_out[0]);
+        close(fds_out[1]);
+        close(fds_res[0]);
+        close(fds_res[1]);
+        ret = -1;
+        break;
+      }
+      if (pid==0) {
+        trace_forked();
+        close(fds_out[0]);
+        close(fds_res[0]);
+        dup2(fds_out[1],STDOUT_FILENO);
+        close(fds_out[1]);
+        int task_status = task(next_start, fds_res[1], arg);
+        fflush(stdout);
+        imginfo_trace_flush();
+        _exit(task_status);
+      }
+      close(fds_out[1]);
+      close(fds_res[1]);
+      w[next_start].pid   = pid;
+      w[next_start].fd[0] = fds_out[0];
+      w[next_start].fd[1] = fds_res[0];
+      w[next_start].done  = 0;
+      next_start++;
+      nrunning++;
+    }
+    if (ret!=0) break;
+
+    // collect output from whichever workers have something to say
+    vector<struct pollfd> pfd;
+    vector<int> pfd_task;
+    for (int itask = next_report; itask < next_start; itask++) {
+      for (int ifd = 0; ifd < 2; ifd++) {
+        if (w[itask].fd[ifd]>=0) {
+          struct pollfd p;
+          p.fd      = w[itask].fd[ifd];
+          p.events  = POLLIN;
+          p.revents = 0;
+          pfd.push_back(p);
+          pfd_task.push_back(itask);
+        }
+      }
+    }
+    if (!pfd.empty()) {
+      if (poll(&pfd[0], pfd.size(), -1)<0) {
+        if (errno==EINTR) continue;
+        ret = -1;
+        break;
+      }
+      for (size_t ipfd = 0; ipfd < pfd.size(); ipfd++) {
+        if (pfd[ipfd].revents==0) continue;
+        worker *wt = &w[pfd_task[ipfd]];
+        int ifd = (pfd[ipfd].fd==wt->fd[0]) ? 0 : 1;
+        ssize_t nread = read(wt->fd[ifd], chunk, sizeof(chunk));
+        if (nread>0) {
+          if (ifd==0) {
+            wt->output.append(chunk, nread);
+          } else {
+            wt->result.append(chunk, nread);
+          }
+        }
+        else if (nread==0 || errno!=EINTR) {
+          close(wt->fd[ifd]);
+          wt->fd[ifd] = -1;
+          if (wt->fd[0]<0 && wt->fd[1]<0) {
+            waitpid(wt->pid, &wt->status, 0);
+            wt->done = 1;
+            nrunning--;
+          }
+        }
+      }
+    }
+
+    // report finished tasks in order
+    while (next_report<next_start && w[next_report].done && ret==0) {
+      ret = report(next_report, w[next_report].status, w[next_report].output, w[next_report].result, arg);
+      string().swap(w[next_report].output);
+      string().swap(w[next_report].result);
+      next_report++;
+    }
+  }
+
+  // stop and reap anything still running
+  for (int itask = next_report; itask < next_start; itask++) {
+    if (!w[itask].done) {
+      kill(w[itask].pid, SIGTERM);
+      if (w[itask].fd[0]>=0) close(w[itask].fd[0]);
+      if (w[itask].fd[1]>=0) close(w[itask].fd[1]);
+      waitpid(w[itask].pid, &w[itask].status, 0);
+      w[itask].done = 1;
+    }
+  }
+  return ret;
+}
+
+int get_buffer(const char* path, char* buffer){
+
+  int ret;
+  FILE *file;
+  gzFile gzfile;
+  BZFILE *bzfile;
+  int bzerror;
+  int empty;
+
+  ret = -1;
+  empty = 0;
+
+  // first try BZ2 //
+  file = fopen(path, "rb");
+  if (!file)
+      return ret;
+  bzfile = BZ2_bzReadOpen(&bzerror, file, 0, 0, NULL, 0);
+  if ( bzerror == BZ_OK ) {
+      ret = BZ2_bzRead ( &bzerror, bzfile, buffer, CHUNK);
+      if (bzerror == BZ_STREAM_END)
+          empty = 1;
+      //imginfo_log(ctx, IMGINFO_ERROR, "BZERROR=%d %d\n", bzerror, empty);
+  }
+  BZ2_bzReadClose ( &bzerror, bzfile );
+  if (file)
+      fclose(file);
+  if (ret > 0){
+      return ret;
+  }
+  // Detected an empty bz2 file above //
+  if (empty == 1){
+      ret = 0;
+      return ret;
+  }
+
+  // then try gz (will work equally fine on a regular file //
+  gzfile = gzopen(path, "rb");
+  if (gzfile != NULL) {
+      ret = gzread(gzfile, buffer, CHUNK);
+      gzclose(gzfile);
+      if (ret >= 0) {
+          return ret;
+      }
+  }
+
+  // something went wrong //
+  ret = -1;
+  return ret;
+}
+
+// ==================================================================================================
+// file images
+//   master files HDF5 can't open itself - compressed with bzip2 or gzip,
+//   or "-" for stdin - are decompressed straight into memory and opened
+//   from there as an HDF5 file image (see eiger_open)
+// ==================================================================================================
+int read_all(int fd, string& data)
+{
+  char buf[CHUNK];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf)))!=0) {
+    if (n<0) {
+      if (errno==EINTR) continue;
+      return 0;
+    }
+    data.append(buf, n);
+  }
+  return 1;
+}
+
+int gunzip_image(const string& in, string& out)
+{
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  // 15+32: gzip (or zlib) header detected automatically
+  if (inflateInit2(&zs, 15+32)!=Z_OK) return 0;
+  zs.next_in  = (Bytef*) in.data();
+  zs.avail_in = in.size();
+  char buf[CHUNK];
+  int ret;
+  do {
+    zs.next_out  = (Bytef*) buf;
+    zs.avail_out = sizeof(buf);
+    ret = inflate(&zs, Z_NO_FLUSH);
+    if (ret!=Z_OK && ret!=Z_STREAM_END) break;
+    out.append(buf, sizeof(buf) - zs.avail_out);
+    // concatenated members (as gzip itself would write them)
+    if (ret==Z_STREAM_END && zs.avail_in>0) {
+      if (inflateReset(&zs)!=Z_OK) break;
+      ret = Z_OK;
+    }
+  } while (ret==Z_OK);
+  inflateEnd(&zs);
+  return ( ret==Z_STREAM_END );
+}
+
+int bunzip2_image(const string& in, string& out)
+{
+  bz_stream bz;
+  memset(&bz, 0, sizeof(bz));
+  if (BZ2_bzDecompressInit(&bz, 0, 0)!=BZ_OK) return 0;
+  bz.next_in  = (char*) in.data();
+  bz.avail_in = in.size();
+  char buf[CHUNK];
+  int ret;
+  do {
+    bz.next_out  = buf;
+    bz.avail_out = sizeof(buf);
+    ret = BZ2_bzDecompress(&bz);
+    if (ret!=BZ_OK && ret!=BZ_STREAM_END) break;
+    out.append(buf, sizeof(buf) - bz.avail_out);
+    if (ret==BZ_STREAM_END && bz.avail_in>0) {
+      BZ2_bzDecompressEnd(&bz);
+      unsigned int left = bz.avail_in;
+      char* next = bz.next_in;
+      memset(&bz, 0, sizeof(bz));
+      if (BZ2_bzDecompressInit(&bz, 0, 0)!=BZ_OK) return 0;
+      bz.next_in  = next;
+      bz.avail_in = left;
+      ret = BZ_OK;
+    }
+  } while (ret==BZ_OK);
+  BZ2_bzDecompressEnd(&bz);
+  return ( ret==BZ_STREAM_END );
+}
+
+// returns 1 if the file had to be read into image, 0 if HDF5 can open
+// it directly and -1 if it couldn't be read
+int get_file_image(const char* path, string& image)
+{
+  int fd;
+  int is_stdin = ( strcmp(path,"-")==0 );
+  if (is_stdin) {
+    fd = STDIN_FILENO;
+  } else {
+    fd = open(path, O_RDONLY);
+    if (fd<0) return -1;
+    unsigned char magic[3];
+    ssize_t n = read(fd, magic, sizeof(magic));
+    int compressed = ( n==3 && ( (magic[0]==0x1f && magic[1]==0x8b) ||
+                                 (magic[0]=='B' && magic[1]=='Z' && magic[2]=='h') ) );
+    if (!compressed || lseek(fd, 0, SEEK_SET)!=0) {
+      close(fd);
+      return 0;
+    }
+  }
+
+  string raw;
+  int ok = read_all(fd, raw);
+  if (!is_stdin) close(fd);
+  if (!ok) return -1;
+
+  image.clear();
+  const unsigned char* r = (const unsigned char*) raw.data();
+  if (raw.size()>=2 && r[0]==0x1f && r[1]==0x8b) {
+    ok = gunzip_image(raw, image);
+  } else if (raw.size()>=3 && r[0]=='B' && r[1]=='Z' && r[2]=='h') {
+    ok = bunzip2_image(raw, image);
+  } else {
+    image.swap(raw);
+  }
+  if (!ok) string().swap(image);
+  return ok ? 1 : -1;
+}
+
+// ==================================================================================================
+// get_format
+// ==================================================================================================
+format_t get_format(imginfo_ctx* ctx, const char* buffer) {
+  format_t formatn[]  = {
+    FORMAT_HDF5_EIGER
+  };
+  const char* formats[] = {
+    "hdf5_eiger"
+  };
+  int (*formatf[])(const char*) = {
+    is_hdf5_eiger
+  };
+
+  int nformats = sizeof(formatn) / sizeof(int);
+  for (int u=0; u<nformats; u++)
+    {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " [debug]   (%d) calling is_%s\n", u, formats[u]);
+      if (formatf[u](buffer)) {
+        if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " [debug]   YES %d\n",formatn[u]);
+        return formatn[u];
+      } else {
+        if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " [debug]   NO\n");
+      }
+    }
+  return FORMAT_UNKNOWN;
+}
+
+// ==================================================================================================
+// get_header
+// ==================================================================================================
+int get_header(imginfo_ctx* ctx, const char* buffer, image_header* h, const char* path, const int imgnum)
+{
+  empty_header(h);
+  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " [debug]  calling get_format\n");
+  format_t format = get_format(ctx, buffer);
+  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " [debug]  format = %d\n",format);
+
+  if (format == FORMAT_UNKNOWN) {
+    imginfo_log(ctx, IMGINFO_ERROR, "ERROR: cannot determine file format\n");
+    return 0;
+  }
+
+  format_t formats2[] = {FORMAT_HDF5_EIGER};
+  string   formath2[] = {"HDF5/Eiger"};
+  int(*formatf2[])(imginfo_ctx*, const char*, const int, image_header*) = {get_header_eiger};
+
+  for (UINT32 u=0; u < sizeof(formats2)/sizeof(format_t); u++){
+    if (format == formats2[u]) {
+      imginfo_log(ctx, IMGINFO_INFO, " >>> Image format detected as %s\n",formath2[u].c_str());
+      h->format = format;
+      return formatf2[u](ctx, path, imgnum, h);
+    }
+  }
+
+  imginfo_log(ctx, IMGINFO_ERROR, " ERROR: unknown format %d\n",format);
+  return 0;
+}
+
+// ==================================================================================================
+// utility routines
+// ==================================================================================================
+
+char* strycpy(char* out, const char* in, int* nchars)
+{
+  int u;
+  int v;
+  int mchars = *nchars;
+  int eof = -1;
+  v=0;
+  for (u=0; u<mchars-1; u++){
+      v++;
+      out[u]=in[u];
+      if (out[u] == '\0') break;
+      if (out[u] == 10) break;
+      if (out[u] == EOF) {
+          eof = u;
+          break;
+      }
+  }
+  *nchars = v;
+  // As per default of fgets:
+  if (eof == 0) return NULL;
+  if (v < mchars) out[v] = 0;
+  return out;
+}
+
+float my_stof(const string& S)
+{
+  float f;
+  sscanf(S.c_str(),"%f",&f);
+  return f;
+}
+
+double my_stod(const string& S)
+{
+  double f;
+  sscanf(S.c_str(),"%lf",&f);
+  return f;
+}
+
+int my_stoi(const string& S)
+{
+  int f;
+  sscanf(S.c_str(),"%d",&f);
+  return f;
+}
+
+// http://stackoverflow.com/questions/352055/best-algorithm-to-strip-leading-and-trailing-spaces-in-c
+char *strstrip(char *s)
+{
+    size_t size;
+    char *end;
+
+    size = strlen(s);
+
+    if (!size)
+            return s;
+
+    end = s + size - 1;
+    while (end >= s && isspace(*end))
+            end--;
+    *(end + 1) = '\0';
+
+    while (*s && isspace(*s))
+            s++;
+
+    return s;
+}
+
+// https://stackoverflow.com/questions/17333/what-is-the-most-effective-way-for-float-and-double-comparison
+bool AreSame(imginfo_ctx* ctx, double a, double b, double diff)
+{
+  if (ctx->iverb>2) {
+    imginfo_log(ctx, IMGINFO_DEBUG, "\n");
+    imginfo_log(ctx, IMGINFO_DEBUG, " AreSame : a    = %20.12e\n",a);
+    imginfo_log(ctx, IMGINFO_DEBUG, "           b    = %20.12e\n",b);
+    imginfo_log(ctx, IMGINFO_DEBUG, "           a-b  = %20.12e\n",fabs(a - b));
+    imginfo_log(ctx, IMGINFO_DEBUG, "           diff = %20.12e\n",diff);
+  }
+  return fabs(a - b) <= diff;
+}
+
+// (switching to the C locale for this thread only)
+bool stotime_t(time_t& result, const string& S, const string& format)
+{
+  struct tm tm;
+  locale_t cloc = newlocale(LC_TIME_MASK,"C",(locale_t)0);
+  locale_t oldloc = uselocale(cloc);
+  memset(&tm, 0, sizeof(tm));
+  bool ok = ( strptime(S.c_str(), format.c_str(), &tm) != NULL );
+  if (ok) result = timegm(&tm);
+  uselocale(oldloc);
+  freelocale(cloc);
+  return ok;
+}
+
+string time_ttos(const time_t& T, const string& format = "%d %b %Y %H:%M:%S")
+{
+  char Tbuf[200];
+  locale_t cloc = newlocale(LC_TIME_MASK,"C",(locale_t)0);
+  locale_t oldloc = uselocale(cloc);
+  struct tm W;
+  gmtime_r(&T, &W);
+  W.tm_isdst = -1;
+  strftime(Tbuf, sizeof(Tbuf)-3, format.c_str(), &W);
+  uselocale(oldloc);
+  freelocale(cloc);
+  return string(Tbuf);
+}
+
+int is_hdf5_eiger(const char* buffer)
+{
+  char sig[8];
+  int nchar = 8;
+  strycpy(sig, buffer, &nchar);
+  if ((sig[0] & 0xff)==0x89 &&
+      (sig[1] & 0xff)==0x48 &&
+      (sig[2] & 0xff)==0x44 &&
+      (sig[3] & 0xff)==0x46 &&
+      (sig[4] & 0xff)==0x0d &&
+      (sig[5] & 0xff)==0x0a ) {
+    return FORMAT_HDF5_EIGER;
+  } else {
+    return 0;
+  }
+}
+
+// register the compression filters we bring along (unless the HDF5
+// library knows them already), returns 0 on failure
+int register_filters(imginfo_ctx* ctx)
+{
+#ifdef USE_BITSHUFFLE
+  if (H5Zfilter_avail(BSHUF_H5FILTER)<=0 && bshuf_register_h5filter()<0) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unable to register Bitshuffle filter!\n\n");
+    return 0;
+  }
+#endif
+#ifdef USE_LZ4
+  if (H5Zfilter_avail(LZ4_FILTER)<=0 && H5Zregister(H5Z_LZ4)<0) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unable to register H5Z_LZ4!\n\n");
+    return 0;
+  }
+#endif
+  return 1;
+}
+
+// ==================================================================================================
+// get_header_XYZ
+// ==================================================================================================
+
+int get_header_eiger(imginfo_ctx* ctx, const char* path, const int imgnum, image_header* h)
+{
+
+  vector<string> fields;
+
+  hid_t fid;
+
+  // get directory part of input file (required for later reading data
+  // from external files)
+  char * t = arena_strdup(ctx->arena, path);
+  char *dir;
+  char epoch_date[20];
+  dir = dirname(t);
+
+  // for units see: http://download.nexusformat.org/doc/html/nxdl-types.html
+
+  // Open the file (unless still open from an earlier image)
+  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "\n Opening file %s\n\n",path);
+  if (ctx->file!=NULL && ctx->file->fid>=0) {
+    fid = ctx->file->fid;
+  } else {
+    timing_phase(ctx, IMGINFO_PHASE_OPEN);
+    fid = eiger_open(ctx, path);
+    if (fid<0) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unable to open file \"%s\"!\n\n",path);
+      ctx->fatal = 1;
+      return 0;
+    }
+    if (ctx->file!=NULL) ctx->file->fid = fid;
+  }
+  timing_phase(ctx, IMGINFO_PHASE_METADATA);
+
+  if (!register_filters(ctx)) {
+    eiger_close(ctx, fid);
+    ctx->fatal = 1;
+    return 0;
+  }
+
+  if (ctx->iverb>2)  {
+    hid_t cpl = H5Fget_create_plist(fid);
+    hdf5_list_filters(ctx, cpl);
+    H5Pclose(cpl);
+    if (ctx->fatal) {
+      eiger_close(ctx, fid);
+      return 0;
+    }
+  }
+
+  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/description\n");
+  char *description          = hdf5_read_char(ctx, fid,"/entry/instrument/detector/description");
+  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detector_number\n");
+  char *detector_number      = hdf5_read_char(ctx, fid,"/entry/instrument/detector/detector_number");
+  if (detector_number != NULL) {
+    h->detn = detector_number;
+  }
+  else {
+    if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/serial_number\n");
+    detector_number      = hdf5_read_char(ctx, fid,"/entry/instrument/detector/serial_number");
+    if (detector_number != NULL) {
+      h->detn = detector_number;
+    }
+  }
+
+  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/sensor_material\n");
+  char *sensor_material      = hdf5_read_char(ctx, fid,"/entry/instrument/detector/sensor_material");
+  if (sensor_material!=NULL) {
+    h->sensm = sensor_material;
+    if (h->sensm != "Si" && h->sensm != "CdTe" && h->sensm != "Silicon" ) {
+      imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: item \"/entry/instrument/detector/sensor_material\" gives material as \"%s\" when \"Silicon\" (or \"Si\" or \"CdTe\") seems more common!\n\n",sensor_material);
+    }
+  }
+  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/data_collection_date\n");
+  char *data_collection_date = hdf5_read_char(ctx, fid,"/entry/instrument/detector/detectorSpecific/data_collection_date");
+  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/eiger_fw_version\n");
+  char *eiger_fw_version     = hdf5_read_char(ctx, fid,"/entry/instrument/detector/detectorSpecific/eiger_fw_version");
+
+  if ( (data_collection_date == NULL) || (data_collection_date[0] == '\0') ) {
+
+    // check if we have /entry/start_time
+    if (ctx->iverb>2)        imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/start_time\n");
+    data_collection_date = hdf5_read_char(ctx, fid,"/entry/start_time");
+
+    if ( (data_collection_date == NULL) || (data_collection_date[0] == '\0') ) {
+      // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
+      data_collection_date = strcpy(epoch_date,"1970-01-01T00:00:01");
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     Setting date to \"%s\"\n",data_collection_date);
+    }
+
+  }
+  fields = tokenise_cbf_header(data_collection_date);
+  if (fields[0].length()==13) {
+    if ( (fields[0].substr(4,1) == "-") && (fields[0].substr(7,1) == "-") && (fields[0].substr(10,1) == "T") ) {
+      // 2015-11-10T17:17:02.057611
+      if (stotime_t(h->epoch,data_collection_date,"%Y-%m-%dT%H:%M:%S")) {
+	if (fields[2].substr(2,1) == ".") {
+	  h->msec = rintf((my_stoi(fields[2].substr(3))/1000.0));
+	}
+	h->date = time_ttos(h->epoch);
+      }
+    }
+  }
+
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/nimages\n");
+  int nimages     = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/nimages");
+
+  if (nimages==INIT_INT||nimages<=0) {
+    // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
+    char *axes = hdf5_read_group_attribute(ctx, fid,"/entry/data","axes");
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     axes = \"%s\"\n",axes);
+    if ( axes != NULL && strcmp(axes,"omega")==0 ) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     will determine nimages from /entry/data/omega\n");
+      nimages     = hdf5_read_dataset_size(ctx, fid,"/entry/data/omega");
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     nimages = \"%d\"\n",nimages);
+    }
+  } else {
+    if (nimages==INIT_INT) {
+      eiger_close(ctx, fid);
+      imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: no item \"/entry/instrument/detector/detectorSpecific/nimages\" found!\n\n");
+      return 0;
+    }
+    if (nimages==0) {
+      eiger_close(ctx, fid);
+      imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: no images found (\"/entry/instrument/detector/detectorSpecific/nimages\" is 0)!\n\n");
+      return 0;
+    }
+  }
+
+  int nimages_per_trigger = nimages;
+  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/ntrigger\n");
+  int ntrigger   = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/ntrigger");
+  if (ntrigger==INIT_INT||ntrigger<0) {
+    // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
+    ntrigger = 1;
+  } else {
+    if (ntrigger!=INIT_INT) {
+      if (ntrigger==0) {
+	imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: item \"/entry/instrument/detector/detectorSpecific/ntrigger\" is set to 0?\n");
+	ntrigger = 1;
+      }
+      else if (ntrigger<0) {
+	imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: item \"/entry/instrument/detector/detectorSpecific/ntrigger\" is set to negative value %d?\n",ntrigger);
+	ntrigger = 1;
+      }
+      else {
+	nimages = nimages_per_trigger * ntrigger;
+	if (ntrigger>1) {
+	  imginfo_log(ctx, IMGINFO_INFO, "\n Note: assuming a total of %d images (based on %d images for each of the %d triggers)\n",nimages,nimages_per_trigger,ntrigger);
+	}
+      }
+    } else {
+      ntrigger = 1;
+    }
+  }
+
+  int ntrigger_use = ntrigger;
+
+  int img = 0;
+  int img2 = nimages_per_trigger - 1;
+  if (imgnum>0) {
+    img = imgnum - 1;
+    ntrigger_use = 1;
+    img2 = img;
+  }
+
+  int *nimage_to_imgnum = (int *)arena_calloc(ctx->arena,nimages,sizeof(int));
+  if (nimage_to_imgnum == NULL) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: unable to allocate nimage_to_imgnum(nimages) array!\n\n");
+    return 0;
+  }
+  for (int inimage_to_imgnum = 1; inimage_to_imgnum <= nimages; inimage_to_imgnum++ ) {
+    nimage_to_imgnum[inimage_to_imgnum-1]=inimage_to_imgnum;
+  }
+
+  int img_offset = 0;
+  if (img>nimages) {
+    // enforce HDF5 checking (for obvious reasons). Remember that we
+    // could still have an undetected offset - which is why autoPROC
+    // enforces h5check throughout.
+    ctx->h5check++;
+  }
+
+  if (ctx->h5check>0) {
+    timing_phase(ctx, IMGINFO_PHASE_H5CHECK);
+    nimages = eiger_h5check_file(ctx, fid, path, dir, nimages, nimage_to_imgnum, h);
+    timing_phase(ctx, IMGINFO_PHASE_METADATA);
+    if (nimages==-2) {
+      eiger_close(ctx, fid);
+      return 0;
+    }
+    if (nimages==-1) {
+      return(-1);
+    }
+  }
+
+  int img1use = img;
+  int img2use = img2;
+
+  if (img>nimages) {
+
+    // if we requested an image outside the 1..nimages range:
+    if (ctx->h5check>0) {
+      // is it within our array of images
+      for (int iimg = 0; iimg < nimages; iimg++ ) {
+	if (nimage_to_imgnum[iimg]==(img+1)) {
+	  img1use = iimg;
+	  img2use = iimg + (img2 - img);
+	  break;
+	}
+      }
+    }
+    if (img1use>nimages) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: requested image number %d but only %d images present!\n\n",(img+1),nimages);
+      return 0;
+    }
+  }
+
+  // of the per-image angle arrays only the elements for the first and
+  // last image of each trigger requested (sel[itrigger] and
+  // sel[ntrigger_use+itrigger]) and the first two images (for the
+  // increments) are read - through one point selection per dataset
+  int nsel  = 2*ntrigger_use + 2;
+  int isel0 = nsel - 2;
+  int isel1 = nsel - 1;
+  int *sel = (int *)arena_alloc(ctx->arena,nsel*sizeof(int));
+  if (sel == NULL) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: unable to allocate sel(ntrigger*2+2) array!\n\n");
+    return 0;
+  }
+  for (int itrigger = 0; itrigger < ntrigger_use; itrigger++) {
+    sel[itrigger]              = img1use + itrigger*nimages_per_trigger;
+    sel[ntrigger_use+itrigger] = img2use + itrigger*nimages_per_trigger;
+  }
+  sel[isel0] = 0;
+  sel[isel1] = 1;
+
+  double *omega, *omega_end, *omega_axis;
+  double omega_range_average, omega_range_total, omega_increment = INIT_DOUBLE;
+  double *kappa, *kappa_end, *kappa_axis;
+  double kappa_range_average, kappa_range_total;
+  double *chi, *chi_end, *chi_axis;
+  double chi_range_average, chi_range_total;
+  double *phi, *phi_end, *phi_axis;
+  double phi_range_average, phi_range_total, phi_increment = INIT_DOUBLE;
+  double *two_theta, *two_theta_end, *two_theta_axis;
+  double two_theta_range_average, two_theta_range_total;
+
+  // where the per-image values come from (for a -per-image table)
+  axis_source src[NAXIS];
+
+  double *detector_distance_vector, *fast_pixel_vector, *slow_pixel_vector;
+  int ihave_omega     = 0;
+  int ihave_kappa     = 0;
+  int ihave_chi       = 0;
+  int ihave_phi       = 0;
+  int ihave_two_theta = 0;
+  int esgo = 0;
+  timing_phase(ctx, IMGINFO_PHASE_GONIOMETER);
+  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... check for /entry/sample\n");
+  if (hdf5_exists(ctx, fid,"/entry/sample")) {
+    if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... check for /entry/sample/goniometer\n");
+    if (hdf5_exists(ctx, fid,"/entry/sample/goniometer")) {
+      if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... check for /entry/sample/goniometer/omega\n");
+      if (hdf5_exists(ctx, fid,"/entry/sample/goniometer/omega")) {
+	if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/omega\n");
+	omega                   = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/omega","degree",nimages,sel,nsel);
+	if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/omega_end\n");
+	omega_end               = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/omega_end","degree",nimages,sel,nsel);
+	if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/omega_range_average\n");
+	omega_range_average     = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/omega_range_average","degree");
+	if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/omega_range_total\n");
+	omega_range_total       = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/omega_range_total","degree");
+	if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/omega_increment\n");
+	omega_increment         = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/omega_increment","degree");
+	if (isnan(omega_increment)&&nimages>1) {
+	  if (!isnan(omega[isel0])&&!isnan(omega[isel1])) {
+	    omega_increment = omega[isel1]-omega[isel0];
+	  }
+	}
+	axis_source_set(&src[AXIS_OMEGA], "/entry/sample/goniometer/omega", "/entry/sample/goniometer/omega_end", AXIS_END_DATASET, 0.0);
+	ihave_omega = 1;
+	esgo = 1;
+      }
+    }
+  }
+  if (ihave_omega==0) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... check axes\n");
+    // Diamond files (image_9264_master.h5, 20181105 12:56) don't have that field
+    char *axes = hdf5_read_group_attribute(ctx, fid,"/entry/data","axes");
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     axes = \"%s\"\n",axes);
+
+    int check_for_omega = 0;
+    char omega_str[CHAR_ARRAY_LEN] = "/entry/data/omega";
+
+    if (axes==NULL) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     axes undefined?\n");
+      check_for_omega = 1;
+    }
+    else if (strcmp(axes,"omega")==0 ) {
+      check_for_omega = 1;
+    }
+    // Diamond files (Mpro-P1623_2_master.h5, I04-1, 20210619 06:17) named that differently:
+    else if (strcmp(axes,"gonomega")==0 ) {
+      check_for_omega = 2;
+      strcpy(omega_str,"/entry/data/gonomega");
+    }
+    if (check_for_omega>=1) {
+      if (hdf5_exists(ctx, fid,omega_str)) {
+	if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read %s\n",omega_str);
+	omega                   = hdf5_read_ndouble_sel(ctx, fid,omega_str,"deg",nimages,sel,nsel);
+	if (!isnan(omega[isel0])&&!isnan(omega[isel1])) {
+	  omega_increment = omega[isel1]-omega[isel0];
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... setting omega_increment to %f\n",omega_increment);
+	  omega_end       = hdf5_read_ndouble_sel(ctx, fid,omega_str,"deg",nimages,sel,nsel);
+	  for(int i_image = 0; i_image < nsel; i_image++) {
+	    omega_end[i_image] = omega_end[i_image] + omega_increment;
+	  }
+	  axis_source_set(&src[AXIS_OMEGA], omega_str, "", AXIS_END_INC, omega_increment);
+	  ihave_omega = 1;
+	  esgo = 0;
+	}
+      }
+    } else {
+      if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, "     axes read/set as \"%s\"\n",axes);
+    }
+  }
+
+  if (esgo==1) {
+    if (hdf5_exists(ctx, fid,"/entry/sample")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/goniometer")) {
+	if (hdf5_exists(ctx, fid,"/entry/sample/goniometer/kappa")) {
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/kappa\n");
+	  kappa                   = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/kappa","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/kappa_end\n");
+	  kappa_end               = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/kappa_end","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/kappa_range_average\n");
+	  kappa_range_average     = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/kappa_range_average","degree");
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/kappa_range_total\n");
+	  kappa_range_total       = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/kappa_range_total","degree");
+	  axis_source_set(&src[AXIS_KAPPA], "/entry/sample/goniometer/kappa", "/entry/sample/goniometer/kappa_end", AXIS_END_DATASET, 0.0);
+	  ihave_kappa = 1;
+	}
+      }
+    }
+  }
+
+  if (esgo==0 && ihave_kappa==0) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... check /entry/sample/sample_kappa/kappa\n");
+    if (hdf5_exists(ctx, fid,"/entry/sample/sample_kappa")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/sample_kappa/kappa")) {
+	if (ctx->iverb>2) {
+	  int nd = hdf5_read_dataset_size(ctx, fid,"/entry/sample/sample_kappa/kappa");
+	  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read %d item(s) /entry/sample/sample_kappa/kappa\n",nd);
+	}
+	kappa = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/sample_kappa/kappa","degree",nimages,sel,nsel);
+	kappa_end = (double *) arena_alloc(ctx->arena,(nsel * sizeof (double)));
+	for (int id=0; id<nsel;id++ ) {
+	  kappa_end[id]=kappa[id];
+	}
+	kappa_range_average = 0.0;
+	kappa_range_total = 0.0;
+	axis_source_set(&src[AXIS_KAPPA], "/entry/sample/sample_kappa/kappa", "", AXIS_END_START, 0.0);
+	ihave_kappa=1;
+      }
+    }
+  }
+
+
+  if (esgo==1) {
+    if (hdf5_exists(ctx, fid,"/entry/sample")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/goniometer")) {
+	if (hdf5_exists(ctx, fid,"/entry/sample/goniometer/chi")) {
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/chi\n");
+	  chi                     = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/chi","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/chi_end\n");
+	  chi_end                 = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/chi_end","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/chi_range_average\n");
+	  chi_range_average       = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/chi_range_average","degree");
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/chi_range_total\n");
+	  chi_range_total         = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/chi_range_total","degree");
+	  axis_source_set(&src[AXIS_CHI], "/entry/sample/goniometer/chi", "/entry/sample/goniometer/chi_end", AXIS_END_DATASET, 0.0);
+	  ihave_chi = 1;
+	}
+      }
+    }
+  }
+
+  if (esgo==0 && ihave_chi==0) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... check /entry/sample/sample_chi/chi\n");
+    if (hdf5_exists(ctx, fid,"/entry/sample/sample_chi")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/sample_chi/chi")) {
+	if (ctx->iverb>2) {
+	  int nd = hdf5_read_dataset_size(ctx, fid,"/entry/sample/sample_chi/chi");
+	  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read %d item(s) /entry/sample/sample_chi/chi\n",nd);
+	}
+	chi = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/sample_chi/chi","degree",nimages,sel,nsel);
+	chi_end = (double *) arena_alloc(ctx->arena,(nsel * sizeof (double)));
+	for (int id=0; id<nsel;id++ ) {
+	  chi_end[id]=chi[id];
+	}
+	chi_range_average = 0.0;
+	chi_range_total = 0.0;
+	axis_source_set(&src[AXIS_CHI], "/entry/sample/sample_chi/chi", "", AXIS_END_START, 0.0);
+	ihave_chi=1;
+      }
+    }
+  }
+
+  if (esgo==1) {
+    if (hdf5_exists(ctx, fid,"/entry/sample")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/goniometer")) {
+	if (hdf5_exists(ctx, fid,"/entry/sample/goniometer/phi")) {
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/phi\n");
+	  phi                     = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/phi","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/phi_end\n");
+	  phi_end                 = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/goniometer/phi_end","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/phi_range_average\n");
+	  phi_range_average       = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/phi_range_average","degree");
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/phi_range_total\n");
+	  phi_range_total         = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/phi_range_total","degree");
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/sample/goniometer/phi_increment\n");
+	  phi_increment           = hdf5_read_double(ctx, fid,"/entry/sample/goniometer/phi_increment","degree");
+	  if (isnan(phi_increment)&&nimages>1) {
+	    if (!isnan(phi[isel0])&&!isnan(phi[isel1])) {
+	      phi_increment = phi[isel1]-phi[isel0];
+	    }
+	  }
+	  axis_source_set(&src[AXIS_PHI], "/entry/sample/goniometer/phi", "/entry/sample/goniometer/phi_end", AXIS_END_DATASET, 0.0);
+	  ihave_phi = 1;
+	}
+      }
+    }
+  }
+
+  if (esgo==0 && ihave_phi==0) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... check /entry/sample/sample_phi/phi\n");
+    if (hdf5_exists(ctx, fid,"/entry/sample/sample_phi")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/sample_phi/phi")) {
+	int nd = hdf5_read_dataset_size(ctx, fid,"/entry/sample/sample_phi/phi");
+	if (ctx->iverb>2) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read %d item(s) /entry/sample/sample_phi/phi\n",nd);
+	}
+	phi = hdf5_read_ndouble_sel(ctx, fid,"/entry/sample/sample_phi/phi","degree",nimages,sel,nsel);
+	phi_end = (double *) arena_alloc(ctx->arena,(nsel * sizeof (double)));
+	if (nd==1) {
+	  for (int id=0; id<nsel;id++ ) {
+	    phi_end[id]=phi[id];
+	  }
+	  phi_range_average = 0.0;
+	  phi_range_total = 0.0;
+	  phi_increment = 0.0;
+	} else {
+	  phi_increment = phi[isel1]-phi[isel0];
+	  for (int id=0; id<nsel;id++ ) {
+	    phi_end[id]=phi[id]+phi_increment;
+	  }
+	  phi_range_average = phi_increment;
+	  phi_range_total = nimages*phi_increment;
+	}
+	axis_source_set(&src[AXIS_PHI], "/entry/sample/sample_phi/phi", "", (nd==1) ? AXIS_END_START : AXIS_END_INC, phi_increment);
+	ihave_phi=1;
+      }
+    }
+  }
+
+  if (esgo==1) {
+    if (hdf5_exists(ctx, fid,"/entry/sample")) {
+      if (hdf5_exists(ctx, fid,"/entry/sample/goniometer")) {
+	if (hdf5_exists(ctx, fid,"/entry/sample/goniometer/two_theta")) {
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/goniometer/two_theta\n");
+	  two_theta               = hdf5_read_ndouble_sel(ctx, fid,"/entry/instrument/detector/goniometer/two_theta","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/goniometer/two_theta_end\n");
+	  two_theta_end           = hdf5_read_ndouble_sel(ctx, fid,"/entry/instrument/detector/goniometer/two_theta_end","degree",nimages,sel,nsel);
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/goniometer/two_theta_range_average\n");
+	  two_theta_range_average = hdf5_read_double(ctx, fid,"/entry/instrument/detector/goniometer/two_theta_range_average","degree");
+	  if (ctx->iverb>2)              imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/goniometer/two_theta_range_total\n");
+	  two_theta_range_total   = hdf5_read_double(ctx, fid,"/entry/instrument/detector/goniometer/two_theta_range_total","degree");
+	  axis_source_set(&src[AXIS_TWO_THETA], "/entry/instrument/detector/goniometer/two_theta", "/entry/instrument/detector/goniometer/two_theta_end", AXIS_END_DATASET, 0.0);
+	  ihave_two_theta = 1;
+	}
+      }
+    }
+  }
+
+  if (!isnan(omega_increment)) {
+    if (omega_increment>0.0) {
+      if (isnan(phi_increment)||phi_increment==0.0) {
+	imginfo_log(ctx, IMGINFO_INFO, " rotation axis = \"OMEGA\"\n");
+	h->rota = "OMEGA";
+      }
+      else if (phi_increment>0.0) {
+	imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: it seems both OMEGA and PHI increments are set to non-zero values: %f %f ?\n",omega_increment,phi_increment);
+      }
+    }
+    else if (phi_increment>0.0) {
+      imginfo_log(ctx, IMGINFO_INFO, " rotation axis = \"PHI\"\n");
+      h->rota = "PHI";
+    }
+  }
+
+  // start and end angles of the first and last image of each trigger:
+  // one array per axis, the first images at [itrigger] and the last ones
+  // at [ntrigger_use+itrigger]
+  int     ihave[NAXIS]     = { ihave_omega, ihave_kappa, ihave_chi, ihave_phi, ihave_two_theta };
+  double *axis_start[NAXIS] = { omega, kappa, chi, phi, two_theta };
+  double *axis_end[NAXIS]   = { omega_end, kappa_end, chi_end, phi_end, two_theta_end };
+  double *trigger_start[NAXIS], *trigger_end[NAXIS];
+  for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+    trigger_start[iaxis] = (double *)arena_calloc(ctx->arena,ntrigger_use*2,sizeof(double));
+    trigger_end[iaxis]   = (double *)arena_calloc(ctx->arena,ntrigger_use*2,sizeof(double));
+    if (trigger_start[iaxis] == NULL || trigger_end[iaxis] == NULL) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: unable to allocate trigger_start/end(ntrigger*2) arrays!\n\n");
+      return 0;
+    }
+    if (ihave[iaxis]==0) continue;
+    const double *v = axis_start[iaxis];
+    const double *e = axis_end[iaxis];
+    for (int i = 0; i < ntrigger_use*2; i++) {
+      if (!isnan(v[i])) {
+	trigger_start[iaxis][i] = v[i];
+	trigger_end[iaxis][i]   = isnan(e[i]) ? v[i] : e[i];
+      }
+    }
+  }
+  if (ihave_omega==1 && !isnan(omega[0])) {
+    h->omes = trigger_start[AXIS_OMEGA][0];
+    h->omee = trigger_end[AXIS_OMEGA][0];
+  }
+  if (ihave_kappa==1 && !isnan(kappa[0])) {
+    h->kaps = trigger_start[AXIS_KAPPA][0];
+    h->kape = trigger_end[AXIS_KAPPA][0];
+  }
+  if (ihave_chi==1 && !isnan(chi[0])) {
+    h->chis = trigger_start[AXIS_CHI][0];
+    h->chie = trigger_end[AXIS_CHI][0];
+  }
+  if (ihave_phi==1 && !isnan(phi[0])) {
+    h->phis = trigger_start[AXIS_PHI][0];
+    h->phie = trigger_end[AXIS_PHI][0];
+  }
+  if (ihave_two_theta==1 && !isnan(two_theta[0])) {
+    h->twot = trigger_start[AXIS_TWO_THETA][0];
+  }
+
+  // a trigger is a continuation (in terms of angles) of the previous one
+  // if it starts on all axes where that one ended - a branch-free pass
+  // over each axis
+  unsigned char *continuation = (unsigned char *)arena_calloc(ctx->arena,ntrigger_use,1);
+  if (continuation == NULL) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n ERROR: unable to allocate continuation(ntrigger) array!\n\n");
+    return 0;
+  }
+  for (int itrigger = 1; itrigger < ntrigger_use; itrigger++) {
+    continuation[itrigger] = 1;
+  }
+  for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+    if (ihave[iaxis]==0) continue;
+    const double *ts = trigger_start[iaxis];
+    const double *te = trigger_end[iaxis] + ntrigger_use;
+    for (int itrigger = 1; itrigger < ntrigger_use; itrigger++) {
+      continuation[itrigger] &= ( fabs(ts[itrigger] - te[itrigger-1]) < 0.001 );
+    }
+  }
+  int ndatasets = 0;
+  for (int itrigger = 0; itrigger < ntrigger_use; itrigger++) {
+    ndatasets += !continuation[itrigger];
+  }
+
+  // one sweep per trigger - reported one by one or, with sweep_summary,
+  // as runs of continuations
+  for (int itrigger = 0; itrigger < ntrigger_use; itrigger++) {
+    int ilast = itrigger;
+    if (ctx->sweep_summary) {
+      while (ilast+1 < ntrigger_use && continuation[ilast+1]) ilast++;
+    }
+    if (itrigger>0) {
+      if (continuation[itrigger]) {
+	imginfo_log(ctx, IMGINFO_INFO, " Sweep-%-4d : continuation from previous\n",(itrigger+1));
+      } else {
+	imginfo_log(ctx, IMGINFO_INFO, "\n Sweep-%-4d : independent sweep\n",(itrigger+1));
+      }
+    } else {
+      if ((img+1)<(img2+1)) {
+	imginfo_log(ctx, IMGINFO_INFO, "\n Sweep-%-4d :\n",(itrigger+1));
+      }
+    }
+    if (ilast>itrigger) {
+      imginfo_log(ctx, IMGINFO_INFO, " Sweep-%-4d .. Sweep-%-4d : %d continuations\n",(itrigger+2),(ilast+1),(ilast-itrigger));
+    }
+
+    if ((img+1)<(img2+1)) {
+      // the per-trigger image numbers
+      for (int jtrigger = itrigger; jtrigger <= ilast; jtrigger++) {
+	int imgnum_1 = (img +1) + jtrigger*nimages_per_trigger;
+	int imgnum_2 = (img2+1) + jtrigger*nimages_per_trigger;
+	if (ctx->h5check>0) {
+	  if (sel[jtrigger]<nimages)              imgnum_1 = nimage_to_imgnum[sel[jtrigger]];
+	  if (sel[ntrigger_use+jtrigger]<nimages) imgnum_2 = nimage_to_imgnum[sel[ntrigger_use+jtrigger]];
+	}
+	int j1 = jtrigger;
+	int j2 = ntrigger_use+jtrigger;
+	image_sweep sw;
+	sw.cont = continuation[jtrigger];
+	sw.img1 = imgnum_1;
+	sw.img2 = imgnum_2;
+	double *sw_angle[NAXIS] = { sw.omeg, sw.kapp, sw.chi, sw.phi, sw.twot };
+	for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+	  sw_angle[iaxis][0] = trigger_start[iaxis][j1];
+	  sw_angle[iaxis][1] = trigger_end[iaxis][j1];
+	  sw_angle[iaxis][2] = trigger_start[iaxis][j2];
+	  sw_angle[iaxis][3] = trigger_end[iaxis][j2];
+	}
+	h->swps.push_back(sw);
+      }
+      const image_sweep *sw1 = &h->swps[h->swps.size()-1-(ilast-itrigger)];
+      const image_sweep *sw2 = &h->swps.back();
+      imginfo_log(ctx, IMGINFO_INFO, "   from image %6d : Omega= %8.3f .. %8.3f  Kappa= %8.3f .. %8.3f  Chi= %8.3f .. %8.3f  Phi= %8.3f .. %8.3f  2-Theta= %8.3f .. %8.3f\n",sw1->img1,sw1->omeg[0],sw1->omeg[1],sw1->kapp[0],sw1->kapp[1],sw1->chi[0],sw1->chi[1],sw1->phi[0],sw1->phi[1],sw1->twot[0],sw1->twot[1]);
+      imginfo_log(ctx, IMGINFO_INFO, "   to   image %6d : Omega= %8.3f .. %8.3f  Kappa= %8.3f .. %8.3f  Chi= %8.3f .. %8.3f  Phi= %8.3f .. %8.3f  2-Theta= %8.3f .. %8.3f\n",sw2->img2,sw2->omeg[2],sw2->omeg[3],sw2->kapp[2],sw2->kapp[3],sw2->chi[2],sw2->chi[3],sw2->phi[2],sw2->phi[3],sw2->twot[2],sw2->twot[3]);
+    }
+    itrigger = ilast;
+  }
+
+  if (ntrigger>1) {
+    if (ndatasets==ntrigger) {
+      imginfo_log(ctx, IMGINFO_INFO, "\n Note: it seems that we have %d independent datasets consisting of %d images each.\n",ndatasets,nimages_per_trigger);
+    }
+    else if (ndatasets==1) {
+      imginfo_log(ctx, IMGINFO_INFO, "\n Note: it seems that we have %d dataset consisting of %d images.\n",ndatasets,nimages);
+    }
+    else if (ndatasets>ntrigger) {
+      imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: there seems to be more datasets (%d) defined than we have triggers (%d) - how is that possible?\n",ndatasets,ntrigger);
+    }
+    else {
+      imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: there seems to be fewer datasets (%d) defined than we have triggers (%d) - a mixture of related and independent sweeps?\n",ndatasets,ntrigger);
+    }
+    imginfo_log(ctx, IMGINFO_INFO, "\n");
+  }
+
+  int is_standard_eiger=0;
+  if (esgo==1) {
+    if (eiger_fw_version!=NULL) {
+      if (eiger_fw_version[0]!='\0') {
+	is_standard_eiger = 1;
+      }
+    }
+  }
+  if (is_standard_eiger==1) {
+    if (ctx->iverb>0) imginfo_log(ctx, IMGINFO_DEBUG, "\n Seems to be standard Eiger/HDF5 file\n\n");
+  }
+  else {
+    if (ctx->iverb>0) imginfo_log(ctx, IMGINFO_DEBUG, "\n Seems to be non-standard Eiger/HDF5 file\n\n");
+  }
+
+
+  if (ctx->h5check>0) {
+    img_offset = nimage_to_imgnum[img1use] - (img1use + 1 );
+    imginfo_log(ctx, IMGINFO_INFO, "     Image number %d/%d\n\n",nimage_to_imgnum[img1use],nimage_to_imgnum[(nimages-1)]);
+    h->imgn = nimage_to_imgnum[img1use];
+    h->imgl = nimage_to_imgnum[(nimages-1)];
+  } else {
+    imginfo_log(ctx, IMGINFO_INFO, "     Image number %d/%d\n\n",(img1use+1),nimages);
+    h->imgn = img1use+1;
+    h->imgl = nimages;
+  }
+  h->nimg = nimages;
+  h->ntrg = ntrigger;
+  h->imgo = img_offset;
+
+  if (img_offset>0) {
+    imginfo_log(ctx, IMGINFO_INFO, "     Offset between image number name and image number position = %d\n\n",img_offset);
+  }
+
+  if (ctx->per_image!=NULL) {
+    int first = 0, count = nimages;
+    if (imgnum>0) {
+      first = img1use;
+      count = 1;
+    }
+    timing_phase(ctx, IMGINFO_PHASE_PER_IMAGE);
+    eiger_per_image(ctx, fid, src, first, count, nimages, nimages_per_trigger,
+                    (ctx->h5check>0) ? nimage_to_imgnum : NULL);
+  }
+  timing_phase(ctx, IMGINFO_PHASE_GONIOMETER);
+
+  // get axis definitions
+  if (hdf5_exists(ctx, fid,"/entry/sample")) {
+    if (hdf5_exists(ctx, fid,"/entry/sample/transformations")) {
+      char omega_str[CHAR_ARRAY_LEN] = "";
+      if (hdf5_exists(ctx, fid,"/entry/sample/transformations/omega")) {
+        strcpy(omega_str,"/entry/sample/transformations/omega");
+      }
+      else if (hdf5_exists(ctx, fid,"/entry/sample/transformations/gonomega")) {
+        strcpy(omega_str,"/entry/sample/transformations/gonomega");
+      }
+      if (omega_str[0]!=0) {
+	omega_axis     = hdf5_read_axis_vector(ctx, fid,omega_str);
+        if (!isnan(omega_axis[0])&&!isnan(omega_axis[1])&&!isnan(omega_axis[2])) {
+          if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " omega axis   = %8.5f %8.5f %8.5f\n",omega_axis[0],omega_axis[1],omega_axis[2]);
+        }
+      }
+
+      if (hdf5_exists(ctx, fid,"/entry/sample/transformations/kappa")) {
+	kappa_axis     = hdf5_read_axis_vector(ctx, fid,"/entry/sample/transformations/kappa");
+	if (!isnan(kappa_axis[0])&&!isnan(kappa_axis[1])&&!isnan(kappa_axis[2])) {
+	  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " kappa axis   = %8.5f %8.5f %8.5f\n",kappa_axis[0],kappa_axis[1],kappa_axis[2]);
+	}
+      }
+      if (hdf5_exists(ctx, fid,"/entry/sample/transformations/chi")) {
+	chi_axis       = hdf5_read_axis_vector(ctx, fid,"/entry/sample/transformations/chi");
+	if (!isnan(chi_axis[0])&&!isnan(chi_axis[1])&&!isnan(chi_axis[2])) {
+	  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " chi axis     = %8.5f %8.5f %8.5f\n",chi_axis[0],chi_axis[1],chi_axis[2]);
+	}
+      }
+      if (hdf5_exists(ctx, fid,"/entry/sample/transformations/phi")) {
+	phi_axis       = hdf5_read_axis_vector(ctx, fid,"/entry/sample/transformations/phi");
+	if (!isnan(phi_axis[0])&&!isnan(phi_axis[1])&&!isnan(phi_axis[2])) {
+	  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " phi axis     = %8.5f %8.5f %8.5f\n",phi_axis[0],phi_axis[1],phi_axis[2]);
+	}
+      }
+      if (hdf5_exists(ctx, fid,"/entry/sample/transformations/two_theta")) {
+	two_theta_axis = hdf5_read_axis_vector(ctx, fid,"/entry/sample/transformations/two_theta");
+	if (!isnan(two_theta_axis[0])&&!isnan(two_theta_axis[1])&&!isnan(two_theta_axis[2])) {
+	  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " 2-theta axis = %8.5f %8.5f %8.5f\n",two_theta_axis[0],two_theta_axis[1],two_theta_axis[2]);
+	}
+      }
+    }
+  }
+
+  if (hdf5_exists(ctx, fid,"/entry/instrument")) {
+    if (hdf5_exists(ctx, fid,"/entry/instrument/detector")) {
+      if (hdf5_exists(ctx, fid,"/entry/instrument/detector/detector_distance")) {
+	detector_distance_vector =  hdf5_read_axis_vector(ctx, fid,"/entry/instrument/detector/detector_distance");
+	if (!isnan(detector_distance_vector[0])&&!isnan(detector_distance_vector[1])&&!isnan(detector_distance_vector[2])) {
+	  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " detector distance vector = %8.5f %8.5f %8.5f\n",detector_distance_vector[0],detector_distance_vector[1],detector_distance_vector[2]);
+	}
+      }
+      if (hdf5_exists(ctx, fid,"/entry/instrument/detector/module")) {
+	if (hdf5_exists(ctx, fid,"/entry/instrument/detector/module/fast_pixel_direction")) {
+	  fast_pixel_vector =  hdf5_read_axis_vector(ctx, fid,"/entry/instrument/detector/module/fast_pixel_direction");
+	  if (!isnan(fast_pixel_vector[0])&&!isnan(fast_pixel_vector[1])&&!isnan(fast_pixel_vector[2])) {
+	    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " fast pixel vector = %8.5f %8.5f %8.5f\n",fast_pixel_vector[0],fast_pixel_vector[1],fast_pixel_vector[2]);
+	  }
+	}
+	if (hdf5_exists(ctx, fid,"/entry/instrument/detector/module/slow_pixel_direction")) {
+	  slow_pixel_vector =  hdf5_read_axis_vector(ctx, fid,"/entry/instrument/detector/module/slow_pixel_direction");
+	  if (!isnan(slow_pixel_vector[0])&&!isnan(slow_pixel_vector[1])&&!isnan(slow_pixel_vector[2])) {
+	    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " slow pixel vector = %8.5f %8.5f %8.5f\n",slow_pixel_vector[0],slow_pixel_vector[1],slow_pixel_vector[2]);
+	  }
+	}
+      }
+    }
+  }
+  timing_phase(ctx, IMGINFO_PHASE_METADATA);
+
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/beam/incident_wavelength\n");
+  double wave  = hdf5_read_double(ctx, fid,"/entry/instrument/beam/incident_wavelength","angstrom");
+  if (!isnan(wave)) h->wave = (float) wave;
+
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/beam_center_x\n");
+  double beamx = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_center_x","pixel");
+  if (isnan(beamx)) {
+    beamx = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_centre_x","pixel");
+  }
+  if (isnan(beamx)) {
+    beamx = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_center_x","pixels");
+  }
+  if (isnan(beamx)) {
+    beamx = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_centre_x","pixels");
+  }
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/beam_center_y\n");
+  double beamy = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_center_y","pixel");
+  if (isnan(beamy)) {
+    beamy = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_centre_y","pixel");
+  }
+  if (isnan(beamy)) {
+    beamy = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_center_y","pixels");
+  }
+  if (isnan(beamy)) {
+    beamy = hdf5_read_double(ctx, fid,"/entry/instrument/detector/beam_centre_y","pixels");
+  }
+  if (!isnan(beamx)&&!isnan(beamy)) {
+    h->beax = (float) beamx;
+    h->beay = (float) beamy;
+  }
+
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detector_distance\n");
+  double dist  = hdf5_read_double(ctx, fid,"/entry/instrument/detector/detector_distance","m");
+  if (isnan(dist)) {
+    if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector_distance\n");
+    dist  = hdf5_read_double(ctx, fid,"/entry/instrument/detector_distance","m");
+    if (isnan(dist)) {
+      if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/distance\n");
+      dist  = hdf5_read_double(ctx, fid,"/entry/instrument/detector/distance","m");
+    }
+  }
+  if (!isnan(dist)) h->dist = (float) dist*1000.0;
+
+  if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/count_time\n");
+  double count_time   = hdf5_read_double(ctx, fid,"/entry/instrument/detector/count_time","s");
+  if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/frame_time\n");
+  double frame_time   = hdf5_read_double(ctx, fid,"/entry/instrument/detector/frame_time","s");
+  if (isnan(frame_time)) {
+    if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/count_time\n");
+    double count_time   = hdf5_read_double(ctx, fid,"/entry/instrument/detector/count_time","s");
+    h->etime = count_time;
+  } else {
+    h->etime = frame_time;
+  }
+  if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detector_readout_time\n");
+  double readout_time = hdf5_read_double(ctx, fid,"/entry/instrument/detector/detector_readout_time","s");
+
+  int nx = INIT_INT;
+  int ny = INIT_INT;
+  if (hdf5_exists(ctx, fid,"/entry/instrument/detector/detectorSpecific/x_pixels_in_detector")) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/x_pixels_in_detector\n");
+    nx   = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/x_pixels_in_detector");
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/y_pixels_in_detector\n");
+    ny   = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/y_pixels_in_detector");
+  }
+  else if (hdf5_exists(ctx, fid,"/entry/instrument/detector/detectorSpecific/x_pixels")) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/x_pixels\n");
+    nx   = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/x_pixels");
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/y_pixels\n");
+    ny   = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/y_pixels");
+  }
+  else {
+    int n_nxny = 2;
+    int *nxny = hdf5_read_nint(ctx, fid,"/entry/instrument/detector/module/data_size",&n_nxny);
+    if (nxny[0]!=INIT_INT) {
+      // according to https://manual.nexusformat.org/classes/applications/NXmx.html
+      //   ... order of indices is the same as for data_origin.
+      //   The order of indices (i, j or i, j, k) is slow to fast.
+      // see also: https://manual.nexusformat.org/datarules.html#design-arraystorageorder
+      nx = nxny[1];
+      ny = nxny[0];
+    }
+  }
+
+  if (nx!=INIT_INT&&ny!=INIT_INT) {
+    h->numx = nx;
+    h->numy = ny;
+  }
+
+  double px = INIT_DOUBLE;
+  double py = INIT_DOUBLE;
+  if (hdf5_exists(ctx, fid,"/entry/instrument/detector/x_pixel_size")) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/x_pixel_size\n");
+    px   = hdf5_read_double(ctx, fid,"/entry/instrument/detector/x_pixel_size","m");
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/y_pixel_size\n");
+    py   = hdf5_read_double(ctx, fid,"/entry/instrument/detector/y_pixel_size","m");
+  }
+  if (!isnan(px)&&!isnan(py)) {
+    h->pixx = (float) px*1000.0;
+    h->pixy = (float) py*1000.0;
+  }
+
+  // given in m:
+  if (ctx->iverb>2)             imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/sensor_thickness\n");
+  double sensor_thickness = hdf5_read_double(ctx, fid,"/entry/instrument/detector/sensor_thickness","m");
+  if (!isnan(sensor_thickness)) {
+    h->thick = (float) sensor_thickness * 1000.0;
+    if (h->thick>=320.0) {
+      imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: item \"/entry/instrument/detector/sensor_thickness\" gives value\n");
+      imginfo_log(ctx, IMGINFO_WARNING, "          of %.2f mm - which doesn't make sense. We will adjust this\n",h->thick);
+      imginfo_log(ctx, IMGINFO_WARNING, "          to %.5f, but please check your beamline/instrument!\n",(h->thick/1000.0));
+      h->thick = h->thick / 1000.0;
+    }
+  }
+
+  if (ctx->iverb>2)             imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/threshold_energy\n");
+  double threshold_energy = hdf5_read_double(ctx, fid,"/entry/instrument/detector/threshold_energy","eV");
+
+  if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/countrate_correction_count_cutoff\n");
+  int count_cutoff = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/countrate_correction_count_cutoff");
+  if (count_cutoff!=INIT_INT) {
+    h->ovld = count_cutoff;
+  } else {
+    if (ctx->iverb>2)         imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/saturation_value\n");
+    count_cutoff = hdf5_read_int(ctx, fid,"/entry/instrument/detector/saturation_value");
+    if (count_cutoff!=INIT_INT) {
+      h->ovld = count_cutoff;
+    }
+  }
+
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/nframes_sum\n");
+  int nframes_sum = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/nframes_sum");
+  if (ctx->iverb>2)  imginfo_log(ctx, IMGINFO_DEBUG, " ... will read /entry/instrument/detector/detectorSpecific/nsequences\n");
+  int nsequences  = hdf5_read_int(ctx, fid,"/entry/instrument/detector/detectorSpecific/nsequences");
+
+  /* Close file */
+  timing_phase(ctx, IMGINFO_PHASE_CLOSE);
+  eiger_close(ctx, fid);
+  timing_phase(ctx, IMGINFO_PHASE_METADATA);
+
+ 
+  return 1;
+}
+
+
+// ==================================================================================================
+// -h5check of a master file
+//   check that all nimages images can be reached through the external
+//   links in /entry/data, filling nimage_to_imgnum with the image numbers
+//   found (and h->extf, h->filt). Returns the number of images to use,
+//   -1 if the file should be given up on and -2 if it is fatal. Through
+//   a file handle this is done once, later images of the file get the
+//   same results (and report).
+// ==================================================================================================
+int eiger_h5check_file(imginfo_ctx* ctx, hid_t fid, const char* path, const char* dir,
+                       int nimages, int* nimage_to_imgnum, image_header* h)
+{
+  if (ctx->file==NULL || fid!=ctx->file->fid) {
+    return eiger_h5check(ctx, fid, path, dir, nimages, nimage_to_imgnum, h);
+  }
+  h5check_memo& m = ctx->file->check;
+  if (!m.done) {
+    size_t report0 = ctx->res->report.size();
+    size_t diags0  = ctx->res->diags.size();
+    size_t extf0   = h->extf.size();
+    size_t filt0   = h->filt.size();
+    int n = eiger_h5check(ctx, fid, path, dir, nimages, nimage_to_imgnum, h);
+    if (n==-2) return n;
+    m.done    = 1;
+    m.nimages = n;
+    m.nimage_to_imgnum.assign(nimage_to_imgnum, nimage_to_imgnum + nimages);
+    m.extf.assign(h->extf.begin() + extf0, h->extf.end());
+    m.filt.assign(h->filt.begin() + filt0, h->filt.end());
+    m.nmis    = h->nmis;
+    m.report = ctx->res->report.substr(report0);
+    m.diags.assign(ctx->res->diags.begin() + diags0, ctx->res->diags.end());
+    return n;
+  }
+  imginfo_log_text(ctx, m.report, m.diags);
+  std::copy(m.nimage_to_imgnum.begin(), m.nimage_to_imgnum.end(), nimage_to_imgnum);
+  h->extf.insert(h->extf.end(), m.extf.begin(), m.extf.end());
+  h->filt.insert(h->filt.end(), m.filt.begin(), m.filt.end());
+  h->nmis = m.nmis;
+  return m.nimages;
+}
+
+int eiger_h5check(imginfo_ctx* ctx, hid_t fid, const char* path, const char* dir,
+                  int nimages, int* nimage_to_imgnum, image_header* h)
+{
+  // need to check for accessibility of all nimages images
+  hid_t gid = H5Gopen2(fid,"/entry/data",H5P_DEFAULT);
+  if (gid < 0) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Gopen2 (group=\"/entry/data\")!\n\n");
+    return(-1);
+  }
+  // single pass over all links in /entry/data: type, target file and
+  // dataset path of each one
+  h5_census hcen;
+  hcen.ctx = ctx;
+  vector<h5_link>& census = hcen.links;
+  if (H5Literate(gid, H5_INDEX_NAME, H5_ITER_INC, NULL, h5check_census_link, &hcen)<0) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Literate (group=\"/entry/data\")!\n\n");
+    H5Gclose(gid);
+    return(-1);
+  }
+  if (ctx->iverb>2) {
+    imginfo_log(ctx, IMGINFO_DEBUG, "   nlinks in group /entry/data = %d\n", (int)census.size());
+  }
+
+  vector<h5check_link> links;
+  for (size_t ilink=0; ilink<census.size(); ilink++) {
+    const char *link_name = census[ilink].name.c_str();
+    if (ctx->iverb>2) {
+	if (census[ilink].type==H5L_TYPE_HARD) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     link #%d (hard) = \"%s\"\n", (int) ilink, link_name);
+	}
+	else if (census[ilink].type==H5L_TYPE_SOFT) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     link #%d (soft) = \"%s\"\n", (int) ilink, link_name);
+	}
+	else if (census[ilink].type==H5L_TYPE_EXTERNAL) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     link #%d (external) = \"%s\"\n", (int) ilink, link_name);
+	}
+	else if (census[ilink].type==H5L_TYPE_ERROR) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     link #%d (error) = \"%s\"\n", (int) ilink, link_name);
+	}
+	else {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     link #%d gave error\n", (int) ilink);
+	}
+    }
+
+    // every external link is taken to point to (part of) the images -
+    // no matter what it is called or whether there are gaps in the
+    // numbering
+    if (census[ilink].type!=H5L_TYPE_EXTERNAL && census[ilink].type!=H5L_TYPE_HARD) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR: unsupported link type for /entry/data/%s !\n\n",link_name);
+    }
+    if (census[ilink].type==H5L_TYPE_EXTERNAL) {
+	h5check_link l;
+	l.link     = string("/entry/data/") + census[ilink].name;
+	l.dir      = dir;
+	l.filename = census[ilink].filename;
+	l.file     = string(dir) + "/" + census[ilink].filename;
+	l.path     = census[ilink].path;
+	links.push_back(l);
+	h->extf.push_back(l.file);
+    }
+  }
+
+  if (ctx->iverb>2) {
+    imginfo_log(ctx, IMGINFO_DEBUG, "\n");
+  }
+
+  if (H5Gclose(gid)<0) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Gclose!\n\n");
+    return(-1);
+  }
+
+  // open and check the external files, possibly several at the same
+  // time
+  h5check_state hc;
+  hc.ctx                = ctx;
+  hc.fid                = fid;
+  hc.links              = &links;
+  hc.nimage_to_imgnum   = nimage_to_imgnum;
+  hc.nimages            = nimages;
+  hc.nimages_found      = 0;
+  hc.have_image_nr_high = 1;
+  hc.action             = H5CHECK_CONTINUE;
+  hc.first              = 0;
+  hc.nmissing           = 0;
+  if (ctx->h5resume.size()>0) {
+    hc.first = h5resume_load(ctx, ctx->h5resume, path, &links);
+  }
+  h5check_links(&hc, ctx->h5jobs);
+  if (ctx->h5resume.size()>0) {
+    h5resume_save(ctx, ctx->h5resume, path, &links, hc.nverified);
+  }
+  if (hc.action==H5CHECK_EXIT) {
+    ctx->fatal = 1;
+    return(-2);
+  }
+  if (hc.action==H5CHECK_RETURN) {
+    return(-1);
+  }
+  int nimages_found = hc.nimages_found;
+  h->nmis = hc.nmissing;
+  // -verify needs to know how many frames to count as bad for a data
+  // file that can't be read later on
+  if (ctx->file!=NULL && fid==ctx->file->fid) {
+    for (size_t ilink = 0; ilink < links.size(); ilink++) {
+      const h5check_result* r = &links[ilink].r;
+      if (r->status!=H5CHECK_LINK_OK) continue;
+      if (r->image_nr==H5CHECK_NR_READ) {
+        ctx->file->check.nframes[links[ilink].link] = r->image_nr_high - r->image_nr_low + 1;
+      }
+      else if (r->image_nr==H5CHECK_NR_NONE) {
+        ctx->file->check.nframes[links[ilink].link] = (int) r->dims0;
+      }
+    }
+  }
+
+  // filters used for the image data (as found in the first data file)
+  if (!links.empty() && links[0].r.status==H5CHECK_LINK_OK) {
+    hid_t did;
+    H5E_BEGIN_TRY {
+      did = H5Dopen2(fid, links[0].link.c_str(), hdf5_apl(ctx, fid, H5P_DATASET_ACCESS));
+    } H5E_END_TRY;
+    if (did>=0) {
+      hid_t cpl = H5Dget_create_plist(did);
+      hdf5_get_filters(cpl, h->filt);
+      H5Pclose(cpl);
+      H5Dclose(did);
+    }
+  }
+
+  if (nimages<nimages_found) {
+    imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: there seem to be more images in the EXTERNAL LINK files (%d) than we\n",nimages_found);
+    imginfo_log(ctx, IMGINFO_WARNING, "          expected (%d) - which doesn't make much sense. Please check with beamline\n",nimages);
+    imginfo_log(ctx, IMGINFO_WARNING, "          staff and get back to us!\n");
+  }
+  else if (nimages>nimages_found) {
+    imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: there seem to be fewer images in the EXTERNAL LINK files (%d) than we\n",nimages_found);
+    imginfo_log(ctx, IMGINFO_WARNING, "          expected (%d) - which looks like an interupted data collection? We will\n",nimages);
+    imginfo_log(ctx, IMGINFO_WARNING, "          assume that this smaller number is the correct one to use (but please check\n");
+    imginfo_log(ctx, IMGINFO_WARNING, "          and get back to beamline staff or us)!\n");
+    nimages=nimages_found;
+  } else {
+    if (ctx->iverb>1) {
+	imginfo_log(ctx, IMGINFO_DEBUG, "\n\n Good - expected and found number of images identical (%d)!\n\n",nimages);
+    }
+  }
+  if (hc.nmissing>0) {
+    imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: %llu of the images found have not been written to the EXTERNAL LINK files\n",hc.nmissing);
+    imginfo_log(ctx, IMGINFO_WARNING, "          (no data chunks) - an interrupted data collection or one still running?\n");
+  }
+
+  return nimages;
+}
+
+// files reached through external links from a master file held in
+// memory would otherwise inherit its (core) driver
+void eiger_elink_apl(imginfo_file* file)
+{
+  hid_t efapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_elink_file_cache_size(efapl, ELINK_FILE_CACHE_SIZE);
+  file->lapl = H5Pcreate(H5P_LINK_ACCESS);
+  file->dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  file->gapl = H5Pcreate(H5P_GROUP_ACCESS);
+  H5Pset_elink_fapl(file->lapl, efapl);
+  H5Pset_elink_fapl(file->dapl, efapl);
+  H5Pset_elink_fapl(file->gapl, efapl);
+  H5Pclose(efapl);
+}
+
+// open a master file - into memory if it is small enough for -h5mem:
+// the core driver reads it with a single read() instead of the many
+// small ones HDF5 would otherwise do, each of which is a round trip on
+// network file systems. A master file already decompressed into memory
+// (see get_file_image) is opened as a file image.
+hid_t eiger_open(imginfo_ctx* ctx, const char* path)
+{
+  // keep external (data) files open once they have been reached
+  // through a link, so further queries don't open them again
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_elink_file_cache_size(fapl, ELINK_FILE_CACHE_SIZE);
+  string name = path;
+
+  struct stat st;
+  if (ctx->file!=NULL && !ctx->file->image.empty()) {
+    string& image = ctx->file->image;
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " Opening master file from memory (%ld bytes)\n\n",(long) image.size());
+    H5Pset_fapl_core(fapl, 1024*1024, 0);
+    H5Pset_file_image(fapl, &image[0], image.size());
+    // HDF5 refuses a file image under the name of an existing file - the
+    // name still has to point at the right directory, as external links
+    // are looked up relative to it
+    if (name=="-") name = "stdin";
+    else if (name.size()>3 && name.compare(name.size()-3, 3, ".gz")==0) name.erase(name.size()-3);
+    else if (name.size()>4 && name.compare(name.size()-4, 4, ".bz2")==0) name.erase(name.size()-4);
+    while (stat(name.c_str(), &st)==0) name += "~";
+    eiger_elink_apl(ctx->file);
+  } else if (ctx->h5mem>0 && ctx->file!=NULL && stat(path, &st)==0 && S_ISREG(st.st_mode) &&
+      st.st_size>0 && st.st_size<=ctx->h5mem) {
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " Reading master file into memory (%ld bytes)\n\n",(long) st.st_size);
+    // no backing store: nothing is ever written back
+    H5Pset_fapl_core(fapl, 1024*1024, 0);
+    eiger_elink_apl(ctx->file);
+  }
+
+  hid_t fid = H5Fopen(name.c_str(), H5F_ACC_RDONLY, fapl);
+  H5Pclose(fapl);
+  // HDF5 has its own copy now
+  if (fid>=0 && ctx->file!=NULL) string().swap(ctx->file->image);
+  return fid;
+}
+
+// link (H5P_LINK_ACCESS), dataset (H5P_DATASET_ACCESS) or group
+// (H5P_GROUP_ACCESS) access for items of the master file
+hid_t hdf5_apl(imginfo_ctx* ctx, hid_t fid, hid_t cls)
+{
+  if (ctx->file==NULL || fid!=ctx->file->fid || ctx->file->lapl<0) return H5P_DEFAULT;
+  if (cls==H5P_DATASET_ACCESS) return ctx->file->dapl;
+  if (cls==H5P_GROUP_ACCESS) return ctx->file->gapl;
+  return ctx->file->lapl;
+}
+
+// the master file stays open while a file handle has it
+void eiger_close(imginfo_ctx* ctx, hid_t fid)
+{
+  if (ctx->file!=NULL && fid==ctx->file->fid) return;
+  H5Fclose(fid);
+}
+
+// ==================================================================================================
+// per-image table (-per-image)
+//   the angles of every image, read in blocks of IMGINFO_IMAGE_BLOCK
+//   through hyperslab selections from the same datasets get_header_eiger
+//   took the first/last values from, so memory doesn't grow with the
+//   number of images
+// ==================================================================================================
+void axis_source_set(axis_source* a, const char* start, const char* end, int end_rule, double inc)
+{
+  a->start    = start;
+  a->end      = end;
+  a->end_rule = end_rule;
+  a->inc      = inc;
+}
+
+// open a 1-dimensional per-image dataset for reading in blocks
+int hdf5_stream_open(imginfo_ctx* ctx, hid_t fid, const string& item, hdf5_stream* st)
+{
+  st->did = -1;
+  st->sid = -1;
+  st->nid = 0;
+  st->last = INIT_DOUBLE;
+  if (item.empty() || !hdf5_exists(ctx, fid, item.c_str())) return 0;
+  st->did = hdf5_open_dataset(ctx, fid, item.c_str());
+  if (st->did<0) return 0;
+  st->sid = H5Dget_space(st->did);
+  if (H5Sget_simple_extent_ndims(st->sid)!=1) {
+    if (ctx->iverb>0) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: %s is not a 1-dimensional dataset - ignored\n",item.c_str());
+    hdf5_stream_close(st);
+    return 0;
+  }
+  H5Sget_simple_extent_dims(st->sid, &st->nid, NULL);
+  if (st->nid>0) {
+    // padding for images beyond the stored ones
+    hsize_t one = 1, last = st->nid - 1;
+    hid_t mid = H5Screate_simple(1, &one, NULL);
+    H5Sselect_hyperslab(st->sid, H5S_SELECT_SET, &last, NULL, &one, NULL);
+    if (H5Dread(st->did, H5T_NATIVE_DOUBLE, mid, st->sid, H5P_DEFAULT, &st->last)<0) st->last = INIT_DOUBLE;
+    H5Sclose(mid);
+  }
+  return 1;
+}
+
+// values first..first+count-1 (padded with the last one stored)
+void hdf5_stream_read(hdf5_stream* st, hsize_t first, hsize_t count, double* d)
+{
+  hsize_t nread = 0;
+  if (st->did>=0 && first<st->nid) {
+    nread = (first+count<=st->nid) ? count : st->nid-first;
+    hid_t mid = H5Screate_simple(1, &nread, NULL);
+    H5Sselect_hyperslab(st->sid, H5S_SELECT_SET, &first, NULL, &nread, NULL);
+    if (H5Dread(st->did, H5T_NATIVE_DOUBLE, mid, st->sid, H5P_DEFAULT, d)<0) nread = 0;
+    H5Sclose(mid);
+  }
+  for (hsize_t i = nread; i < count; i++) {
+    d[i] = st->last;
+  }
+}
+
+void hdf5_stream_close(hdf5_stream* st)
+{
+  if (st->sid>=0) H5Sclose(st->sid);
+  if (st->did>=0) H5Dclose(st->did);
+  st->sid = -1;
+  st->did = -1;
+}
+
+// hand images first..first+count-1 to ctx->per_image (image numbers
+// through nimage_to_imgnum if given)
+int eiger_per_image(imginfo_ctx* ctx, hid_t fid, const axis_source* src, int first, int count,
+                    int nimages, int nimages_per_trigger, const int* nimage_to_imgnum)
+{
+  hdf5_stream st_start[NAXIS], st_end[NAXIS];
+  for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+    hdf5_stream_open(ctx, fid, src[iaxis].start, &st_start[iaxis]);
+    hdf5_stream_open(ctx, fid, (src[iaxis].end_rule==AXIS_END_DATASET) ? src[iaxis].end : "", &st_end[iaxis]);
+  }
+
+  vector<imginfo_image> rows(IMGINFO_IMAGE_BLOCK);
+  vector<double> start(IMGINFO_IMAGE_BLOCK), end(IMGINFO_IMAGE_BLOCK);
+  int ret = 0;
+  for (int iblock = first; iblock < first+count && ret==0; iblock += IMGINFO_IMAGE_BLOCK) {
+    int nrows = first+count-iblock;
+    if (nrows>IMGINFO_IMAGE_BLOCK) nrows = IMGINFO_IMAGE_BLOCK;
+    for (int irow = 0; irow < nrows; irow++) {
+      int iimg = iblock + irow;
+      rows[irow].imgn = (nimage_to_imgnum!=NULL && iimg<nimages) ? nimage_to_imgnum[iimg] : iimg+1;
+      rows[irow].trig = iimg/nimages_per_trigger + 1;
+    }
+    for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+      if (st_start[iaxis].did<0) {
+        for (int irow = 0; irow < nrows; irow++) start[irow] = end[irow] = INIT_DOUBLE;
+      } else {
+        hdf5_stream_read(&st_start[iaxis], iblock, nrows, &start[0]);
+        if (src[iaxis].end_rule==AXIS_END_DATASET) {
+          hdf5_stream_read(&st_end[iaxis], iblock, nrows, &end[0]);
+          // as for the first/last image: no end angle - same as start
+          for (int irow = 0; irow < nrows; irow++) {
+            if (isnan(end[irow])) end[irow] = start[irow];
+          }
+        } else {
+          double inc = (src[iaxis].end_rule==AXIS_END_INC) ? src[iaxis].inc : 0.0;
+          for (int irow = 0; irow < nrows; irow++) end[irow] = start[irow] + inc;
+        }
+      }
+      for (int irow = 0; irow < nrows; irow++) {
+        double *a = NULL;
+        switch (iaxis) {
+        case AXIS_OMEGA:     a = rows[irow].omeg; break;
+        case AXIS_KAPPA:     a = rows[irow].kapp; break;
+        case AXIS_CHI:       a = rows[irow].chi;  break;
+        case AXIS_PHI:       a = rows[irow].phi;  break;
+        case AXIS_TWO_THETA: a = rows[irow].twot; break;
+        }
+        a[0] = start[irow];
+        a[1] = end[irow];
+      }
+    }
+    ret = ctx->per_image(&rows[0], nrows, ctx->per_image_arg);
+  }
+
+  for (int iaxis = 0; iaxis < NAXIS; iaxis++) {
+    hdf5_stream_close(&st_start[iaxis]);
+    hdf5_stream_close(&st_end[iaxis]);
+  }
+  return ret;
+}
+
+// ==================================================================================================
+// frame reading (imginfo_read_frames)
+//   the image data linked from /entry/data is fetched chunk by chunk with
+//   H5Dread_chunk - still compressed, bypassing the HDF5 filter pipeline
+//   that would decompress everything in this one thread - and handed to a
+//   pool of decode threads. Only the calling thread ever calls HDF5. Raw
+//   chunks go through a fixed set of slots whose buffers, like the output
+//   buffer of each decode thread, are reused from one frame to the next.
+//   Datasets not stored as one frame per chunk, or with filters we can't
+//   undo here, are read through H5Dread instead.
+// ==================================================================================================
+double frame_clock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1.0e-9*ts.tv_nsec;
+}
+
+// sizes in the chunk headers written by the bitshuffle and LZ4 filters
+// are big-endian
+uint64_t frame_be64(const char* p)
+{
+  uint64_t v = 0;
+  for (int i = 0; i < 8; i++) v = (v<<8) | (unsigned char) p[i];
+  return v;
+}
+
+uint32_t frame_be32(const char* p)
+{
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++) v = (v<<8) | (unsigned char) p[i];
+  return v;
+}
+
+// how the chunks of a dataset with the given creation properties can be
+// decoded here (FRAME_CODEC_HDF5 if not at all)
+int frame_codec(hid_t dcpl, size_t elem_size, size_t* block)
+{
+  int nfilt = H5Pget_nfilters(dcpl);
+  if (nfilt==0) return FRAME_CODEC_NONE;
+  if (nfilt!=1) return FRAME_CODEC_HDF5;
+
+  unsigned int flags, config;
+  unsigned int cd[8];
+  size_t ncd = 8;
+  char name[CHAR_ARRAY_LEN];
+  H5Z_filter_t filt_id = H5Pget_filter2(dcpl, 0, &flags, &ncd, cd, sizeof(name), name, &config);
+#ifdef USE_BITSHUFFLE
+  if (filt_id==BSHUF_H5FILTER) {
+    // cd_values: version (2), element size, block size, compression
+    if (ncd>2 && cd[2]!=elem_size) return FRAME_CODEC_HDF5;
+    *block = (ncd>3) ? cd[3] : 0;
+    if (ncd<=4 || cd[4]==0) return FRAME_CODEC_BSHUF;
+    if (cd[4]==BSHUF_H5_COMPRESS_LZ4) return FRAME_CODEC_BSHUF_LZ4;
+  }
+#endif
+#ifdef USE_LZ4
+  if (filt_id==LZ4_FILTER) return FRAME_CODEC_LZ4;
+#endif
+  return FRAME_CODEC_HDF5;
+}
+
+// the chunk in slot s decompressed into out (nbytes = size of the frame)
+int frame_decode(const frame_slot* s, char* out, size_t nbytes, string& error)
+{
+  const char* in = &s->raw[0];
+  size_t n = s->nraw;
+  size_t nelem = nbytes/s->elem_size;
+  switch (s->codec) {
+#ifdef USE_BITSHUFFLE
+  case FRAME_CODEC_BSHUF:
+    if (n!=nbytes || bshuf_bitunshuffle(in, out, nelem, s->elem_size, s->block)<0) {
+      error = "unable to undo bitshuffle";
+      return 0;
+    }
+    return 1;
+  case FRAME_CODEC_BSHUF_LZ4: {
+    // uncompressed size (8 bytes) and block size in bytes (4 bytes), then
+    // every block as its compressed size (4 bytes) and the LZ4 data - the
+    // last one rounded down to a multiple of BSHUF_BLOCKED_MULT elements,
+    // any elements after that as they were. bshuf_decompress_lz4 trusts
+    // those sizes, so they are checked against what was read first
+    if (n<12 || frame_be64(in)!=nbytes) {
+      error = "unexpected size of bitshuffle/LZ4 chunk";
+      return 0;
+    }
+    size_t block = frame_be32(in+8);
+    if (block==0 || block%s->elem_size!=0) {
+      error = "invalid block size in bitshuffle/LZ4 chunk";
+      return 0;
+    }
+    block /= s->elem_size;
+    size_t nblock = nelem/block + ((nelem%block)/BSHUF_BLOCKED_MULT>0);
+    size_t pos = 12;
+    for (size_t iblock = 0; iblock < nblock; iblock++) {
+      size_t clen = (pos+4<=n) ? frame_be32(in+pos) : n;
+      pos += 4;
+      if (pos>n || clen>n-pos) {
+        error = "truncated bitshuffle/LZ4 chunk";
+        return 0;
+      }
+      pos += clen;
+    }
+    if (n-pos!=(nelem%BSHUF_BLOCKED_MULT)*s->elem_size ||
+        bshuf_decompress_lz4(in+12, out, nelem, s->elem_size, block)!=(int64_t) (n-12)) {
+      error = "unable to decompress bitshuffle/LZ4 chunk";
+      return 0;
+    }
+    return 1;
+  }
+#endif
+#ifdef USE_LZ4
+  case FRAME_CODEC_LZ4: {
+    // uncompressed size (8 bytes) and block size (4 bytes), then every
+    // block as its compressed size (4 bytes) and the LZ4 data - or the
+    // block as it was if it didn't get any smaller
+    if (n<12 || frame_be64(in)!=nbytes) {
+      error = "unexpected size of LZ4 chunk";
+      return 0;
+    }
+    size_t block = frame_be32(in+8);
+    if (block==0 || block>nbytes) block = nbytes;
+    size_t pos = 12;
+    for (size_t done = 0; done < nbytes; done += block) {
+      size_t len = (nbytes-done<block) ? nbytes-done : block;
+      size_t clen = (pos+4<=n) ? frame_be32(in+pos) : n;
+      pos += 4;
+      if (pos>n || clen>n-pos) {
+        error = "truncated LZ4 chunk";
+        return 0;
+      }
+      if (clen==len) {
+        memcpy(out+done, in+pos, len);
+      } else if (LZ4_decompress_safe(in+pos, out+done, (int) clen, (int) len)!=(int) len) {
+        error = "unable to decompress LZ4 chunk";
+        return 0;
+      }
+      pos += clen;
+    }
+    return 1;
+  }
+#endif
+  }
+  error = "unsupported chunk format";
+  return 0;
+}
+
+// decode thread: takes filled slots until there are no more to come
+void* frame_worker(void* arg)
+{
+  frame_pool* p = (frame_pool*) arg;
+  vector<char> out;
+  string error;
+
+  pthread_mutex_lock(&p->lock);
+  while (2 != 3) {
+    while (p->todo.empty() && !p->stop) pthread_cond_wait(&p->filled, &p->lock);
+    if (p->todo.empty()) break;
+    int islot = p->todo.front();
+    p->todo.pop_front();
+    int failed = p->failed;
+    pthread_mutex_unlock(&p->lock);
+
+    // after a failure the remaining slots are only handed back
+    frame_slot* s = &p->slots[islot];
+    size_t nbytes = (size_t) s->nx * s->ny * s->elem_size;
+    int ret = FRAME_OK;
+    if (!failed) {
+      const char* data = &s->raw[0];
+      if (s->codec==FRAME_CODEC_NONE || s->codec==FRAME_CODEC_HDF5) {
+        if (s->nraw!=nbytes) {
+          error = "unexpected chunk size";
+          ret = FRAME_FAILED;
+        }
+      } else {
+        if (out.size()<nbytes) out.resize(nbytes);
+        if (!frame_decode(s, &out[0], nbytes, error)) ret = FRAME_FAILED;
+        data = &out[0];
+      }
+      if (ret==FRAME_OK && p->fn!=NULL) {
+        imginfo_frame f;
+        f.imgn      = s->imgn;
+        f.nx        = s->nx;
+        f.ny        = s->ny;
+        f.elem_size = s->elem_size;
+        f.data      = data;
+        if (p->fn(&f, p->arg)!=0) ret = FRAME_STOPPED;
+      }
+    }
+
+    pthread_mutex_lock(&p->lock);
+    if (!failed) {
+      if (ret==FRAME_OK) {
+        p->nframes++;
+        p->nbytes += nbytes;
+      } else if (ret==FRAME_FAILED && p->verify) {
+        frame_bad(p, s->imgn, s->isrc, error);
+      } else if (!p->failed) {
+        p->failed = ret;
+        if (ret==FRAME_FAILED) {
+          char line[CHAR_ARRAY_LEN*4];
+          snprintf(line, sizeof(line), "image %d: %s", s->imgn, error.c_str());
+          p->error = line;
+        }
+      }
+    }
+    p->idle.push_back(islot);
+    pthread_cond_signal(&p->freed);
+  }
+  pthread_mutex_unlock(&p->lock);
+  return NULL;
+}
+
+// verify: count a frame that couldn't be read or decoded and remember
+// the first one (in file order) - called with p->lock held
+void frame_bad(frame_pool* p, int imgn, int isrc, const string& error)
+{
+  p->nbad++;
+  if (p->bad_imgn==0 || imgn<p->bad_imgn) {
+    p->bad_imgn  = imgn;
+    p->bad_src   = isrc;
+    p->bad_error = error;
+  }
+}
+
+// a free slot to read the next frame into (-1 once decoding has failed)
+int frame_slot_get(frame_pool* p)
+{
+  pthread_mutex_lock(&p->lock);
+  while (p->idle.empty() && !p->failed) pthread_cond_wait(&p->freed, &p->lock);
+  int islot = -1;
+  if (!p->failed) {
+    islot = p->idle.back();
+    p->idle.pop_back();
+  }
+  pthread_mutex_unlock(&p->lock);
+  return islot;
+}
+
+// hand a slot on for decoding (or back unused)
+void frame_slot_put(frame_pool* p, int islot, int filled)
+{
+  pthread_mutex_lock(&p->lock);
+  if (filled) {
+    p->todo.push_back(islot);
+    pthread_cond_signal(&p->filled);
+  } else {
+    p->idle.push_back(islot);
+  }
+  pthread_mutex_unlock(&p->lock);
+}
+
+// queue those frames of one dataset that fall into first..last (the
+// dataset's frames being images imgn+1, imgn+2, ...). Returns 1 to carry
+// on, 0 if the decode threads stopped and -1 on error.
+int frame_read_dataset(imginfo_ctx* ctx, hid_t fid, const string& item, int isrc, int* imgn, int first, int last,
+                       frame_pool* p, imginfo_frame_stats* stats)
+{
+  hid_t did;
+  H5E_BEGIN_TRY {
+    did = hdf5_open_dataset(ctx, fid, item.c_str());
+  } H5E_END_TRY;
+  if (did<0) {
+    // with verify all frames of the dataset count as bad: as many as
+    // -h5check found behind the link or, if it couldn't tell (e.g. the
+    // data file isn't there), as many as the dataset before held (one
+    // frame if this is the first)
+    if (p->verify) {
+      int nframes = ( p->link_frames>0 ) ? p->link_frames : 1;
+      if (ctx->file!=NULL) {
+        map<string,int>::const_iterator it = ctx->file->check.nframes.find(item);
+        if (it!=ctx->file->check.nframes.end() && it->second>0) nframes = it->second;
+      }
+      pthread_mutex_lock(&p->lock);
+      for (int iframe = 0; iframe < nframes; iframe++) {
+        int imgnum = *imgn + iframe + 1;
+        if (imgnum<first) continue;
+        if (last>0 && imgnum>last) break;
+        frame_bad(p, imgnum, isrc, "unable to open dataset " + item);
+      }
+      pthread_mutex_unlock(&p->lock);
+      *imgn += nframes;
+      return 1;
+    }
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unable to open dataset %s!\n\n",item.c_str());
+    return -1;
+  }
+  hid_t sid = H5Dget_space(did);
+  if (H5Sget_simple_extent_ndims(sid)!=3) {
+    if (ctx->iverb>0) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: %s is not a 3-dimensional dataset - ignored\n",item.c_str());
+    H5Sclose(sid);
+    H5Dclose(did);
+    return 1;
+  }
+  hsize_t dims[3], cdims[3];
+  H5Sget_simple_extent_dims(sid, dims, NULL);
+  hid_t tid  = H5Dget_type(did);
+  hid_t mtid = H5Tget_native_type(tid, H5T_DIR_ASCEND);
+  hid_t dcpl = H5Dget_create_plist(did);
+  size_t elem_size = H5Tget_size(tid);
+  size_t nbytes = dims[1]*dims[2]*elem_size;
+
+  // raw chunks only if each holds one frame as stored in memory
+  size_t block = 0;
+  int codec = FRAME_CODEC_HDF5;
+  if (H5Pget_layout(dcpl)==H5D_CHUNKED && H5Pget_chunk(dcpl, 3, cdims)==3 &&
+      cdims[0]==1 && cdims[1]==dims[1] && cdims[2]==dims[2] && H5Tequal(tid, mtid)>0) {
+    codec = frame_codec(dcpl, elem_size, &block);
+  }
+  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " Reading %d frames of %s (%s)\n",(int) dims[0],item.c_str(),
+                                (codec==FRAME_CODEC_HDF5) ? "through HDF5" : "raw chunks");
+
+  int ret = 1;
+  hid_t msid = -1;
+  for (hsize_t iframe = 0; iframe < dims[0] && ret==1; iframe++) {
+    int imgnum = *imgn + (int) iframe + 1;
+    if (imgnum<first) continue;
+    if (last>0 && imgnum>last) break;
+    int islot = frame_slot_get(p);
+    if (islot<0) {
+      ret = 0;
+      break;
+    }
+    frame_slot* s = &p->slots[islot];
+    s->imgn      = imgnum;
+    s->nx        = dims[2];
+    s->ny        = dims[1];
+    s->elem_size = elem_size;
+    s->block     = block;
+    s->codec     = codec;
+    s->isrc      = isrc;
+
+    hsize_t offset[3] = { iframe, 0, 0 };
+    herr_t status = -1;
+    if (codec!=FRAME_CODEC_HDF5) {
+      hsize_t nraw = 0;
+      uint32_t filter_mask = 0;
+      H5E_BEGIN_TRY {
+        if (H5Dget_chunk_storage_size(did, offset, &nraw)>=0 && nraw>0) {
+          if (s->raw.size()<nraw) s->raw.resize(nraw);
+          status = H5Dread_chunk(did, H5P_DEFAULT, offset, &filter_mask, &s->raw[0]);
+        }
+      } H5E_END_TRY;
+      s->nraw = nraw;
+      // the (only) filter was skipped when writing this chunk
+      if (filter_mask & 1) s->codec = FRAME_CODEC_NONE;
+      stats->ndirect++;
+    } else {
+      hsize_t count[3] = { 1, dims[1], dims[2] };
+      if (msid<0) msid = H5Screate_simple(3, count, NULL);
+      if (s->raw.size()<nbytes) s->raw.resize(nbytes);
+      H5Sselect_hyperslab(sid, H5S_SELECT_SET, offset, NULL, count, NULL);
+      status = H5Dread(did, mtid, msid, sid, H5P_DEFAULT, &s->raw[0]);
+      s->nraw = nbytes;
+    }
+    if (status<0 && p->verify) {
+      pthread_mutex_lock(&p->lock);
+      frame_bad(p, imgnum, isrc, (codec!=FRAME_CODEC_HDF5 && s->nraw==0) ? "chunk not stored" : "unable to read chunk");
+      pthread_mutex_unlock(&p->lock);
+      frame_slot_put(p, islot, 0);
+      continue;
+    }
+    if (status<0) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unable to read image %d (frame %d of %s)!\n\n",imgnum,(int) iframe+1,item.c_str());
+      frame_slot_put(p, islot, 0);
+      ret = -1;
+      break;
+    }
+    stats->nraw += s->nraw;
+    frame_slot_put(p, islot, 1);
+  }
+  *imgn += dims[0];
+  p->link_frames = dims[0];
+
+  if (msid>=0) H5Sclose(msid);
+  H5Pclose(dcpl);
+  H5Tclose(mtid);
+  H5Tclose(tid);
+  H5Sclose(sid);
+  H5Dclose(did);
+  return ret;
+}
+
+int imginfo_read_frames(imginfo_file* file, int first, int last, int nthreads,
+                        imginfo_frame_fn fn, void* arg, imginfo_frame_stats* stats, imginfo_result* res)
+{
+  const char* path = file->path.c_str();
+  imginfo_ctx ctx;
+  imginfo_ctx_init(&ctx, file, res);
+  stats->nframes  = 0;
+  stats->ndirect  = 0;
+  stats->nraw     = 0.0;
+  stats->nbytes   = 0.0;
+  stats->seconds  = 0.0;
+  stats->nthreads = 0;
+  stats->nbad     = 0;
+  stats->bad_imgn = 0;
+  stats->bad_file.clear();
+  stats->bad_error.clear();
+  if (nthreads<1) nthreads = 1;
+  if (first<1) first = 1;
+
+  if (imginfo_file_buffer(file)<=0) {
+    res->status = IMGINFO_UNREADABLE;
+    return res->status;
+  }
+  if (get_format(&ctx, file->buffer)!=FORMAT_HDF5_EIGER) {
+    imginfo_log(&ctx, IMGINFO_ERROR, "ERROR: cannot determine file format\n");
+    res->status = IMGINFO_NO_HEADER;
+    return res->status;
+  }
+  if (!register_filters(&ctx)) {
+    res->status = IMGINFO_FATAL;
+    return res->status;
+  }
+  if (file->fid<0) {
+    if (ctx.iverb>1) imginfo_log(&ctx, IMGINFO_DEBUG, "\n Opening file %s\n\n",path);
+    file->fid = eiger_open(&ctx, path);
+    if (file->fid<0) {
+      imginfo_log(&ctx, IMGINFO_ERROR, "\n\n ERROR - unable to open file \"%s\"!\n\n",path);
+      res->status = IMGINFO_FATAL;
+      return res->status;
+    }
+  }
+  hid_t fid = file->fid;
+
+  // the image datasets in the order of their names (as for -h5check)
+  h5_census hcen;
+  hcen.ctx = &ctx;
+  hid_t gid = hdf5_group(&ctx, fid, "/entry/data");
+  if (gid<0 || H5Literate(gid, H5_INDEX_NAME, H5_ITER_INC, NULL, h5check_census_link, &hcen)<0) {
+    imginfo_log(&ctx, IMGINFO_ERROR, "\n\n ERROR - unable to list group /entry/data!\n\n");
+    res->status = IMGINFO_NO_HEADER;
+    return res->status;
+  }
+
+  // two slots per thread: one being decoded, one read ahead
+  frame_pool p;
+  pthread_mutex_init(&p.lock, NULL);
+  pthread_cond_init(&p.filled, NULL);
+  pthread_cond_init(&p.freed, NULL);
+  p.slots.resize(2*nthreads);
+  for (int islot = 0; islot < 2*nthreads; islot++) p.idle.push_back(islot);
+  p.stop    = 0;
+  p.failed  = FRAME_OK;
+  p.fn      = fn;
+  p.arg     = arg;
+  p.nframes = 0;
+  p.nbytes  = 0.0;
+  p.verify  = file->opt.verify;
+  p.nbad    = 0;
+  p.bad_imgn = 0;
+  p.bad_src  = 0;
+  p.link_frames = 0;
+  vector<pthread_t> threads(nthreads);
+  for (stats->nthreads = 0; stats->nthreads < nthreads; stats->nthreads++) {
+    if (pthread_create(&threads[stats->nthreads], NULL, frame_worker, &p)!=0) break;
+  }
+
+  int ret = ( stats->nthreads>0 ) ? 1 : -1;
+  if (ret<0) imginfo_log(&ctx, IMGINFO_ERROR, "\n\n ERROR - unable to start decode threads!\n\n");
+  double start = frame_clock();
+  int imgn = 0;
+  for (size_t ilink = 0; ilink < hcen.links.size() && ret==1 && (last<1 || imgn<last); ilink++) {
+    if (hcen.links[ilink].type!=H5L_TYPE_EXTERNAL && hcen.links[ilink].type!=H5L_TYPE_HARD) {
+      imginfo_log(&ctx, IMGINFO_ERROR, "\n\n ERROR: unsupported link type for /entry/data/%s !\n\n",hcen.links[ilink].name.c_str());
+      continue;
+    }
+    ret = frame_read_dataset(&ctx, fid, "/entry/data/" + hcen.links[ilink].name, ilink, &imgn, first, last, &p, stats);
+  }
+
+  pthread_mutex_lock(&p.lock);
+  p.stop = 1;
+  pthread_cond_broadcast(&p.filled);
+  pthread_mutex_unlock(&p.lock);
+  for (int ithread = 0; ithread < stats->nthreads; ithread++) pthread_join(threads[ithread], NULL);
+  stats->seconds = frame_clock() - start;
+  stats->nframes = p.nframes;
+  stats->nbad    = p.nbad;
+  if (p.nbad>0) {
+    // the image number as found by -h5check (if it ran)
+    const vector<int>& map = file->check.nimage_to_imgnum;
+    int inum = p.bad_imgn - 1;
+    stats->bad_imgn  = ( file->check.done && inum<(int) map.size() && map[inum]>0 ) ? map[inum] : p.bad_imgn;
+    stats->bad_error = p.bad_error;
+    const h5_link& l = hcen.links[p.bad_src];
+    if (l.type==H5L_TYPE_EXTERNAL) {
+      vector<char> t(path, path + strlen(path) + 1);
+      stats->bad_file = string(dirname(&t[0])) + "/" + l.filename;
+    } else {
+      stats->bad_file = path;
+    }
+  }
+  stats->nbytes  = p.nbytes;
+  pthread_cond_destroy(&p.freed);
+  pthread_cond_destroy(&p.filled);
+  pthread_mutex_destroy(&p.lock);
+
+  if (p.failed==FRAME_FAILED) {
+    imginfo_log(&ctx, IMGINFO_ERROR, "\n\n ERROR - %s!\n\n",p.error.c_str());
+    ret = -1;
+  } else if (ret==1 && (first>imgn || last>imgn)) {
+    imginfo_log(&ctx, IMGINFO_ERROR, "\n\n ERROR: requested image number %d but only %d images present!\n\n",(last>imgn) ? last : first,imgn);
+    ret = -1;
+  }
+  res->status = ( ret<0 ) ? IMGINFO_NO_HEADER : IMGINFO_OK;
+  return res->status;
+}
+
+// ==================================================================================================
+// hashing (-manifest)
+//   XXH64 (fast, non-cryptographic) and SHA-256 of whole files, several
+//   files at the same time in a pool of threads. Every file is read once
+//   in large blocks, feeding whichever hashes were asked for.
+// ==================================================================================================
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+uint64_t xxh_rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+uint64_t xxh_read64(const unsigned char* p)
+{
+  uint64_t v;
+  memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+uint32_t xxh_read32(const unsigned char* p)
+{
+  uint32_t v;
+  memcpy(&v, p, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+  acc += input * XXH_PRIME64_2;
+  acc  = xxh_rotl(acc, 31);
+  return acc * XXH_PRIME64_1;
+}
+
+uint64_t xxh_merge(uint64_t acc, uint64_t val)
+{
+  acc ^= xxh_round(0, val);
+  return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+void xxh64_init(xxh64_state* s)
+{
+  s->v[0]  = XXH_PRIME64_1 + XXH_PRIME64_2;
+  s->v[1]  = XXH_PRIME64_2;
+  s->v[2]  = 0;
+  s->v[3]  = -XXH_PRIME64_1;
+  s->total = 0;
+  s->nmem  = 0;
+}
+
+void xxh64_update(xxh64_state* s, const void* data, size_t len)
+{
+  const unsigned char* p = (const unsigned char*) data;
+  const unsigned char* end = p + len;
+  s->total += len;
+
+  // fill up a partial stripe first
+  if (s->nmem + len < 32) {
+    memcpy(s->mem + s->nmem, p, len);
+    s->nmem += len;
+    return;
+  }
+  if (s->nmem>0) {
+    memcpy(s->mem + s->nmem, p, 32 - s->nmem);
+    p += 32 - s->nmem;
+    for (int i = 0; i < 4; i++) s->v[i] = xxh_round(s->v[i], xxh_read64(s->mem + 8*i));
+    s->nmem = 0;
+  }
+  uint64_t v1 = s->v[0], v2 = s->v[1], v3 = s->v[2], v4 = s->v[3];
+  while (p + 32 <= end) {
+    v1 = xxh_round(v1, xxh_read64(p));
+    v2 = xxh_round(v2, xxh_read64(p+8));
+    v3 = xxh_round(v3, xxh_read64(p+16));
+    v4 = xxh_round(v4, xxh_read64(p+24));
+    p += 32;
+  }
+  s->v[0] = v1; s->v[1] = v2; s->v[2] = v3; s->v[3] = v4;
+  memcpy(s->mem, p, end - p);
+  s->nmem = end - p;
+}
+
+uint64_t xxh64_digest(const xxh64_state* s)
+{
+  uint64_t h;
+  if (s->total>=32) {
+    h = xxh_rotl(s->v[0], 1) + xxh_rotl(s->v[1], 7) + xxh_rotl(s->v[2], 12) + xxh_rotl(s->v[3], 18);
+    for (int i = 0; i < 4; i++) h = xxh_merge(h, s->v[i]);
+  } else {
+    h = s->v[2] + XXH_PRIME64_5;
+  }
+  h += s->total;
+
+  const unsigned char* p = s->mem;
+  const unsigned char* end = s->mem + s->nmem;
+  for (; p + 8 <= end; p += 8) {
+    h ^= xxh_round(0, xxh_read64(p));
+    h  = xxh_rotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+  }
+  if (p + 4 <= end) {
+    h ^= (uint64_t) xxh_read32(p) * XXH_PRIME64_1;
+    h  = xxh_rotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+    p += 4;
+  }
+  for (; p < end; p++) {
+    h ^= (*p) * XXH_PRIME64_5;
+    h  = xxh_rotl(h, 11) * XXH_PRIME64_1;
+  }
+  h ^= h >> 33;
+  h *= XXH_PRIME64_2;
+  h ^= h >> 29;
+  h *= XXH_PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+const uint32_t sha256_k[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+uint32_t sha_rotr(uint32_t x, int r)
+{
+  return (x >> r) | (x << (32 - r));
+}
+
+void sha256_block(sha256_state* s, const unsigned char* p)
+{
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = ((uint32_t) p[4*i] << 24) | ((uint32_t) p[4*i+1] << 16) | ((uint32_t) p[4*i+2] << 8) | p[4*i+3];
+  }
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = sha_rotr(w[i-15], 7) ^ sha_rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+    uint32_t s1 = sha_rotr(w[i-2], 17) ^ sha_rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+    w[i] = w[i-16] + s0 + w[i-7] + s1;
+  }
+  uint32_t a = s->h[0], b = s->h[1], c = s->h[2], d = s->h[3];
+  uint32_t e = s->h[4], f = s->h[5], g = s->h[6], h = s->h[7];
+  for (int i = 0; i < 64; i++) {
+    uint32_t t1 = h + (sha_rotr(e, 6) ^ sha_rotr(e, 11) ^ sha_rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+    uint32_t t2 = (sha_rotr(a, 2) ^ sha_rotr(a, 13) ^ sha_rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+  s->h[0] += a; s->h[1] += b; s->h[2] += c; s->h[3] += d;
+  s->h[4] += e; s->h[5] += f; s->h[6] += g; s->h[7] += h;
+}
+
+void sha256_init(sha256_state* s)
+{
+  static const uint32_t h0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+  memcpy(s->h, h0, sizeof(h0));
+  s->total = 0;
+  s->nmem  = 0;
+}
+
+void sha256_update(sha256_state* s, const void* data, size_t len)
+{
+  const unsigned char* p = (const unsigned char*) data;
+  s->total += len;
+  if (s->nmem>0) {
+    size_t n = ( len < 64 - s->nmem ) ? len : 64 - s->nmem;
+    memcpy(s->mem + s->nmem, p, n);
+    s->nmem += n;
+    p += n;
+    len -= n;
+    if (s->nmem<64) return;
+    sha256_block(s, s->mem);
+    s->nmem = 0;
+  }
+  for (; len >= 64; p += 64, len -= 64) sha256_block(s, p);
+  memcpy(s->mem, p, len);
+  s->nmem = len;
+}
+
+void sha256_digest(sha256_state* s, unsigned char out[32])
+{
+  uint64_t bits = s->total * 8;
+  unsigned char pad[72];
+  size_t npad = ( s->nmem < 56 ) ? 56 - s->nmem : 120 - s->nmem;
+  memset(pad, 0, sizeof(pad));
+  pad[0] = 0x80;
+  for (int i = 0; i < 8; i++) pad[npad + i] = (unsigned char) (bits >> (56 - 8*i));
+  sha256_update(s, pad, npad + 8);
+  for (int i = 0; i < 8; i++) {
+    out[4*i]   = (unsigned char) (s->h[i] >> 24);
+    out[4*i+1] = (unsigned char) (s->h[i] >> 16);
+    out[4*i+2] = (unsigned char) (s->h[i] >> 8);
+    out[4*i+3] = (unsigned char) s->h[i];
+  }
+}
+
+// hash one file with a read buffer of the calling thread
+void hash_file(imginfo_hash* f, int which, vector<char>& buf)
+{
+  xxh64_state xs;
+  sha256_state ss;
+  xxh64_init(&xs);
+  sha256_init(&ss);
+  f->size = 0;
+  f->xxh64.clear();
+  f->sha256.clear();
+
+  int fd = open(f->path.c_str(), O_RDONLY);
+  if (fd<0) {
+    f->status = errno;
+    return;
+  }
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  f->status = 0;
+  ssize_t n;
+  while ((n = read(fd, &buf[0], buf.size()))!=0) {
+    if (n<0) {
+      if (errno==EINTR) continue;
+      f->status = errno;
+      break;
+    }
+    if (which & IMGINFO_HASH_XXH64)  xxh64_update(&xs, &buf[0], n);
+    if (which & IMGINFO_HASH_SHA256) sha256_update(&ss, &buf[0], n);
+    f->size += n;
+  }
+  close(fd);
+  if (f->status!=0) return;
+
+  char hex[65];
+  if (which & IMGINFO_HASH_XXH64) {
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) xxh64_digest(&xs));
+    f->xxh64 = hex;
+  }
+  if (which & IMGINFO_HASH_SHA256) {
+    unsigned char d[32];
+    sha256_digest(&ss, d);
+    for (int i = 0; i < 32; i++) snprintf(hex + 2*i, 3, "%02x", d[i]);
+    f->sha256 = hex;
+  }
+}
+
+// hash thread: takes the next file until there are none left
+void* hash_worker(void* arg)
+{
+  hash_pool* p = (hash_pool*) arg;
+  vector<char> buf(HASH_BLOCK);
+  while (2 != 3) {
+    pthread_mutex_lock(&p->lock);
+    size_t ifile = p->next++;
+    pthread_mutex_unlock(&p->lock);
+    if (ifile>=p->files->size()) break;
+    hash_file(&(*p->files)[ifile], p->which, buf);
+  }
+  return NULL;
+}
+
+int imginfo_hash_files(vector<imginfo_hash>* files, int which, int nthreads, double* seconds)
+{
+  double start = frame_clock();
+  hash_pool p;
+  pthread_mutex_init(&p.lock, NULL);
+  p.files = files;
+  p.which = which;
+  p.next  = 0;
+  if (nthreads>(int) files->size()) nthreads = files->size();
+  if (nthreads<1) nthreads = 1;
+  vector<pthread_t> threads(nthreads);
+  int nstarted;
+  for (nstarted = 0; nstarted < nthreads; nstarted++) {
+    if (pthread_create(&threads[nstarted], NULL, hash_worker, &p)!=0) break;
+  }
+  // no threads at all: do it here
+  if (nstarted==0) hash_worker(&p);
+  for (int ithread = 0; ithread < nstarted; ithread++) pthread_join(threads[ithread], NULL);
+  pthread_mutex_destroy(&p.lock);
+  if (seconds!=NULL) *seconds = frame_clock() - start;
+
+  int nfailed = 0;
+  for (size_t ifile = 0; ifile < files->size(); ifile++) {
+    if ((*files)[ifile].status!=0) nfailed++;
+  }
+  return nfailed;
+}
+
+// ==================================================================================================
+// h5check: checks on the external (data) files linked from /entry/data
+// ==================================================================================================
+
+// open one external file and find out which images it holds - only
+// error messages (and the optional filter listing) are printed here, all
+// other reporting happens in h5check_merge_link so that the output is
+// the same whether or not this ran in a separate worker process
+void h5check_external_link(imginfo_ctx* ctx, hid_t fid, const h5check_link* l, int list_filters, h5check_result* r)
+{
+  const char *f    = l->file.c_str();
+  const char *path = l->path.c_str();
+  herr_t status;
+
+  trace_span span("h5check", "h5check_external_link", f);
+
+  r->status        = H5CHECK_LINK_OK;
+  r->image_nr      = H5CHECK_NR_FAILED;
+  r->image_nr_low  = 0;
+  r->image_nr_high = 0;
+  r->dims0         = 0;
+  r->nmissing      = 0;
+  r->ngaps         = 0;
+  r->gap_last      = 0;
+
+  hid_t eid = -1;
+  hid_t did = -1;
+  if (fid>=0) {
+    // through the link itself: the external file then stays open in the
+    // external link cache of the master file
+    H5E_BEGIN_TRY {
+      did = H5Dopen2(fid, l->link.c_str(), hdf5_apl(ctx, fid, H5P_DATASET_ACCESS));
+    } H5E_END_TRY;
+  }
+
+  if (did<0) {
+    // start reading from external file
+    eid = H5Fopen(f, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (eid<0) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Fopen (%s)!\n\n",f);
+      r->status = H5CHECK_LINK_NO_FILE;
+      return;
+    }
+
+    did = H5Dopen2(eid, path, H5P_DEFAULT);
+    if (did<0) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Dopen2 (file=\"%s\" path=\"%s\")!\n\n",f,path);
+      r->status = H5CHECK_LINK_NO_DATASET;
+      H5Fclose(eid);
+      return;
+    }
+  }
+
+  if (list_filters) {
+    hid_t cpl = H5Dget_create_plist(did);
+    hdf5_list_filters(ctx, cpl);
+    H5Pclose(cpl);
+    if (ctx->fatal) {
+      r->status = H5CHECK_LINK_FATAL;
+      H5Dclose(did);
+      if (eid>=0) H5Fclose(eid);
+      return;
+    }
+  }
+
+  status = H5Aexists(did,"image_nr_high");
+  if (status<=0) {
+    r->image_nr = H5CHECK_NR_NONE;
+    hid_t space_id = H5Dget_space (did);
+    hsize_t dims_id[3] = {1,1,1};
+    H5Sget_simple_extent_dims (space_id, dims_id, NULL);
+    H5Sclose(space_id);
+    r->dims0 = dims_id[0];
+  } else {
+    hid_t aid = H5Aopen_by_name(did,".","image_nr_high",H5P_DEFAULT,H5P_DEFAULT);
+    if (aid>0) {
+      int    data_i[10];
+      if (H5Aread(aid,H5T_NATIVE_INT,data_i) >= 0 ) {
+	r->image_nr_high = data_i[0];
+	hid_t aid2 = H5Aopen_by_name(did,".","image_nr_low",H5P_DEFAULT,H5P_DEFAULT);
+	if (aid2>0) {
+	  if (H5Aread(aid2,H5T_NATIVE_INT,data_i) >= 0 ) {
+	    r->image_nr_low = data_i[0];
+	    r->image_nr = H5CHECK_NR_READ;
+	  }
+	  status = H5Aclose(aid2);
+	}
+      }
+      status = H5Aclose(aid);
+    }
+  }
+
+  h5check_chunks(did, r);
+
+  H5Dclose(did);
+  if (eid>=0) H5Fclose(eid);
+}
+
+// which frames of an external dataset have actually been written: an
+// interrupted collection can leave the full dimensions (and
+// image_nr_high) behind with chunks missing. Counting the chunks in the
+// chunk index is enough when they are all there, otherwise each one is
+// looked up by its coordinates - no image data is read either way.
+void h5check_chunks(hid_t did, h5check_result* r)
+{
+  hid_t space_id = H5Dget_space(did);
+  int rank = H5Sget_simple_extent_ndims(space_id);
+  hsize_t dims[H5S_MAX_RANK];
+  if (rank<1 || H5Sget_simple_extent_dims(space_id, dims, NULL)<0) {
+    H5Sclose(space_id);
+    return;
+  }
+
+  // frames the file claims to hold
+  unsigned long long ndeclared = dims[0];
+  if (r->image_nr==H5CHECK_NR_READ) {
+    ndeclared = (r->image_nr_high>=r->image_nr_low) ? r->image_nr_high - r->image_nr_low + 1 : 0;
+  }
+  unsigned long long nframes = (ndeclared<dims[0]) ? ndeclared : dims[0];
+
+  hid_t cpl = H5Dget_create_plist(did);
+  H5D_layout_t layout = H5Pget_layout(cpl);
+  if (layout==H5D_CHUNKED) {
+    hsize_t cdims[H5S_MAX_RANK];
+    if (H5Pget_chunk(cpl, rank, cdims)==rank) {
+      // chunks per frame (row of chunks along the first dimension) and
+      // in the whole dataset
+      unsigned long long nper = 1;
+      for (int idim = 1; idim < rank; idim++) nper *= (dims[idim] + cdims[idim] - 1)/cdims[idim];
+      unsigned long long nrows  = (nframes + cdims[0] - 1)/cdims[0];
+      unsigned long long ntotal = nper*((dims[0] + cdims[0] - 1)/cdims[0]);
+      hsize_t nchunks = 0;
+      if (H5Dget_num_chunks(did, space_id, &nchunks)<0 || nchunks<ntotal) {
+	hsize_t offset[H5S_MAX_RANK];
+	for (unsigned long long irow = 0; irow < nrows; irow++) {
+	  int written = 1;
+	  offset[0] = irow*cdims[0];
+	  for (int idim = 1; idim < rank; idim++) offset[idim] = 0;
+	  while (2 != 3) {
+	    unsigned filter_mask = 0;
+	    haddr_t addr = HADDR_UNDEF;
+	    hsize_t size = 0;
+	    herr_t status;
+	    H5E_BEGIN_TRY {
+	      status = H5Dget_chunk_info_by_coord(did, offset, &filter_mask, &addr, &size);
+	    } H5E_END_TRY;
+	    if (status<0 || addr==HADDR_UNDEF) {
+	      written = 0;
+	      break;
+	    }
+	    // next chunk within this frame
+	    int idim = rank - 1;
+	    while (idim>0) {
+	      offset[idim] += cdims[idim];
+	      if (offset[idim] < dims[idim]) break;
+	      offset[idim] = 0;
+	      idim--;
+	    }
+	    if (idim==0) break;
+	  }
+	  if (!written) {
+	    unsigned long long last = (irow+1)*cdims[0];
+	    if (last>nframes) last = nframes;
+	    h5check_add_gap(r, irow*cdims[0], last-1);
+	  }
+	}
+      }
+    }
+  }
+  else if (layout==H5D_CONTIGUOUS) {
+    H5D_space_status_t space_status;
+    if (nframes>0 && H5Dget_space_status(did, &space_status)>=0 && space_status==H5D_SPACE_STATUS_NOT_ALLOCATED) {
+      h5check_add_gap(r, 0, nframes-1);
+    }
+  }
+  H5Pclose(cpl);
+  H5Sclose(space_id);
+
+  // image_nr_high beyond the dataset itself
+  if (ndeclared>nframes) {
+    h5check_add_gap(r, nframes, ndeclared-1);
+  }
+}
+
+void h5check_add_gap(h5check_result* r, unsigned long long first, unsigned long long last)
+{
+  r->nmissing += last - first + 1;
+  // the last range is extended even when it is no longer kept
+  if (r->ngaps>0 && r->gap_last+1==first) {
+    if (r->ngaps<=H5CHECK_GAPS) r->gap[r->ngaps-1][1] = last;
+    r->gap_last = last;
+    return;
+  }
+  if (r->ngaps<H5CHECK_GAPS) {
+    r->gap[r->ngaps][0] = first;
+    r->gap[r->ngaps][1] = last;
+  }
+  r->gap_last = last;
+  r->ngaps++;
+}
+
+// the images of one external file that have no data written, with
+// imgnum0 the image number of its first frame
+void h5check_print_gaps(imginfo_ctx* ctx, const h5check_link* l, unsigned long long imgnum0)
+{
+  const h5check_result* r = &l->r;
+  imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: %llu image(s) in data file %s have not been written:\n",r->nmissing,l->file.c_str());
+  for (int igap = 0; igap < r->ngaps && igap < H5CHECK_GAPS; igap++) {
+    if (r->gap[igap][0]==r->gap[igap][1]) {
+      imginfo_log(ctx, IMGINFO_WARNING, "            image  %llu\n",imgnum0+r->gap[igap][0]);
+    } else {
+      imginfo_log(ctx, IMGINFO_WARNING, "            images %llu - %llu\n",imgnum0+r->gap[igap][0],imgnum0+r->gap[igap][1]);
+    }
+  }
+  if (r->ngaps>H5CHECK_GAPS) {
+    imginfo_log(ctx, IMGINFO_WARNING, "            ... and %d more range(s)\n",r->ngaps-H5CHECK_GAPS);
+  }
+}
+
+// collect one link of /entry/data (called through H5Literate)
+herr_t h5check_census_link(hid_t gid, const char* name, const H5L_info_t* info, void* op_data)
+{
+  imginfo_ctx* ctx = ((h5_census*) op_data)->ctx;
+  vector<h5_link>* census = &((h5_census*) op_data)->links;
+  h5_link l;
+  l.name = name;
+  l.type = info->type;
+  if (info->type==H5L_TYPE_EXTERNAL) {
+    const char *filename;
+    const char *path;
+    vector<char> buf(info->u.val_size);
+    if (H5Lget_val(gid,name,(void *)&buf[0],buf.size(),H5P_DEFAULT) < 0 ) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Lget_val!\n\n");
+      return(-1);
+    }
+    if ( H5Lunpack_elink_val(&buf[0], buf.size(), NULL, &filename, &path) < 0 ) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Lunpack_elink_val!\n\n");
+      return(-1);
+    }
+    l.filename = filename;
+    l.path     = path;
+  }
+  census->push_back(l);
+  return(0);
+}
+
+// add the images of one external file to the image number mapping
+// (strictly in link order)
+int h5check_merge_link(h5check_state* hc, int ilink)
+{
+  imginfo_ctx* ctx = hc->ctx;
+  h5check_link* l = &(*hc->links)[ilink];
+  h5check_result* r = &l->r;
+  const char *f    = l->file.c_str();
+  const char *path = l->path.c_str();
+
+  if (r->status==H5CHECK_LINK_NO_FILE) {
+    hc->action = H5CHECK_BREAK;
+    return 1;
+  }
+  if (r->status==H5CHECK_LINK_NO_DATASET) {
+    hc->action = H5CHECK_RETURN;
+    return 1;
+  }
+  if (r->status==H5CHECK_LINK_FATAL) {
+    hc->action = H5CHECK_EXIT;
+    return 1;
+  }
+
+  if (r->image_nr==H5CHECK_NR_NONE) {
+    if (ctx->iverb>1&&hc->have_image_nr_high==1) {
+      imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem finding attribute \"%s\" in dataset \"%s\".\n","image_nr_high",f);
+      imginfo_log(ctx, IMGINFO_DEBUG, "              We will assume images are starting at 1 and come in sequential order.\n");
+    }
+    hc->have_image_nr_high=0;
+    if (ctx->iverb>2) {
+      imginfo_log(ctx, IMGINFO_DEBUG, "     dims_id[0]=%llu\n",r->dims0);
+    }
+    for (unsigned long long inimage_to_imgnum = hc->nimages_found; inimage_to_imgnum < (hc->nimages_found + r->dims0); inimage_to_imgnum++ ) {
+      if (inimage_to_imgnum < (unsigned long long) hc->nimages) {
+	hc->nimage_to_imgnum[inimage_to_imgnum] = inimage_to_imgnum + 1;
+      }
+    }
+    if (r->nmissing>0) h5check_print_gaps(ctx, l, hc->nimages_found + 1);
+    hc->nimages_found = hc->nimages_found + r->dims0;
+  }
+  else if (r->image_nr==H5CHECK_NR_READ) {
+    if (ctx->iverb>2) {
+      imginfo_log(ctx, IMGINFO_DEBUG, "     %s %s/image_nr_low  = %d\n",f,path,r->image_nr_low);
+      imginfo_log(ctx, IMGINFO_DEBUG, "     %s %s/image_nr_high = %d\n",f,path,r->image_nr_high);
+    }
+    for (int inimage_to_imgnum = hc->nimages_found; inimage_to_imgnum < (hc->nimages_found + (r->image_nr_high - r->image_nr_low + 1)); inimage_to_imgnum++ ) {
+      if (inimage_to_imgnum < hc->nimages) {
+	hc->nimage_to_imgnum[inimage_to_imgnum]=r->image_nr_low + (inimage_to_imgnum-hc->nimages_found);
+      }
+    }
+    if (r->nmissing>0) h5check_print_gaps(ctx, l, r->image_nr_low);
+    hc->nimages_found = hc->nimages_found + (r->image_nr_high - r->image_nr_low + 1);
+  }
+  hc->nmissing += r->nmissing;
+  // an incomplete file may still be being written: check it again next time
+  if (r->image_nr!=H5CHECK_NR_FAILED && r->nmissing==0 && hc->nverified==ilink) {
+    hc->nverified++;
+  }
+  return 0;
+}
+
+void h5check_print_link(imginfo_ctx* ctx, const h5check_link* l, int ilink)
+{
+  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     [link=%d] dir=%s filename=%s path=%s\n",ilink,l->dir.c_str(),l->filename.c_str(),l->path.c_str());
+  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     [link=%d] strlen(dir)=%lu strlen(filename)=%lu strlen(path)=%lu\n",ilink,l->dir.size(),l->filename.size(),l->path.size());
+}
+
+// a worker process sends back the h5check_result followed by its report
+// and diagnostics, which are then added to those of the calling process
+int h5check_link_task(int itask, int fd_result, void* arg)
+{
+  h5check_state* hc = (h5check_state*) arg;
+  imginfo_result res;
+  imginfo_ctx ctx = *hc->ctx;
+  ctx.res = &res;
+  h5check_result r;
+  int ilink = hc->first + itask;
+  // open the external file directly, without going through the
+  // (shared) master file - so it doesn't end up in the external link
+  // cache of the master file handle either: only in-process checks
+  // leave the data files open for later queries
+  h5check_external_link(&ctx, -1, &(*hc->links)[ilink], (itask==0&&ctx.iverb>0), &r);
+
+  string buf((const char*) &r, sizeof(r));
+  h5check_put_string(buf, res.report);
+  for (size_t idiag = 0; idiag < res.diags.size(); idiag++) {
+    buf.append((const char*) &res.diags[idiag].level, sizeof(int));
+    h5check_put_string(buf, res.diags[idiag].text);
+  }
+  size_t nwritten = 0;
+  while (nwritten<buf.size()) {
+    ssize_t n = write(fd_result, buf.data()+nwritten, buf.size()-nwritten);
+    if (n<0 && errno==EINTR) continue;
+    if (n<=0) return EXIT_FAILURE;
+    nwritten += n;
+  }
+  return EXIT_SUCCESS;
+}
+
+void h5check_put_string(string& buf, const string& s)
+{
+  size_t n = s.size();
+  buf.append((const char*) &n, sizeof(n));
+  buf.append(s);
+}
+
+int h5check_get_string(const char** p, const char* end, string& s)
+{
+  size_t n;
+  if ((size_t)(end-*p)<sizeof(n)) return 0;
+  memcpy(&n, *p, sizeof(n));
+  *p += sizeof(n);
+  if ((size_t)(end-*p)<n) return 0;
+  s.assign(*p, n);
+  *p += n;
+  return 1;
+}
+
+int h5check_link_report(int itask, int status, const string& output, const string& result, void* arg)
+{
+  h5check_state* hc = (h5check_state*) arg;
+  imginfo_ctx* ctx = hc->ctx;
+  int ilink = hc->first + itask;
+  h5check_print_link(ctx, &(*hc->links)[ilink], ilink+1);
+  // a worker that didn't send back its result must have given up
+  if (!WIFEXITED(status) || WEXITSTATUS(status)!=EXIT_SUCCESS || result.size()<sizeof(h5check_result)) {
+    imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - h5check worker process failed!\n\n");
+    hc->action = H5CHECK_EXIT;
+    return 1;
+  }
+  memcpy(&(*hc->links)[ilink].r, result.data(), sizeof(h5check_result));
+  const char *p   = result.data() + sizeof(h5check_result);
+  const char *end = result.data() + result.size();
+  string report;
+  vector<imginfo_diag> diags;
+  h5check_get_string(&p, end, report);
+  while ((size_t)(end-p)>=sizeof(int)) {
+    imginfo_diag d;
+    memcpy(&d.level, p, sizeof(int));
+    p += sizeof(int);
+    if (!h5check_get_string(&p, end, d.text)) break;
+    diags.push_back(d);
+  }
+  imginfo_log_text(ctx, report, diags);
+  return h5check_merge_link(hc, ilink);
+}
+
+// check all external links - using up to nworker worker processes. The
+// first hc->first links have been checked before (-h5resume) and only
+// need adding to the image number mapping.
+// check all links not known from -h5resume: in nworker processes (0 =
+// see H5JOBS_MAX) or in-process through the master file, which keeps
+// the data files open in its external link cache for whatever is read
+// from them next (e.g. the frames with -verify)
+void h5check_links(h5check_state* hc, int nworker)
+{
+  imginfo_ctx* ctx = hc->ctx;
+  int nlinks = hc->links->size();
+  hc->nverified = 0;
+  for (int ilink = 0; ilink < hc->first; ilink++) {
+    h5check_print_link(ctx, &(*hc->links)[ilink], ilink+1);
+    if (h5check_merge_link(hc, ilink)!=0) return;
+  }
+  for (int ilink = hc->first; ilink < nlinks; ilink++) {
+    get_file_stamp((*hc->links)[ilink].file.c_str(), &(*hc->links)[ilink].stamp);
+  }
+  if (nworker<=0) {
+    nworker = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nworker>H5JOBS_MAX) nworker = H5JOBS_MAX;
+    if (nworker>(nlinks-hc->first)/H5JOBS_LINKS) nworker = (nlinks-hc->first)/H5JOBS_LINKS;
+  }
+  if (nworker>1 && nlinks-hc->first>1) {
+    if (run_workers(nlinks-hc->first, nworker, h5check_link_task, h5check_link_report, hc)<0) {
+      imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unable to run worker processes!\n\n");
+      hc->action = H5CHECK_EXIT;
+    }
+  } else {
+    for (int ilink = hc->first; ilink < nlinks; ilink++) {
+      h5check_link* l = &(*hc->links)[ilink];
+      h5check_print_link(ctx, l, ilink+1);
+      h5check_external_link(ctx, hc->fid, l, (ilink==hc->first&&ctx->iverb>0), &l->r);
+      if (h5check_merge_link(hc, ilink)!=0) break;
+    }
+  }
+}
+
+// ==================================================================================================
+// -h5resume <file>: incremental h5check
+//   for collections still being written, remember what -h5check found
+//   in the external files of each master file: one line per master file
+//   (device, inode, size, mtime, number of links, full path) followed by
+//   one line per link verified so far (result, stamp of the external
+//   file, link name). On the next run the leading links that are still
+//   the same - same name, external file not touched since - are taken
+//   from there and only the remaining ones are opened.
+// ==================================================================================================
+void h5resume_read(int fd, map<string,h5resume_entry>& entries)
+{
+  string text;
+  char chunk[CHUNK];
+  ssize_t nread;
+  lseek(fd, 0, SEEK_SET);
+  while ((nread = read(fd, chunk, sizeof(chunk)))>0) {
+    text.append(chunk, nread);
+  }
+
+  h5resume_entry *entry = NULL;
+  int nlinks = 0;
+  size_t pos = 0, end;
+  while ((end = text.find('\n', pos))!=string::npos) {
+    string line = text.substr(pos, end-pos);
+    pos = end + 1;
+    unsigned long long v[8];
+    int n = 0;
+    if (sscanf(line.c_str(), "master %llu %llu %llu %llu %llu %d %n",
+               &v[0], &v[1], &v[2], &v[3], &v[4], &nlinks, &n)==6 && n>0) {
+      h5resume_entry e;
+      e.master.dev        = v[0];
+      e.master.ino        = v[1];
+      e.master.size       = v[2];
+      e.master.mtime_sec  = v[3];
+      e.master.mtime_nsec = v[4];
+      entries[line.substr(n)] = e;
+      entry = &entries[line.substr(n)];
+    }
+    else if (entry!=NULL && (int) entry->links.size()<nlinks) {
+      h5resume_link l;
+      if (sscanf(line.c_str(), "%d %d %d %d %llu %llu %llu %llu %llu %llu %n",
+                 &l.r.status, &l.r.image_nr, &l.r.image_nr_low, &l.r.image_nr_high,
+                 &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &n)==10 && n>0) {
+        l.r.dims0            = v[0];
+        l.r.nmissing         = 0; // only complete files are saved
+        l.r.ngaps            = 0;
+        l.r.gap_last         = 0;
+        l.stamp.dev          = v[1];
+        l.stamp.ino          = v[2];
+        l.stamp.size         = v[3];
+        l.stamp.mtime_sec    = v[4];
+        l.stamp.mtime_nsec   = v[5];
+        l.link               = line.substr(n);
+        entry->links.push_back(l);
+      } else {
+        entry = NULL;
+      }
+    }
+  }
+}
+
+// fill in the results of all leading links that are still valid, returns
+// their number
+int h5resume_load(imginfo_ctx* ctx, const string& file, const char* master, vector<h5check_link>* links)
+{
+  char real[PATH_MAX];
+  if (realpath(master, real)==NULL) return 0;
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd<0) return 0;
+  map<string,h5resume_entry> entries;
+  flock(fd, LOCK_SH);
+  h5resume_read(fd, entries);
+  flock(fd, LOCK_UN);
+  close(fd);
+
+  map<string,h5resume_entry>::iterator e = entries.find(real);
+  if (e==entries.end()) return 0;
+  file_stamp s;
+  get_file_stamp(master, &s);
+  if (memcmp(&s, &e->second.master, sizeof(file_stamp))!=0) return 0;
+
+  int nknown = 0;
+  while (nknown < (int) links->size() && nknown < (int) e->second.links.size()) {
+    h5check_link  *l = &(*links)[nknown];
+    h5resume_link *k = &e->second.links[nknown];
+    get_file_stamp(l->file.c_str(), &s);
+    if (l->link!=k->link || memcmp(&s, &k->stamp, sizeof(file_stamp))!=0) break;
+    l->stamp = k->stamp;
+    l->r     = k->r;
+    nknown++;
+  }
+  if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, " [debug] h5resume: %d of %d external files known from %s\n",nknown,(int)links->size(),file.c_str());
+  return nknown;
+}
+
+// remember the first nverified links (and drop entries for master files
+// that have changed or gone)
+void h5resume_save(imginfo_ctx* ctx, const string& file, const char* master, const vector<h5check_link>* links, int nverified)
+{
+  char real[PATH_MAX];
+  if (realpath(master, real)==NULL) return;
+  int fd = open(file.c_str(), O_RDWR|O_CREAT, 0666);
+  if (fd<0) {
+    if (ctx->iverb>0) imginfo_log(ctx, IMGINFO_WARNING, " WARNING: unable to write -h5check state to %s!\n",file.c_str());
+    return;
+  }
+  map<string,h5resume_entry> entries;
+  flock(fd, LOCK_EX);
+  h5resume_read(fd, entries);
+
+  h5resume_entry e;
+  get_file_stamp(master, &e.master);
+  for (int ilink = 0; ilink < nverified; ilink++) {
+    h5resume_link l;
+    l.link  = (*links)[ilink].link;
+    l.stamp = (*links)[ilink].stamp;
+    l.r     = (*links)[ilink].r;
+    e.links.push_back(l);
+  }
+  entries[real] = e;
+
+  string text;
+  char line[CHAR_ARRAY_LEN*2];
+  for (map<string,h5resume_entry>::iterator ie = entries.begin(); ie != entries.end(); ie++) {
+    file_stamp s;
+    get_file_stamp(ie->first.c_str(), &s);
+    if (memcmp(&s, &ie->second.master, sizeof(file_stamp))!=0) continue;
+    snprintf(line, sizeof(line), "master %llu %llu %llu %llu %llu %d ",
+             (unsigned long long) s.dev, (unsigned long long) s.ino, (unsigned long long) s.size,
+             (unsigned long long) s.mtime_sec, (unsigned long long) s.mtime_nsec, (int) ie->second.links.size());
+    text += line + ie->first + "\n";
+    for (size_t ilink = 0; ilink < ie->second.links.size(); ilink++) {
+      const h5resume_link *l = &ie->second.links[ilink];
+      snprintf(line, sizeof(line), "%d %d %d %d %llu %llu %llu %llu %llu %llu ",
+               l->r.status, l->r.image_nr, l->r.image_nr_low, l->r.image_nr_high, l->r.dims0,
+               (unsigned long long) l->stamp.dev, (unsigned long long) l->stamp.ino, (unsigned long long) l->stamp.size,
+               (unsigned long long) l->stamp.mtime_sec, (unsigned long long) l->stamp.mtime_nsec);
+      text += line + l->link + "\n";
+    }
+  }
+  if (ftruncate(fd, 0)<0 || pwrite(fd, text.data(), text.size(), 0)!=(ssize_t) text.size()) {
+    if (ctx->iverb>0) imginfo_log(ctx, IMGINFO_WARNING, " WARNING: unable to write -h5check state to %s!\n",file.c_str());
+  }
+  flock(fd, LOCK_UN);
+  close(fd);
+}
+
+
+// ==================================================================================================
+// initialisation
+// ==================================================================================================
+void empty_header(image_header* h) {
+  h->format = FORMAT_UNKNOWN;
+  h->dist  = INIT_DOUBLE;
+  h->wave  = INIT_DOUBLE;
+  h->osca  = INIT_DOUBLE;
+  h->phis  = INIT_DOUBLE;
+  h->phie  = INIT_DOUBLE;
+  h->omes  = INIT_DOUBLE;
+  h->omee  = INIT_DOUBLE;
+  h->chis  = INIT_DOUBLE;
+  h->chie  = INIT_DOUBLE;
+  h->kaps  = INIT_DOUBLE;
+  h->kape  = INIT_DOUBLE;
+  h->twot  = INIT_DOUBLE;
+  h->pixx  = INIT_DOUBLE;
+  h->pixy  = INIT_DOUBLE;
+  h->numx  = 0;
+  h->numy  = 0;
+  h->beax  = INIT_DOUBLE;
+  h->beay  = INIT_DOUBLE;
+  h->ovld  = 0;
+  h->epoch = 0;
+  h->etime = INIT_DOUBLE;
+  h->flux  = INIT_DOUBLE;
+  h->thick = INIT_DOUBLE;
+  h->fpol  = INIT_DOUBLE;
+  h->msec  = -1;
+  h->detn  = "N/A";
+  h->date  = "N/A";
+  h->sensm = "N/A";
+  h->nimg  = 0;
+  h->ntrg  = 0;
+  h->imgn  = 0;
+  h->imgl  = 0;
+  h->imgo  = 0;
+  h->nmis  = 0;
+  h->rota  = "N/A";
+  h->swps.clear();
+  h->filt.clear();
+  h->extf.clear();
+}
+
+// ==================================================================================================
+// HDF5 path lookups through a file handle
+//   groups of the master file (/entry/instrument/detector, ...) are
+//   opened once and kept open, items are then looked up relative to
+//   their group - a single link in a single group instead of a walk from
+//   the root. Whether a link exists is remembered, and a link in a group
+//   found missing is known missing without asking HDF5. HDF5 doesn't
+//   report errors while probing.
+// ==================================================================================================
+int hdf5_exists(imginfo_ctx* ctx, hid_t fid, const char* item)
+{
+  htri_t e = 0;
+  if (ctx->file==NULL || fid!=ctx->file->fid) {
+    H5E_BEGIN_TRY {
+      e = H5Lexists(fid,item,H5P_DEFAULT);
+    } H5E_END_TRY;
+    return ( e>0 );
+  }
+  map<string,int>::iterator it = ctx->file->links.find(item);
+  if (it!=ctx->file->links.end()) return it->second;
+  string name;
+  hid_t loc = hdf5_loc(ctx, fid, item, name);
+  if (loc>=0) {
+    H5E_BEGIN_TRY {
+      e = H5Lexists(loc,name.c_str(),H5P_DEFAULT);
+    } H5E_END_TRY;
+  }
+  ctx->file->links[item] = ( e>0 );
+  return ( e>0 );
+}
+
+// (kept open) group at path, -1 if there is none
+hid_t hdf5_group(imginfo_ctx* ctx, hid_t fid, const string& path)
+{
+  if (path.empty() || path=="/") return fid;
+  map<string,hid_t>::iterator it = ctx->file->groups.find(path);
+  if (it!=ctx->file->groups.end()) return it->second;
+  hid_t gid = -1;
+  if (hdf5_exists(ctx, fid, path.c_str())) {
+    string name;
+    hid_t loc = hdf5_loc(ctx, fid, path.c_str(), name);
+    H5E_BEGIN_TRY {
+      gid = H5Gopen2(loc,name.c_str(),hdf5_apl(ctx, fid, H5P_GROUP_ACCESS));
+    } H5E_END_TRY;
+  }
+  ctx->file->groups[path] = gid;
+  return gid;
+}
+
+// where to look up item: its group (and name within that) or the file
+// itself (and the full path)
+hid_t hdf5_loc(imginfo_ctx* ctx, hid_t fid, const char* item, string& name)
+{
+  const char* slash = strrchr(item,'/');
+  if (ctx->file==NULL || fid!=ctx->file->fid || slash==NULL || item[0]!='/') {
+    name = item;
+    return fid;
+  }
+  name = slash + 1;
+  return hdf5_group(ctx, fid, string(item, slash-item));
+}
+
+hid_t hdf5_open_dataset(imginfo_ctx* ctx, hid_t fid, const char* item)
+{
+  string name;
+  hid_t loc = hdf5_loc(ctx, fid, item, name);
+  if (loc<0) return -1;
+  return H5Dopen2(loc,name.c_str(),hdf5_apl(ctx, fid, H5P_DATASET_ACCESS));
+}
+
+hid_t hdf5_open_group(imginfo_ctx* ctx, hid_t fid, const char* item)
+{
+  string name;
+  hid_t loc = hdf5_loc(ctx, fid, item, name);
+  if (loc<0) return -1;
+  return H5Gopen2(loc,name.c_str(),hdf5_apl(ctx, fid, H5P_GROUP_ACCESS));
+}
+
+// ==================================================================================================
+// HDF5 reads through a file handle
+//   an item read from the master file of a handle is read only once: the
+//   result and what was reported while reading it are kept, and later
+//   reads (for other images) report the same again. Of the per-image
+//   angle arrays only the elements needed are read for the first image,
+//   the whole array once another image needs it.
+// ==================================================================================================
+hdf5_memo* hdf5_memo_get(imginfo_ctx* ctx, hid_t fid, const string& key)
+{
+  if (ctx->file==NULL || fid!=ctx->file->fid) return NULL;
+  hdf5_memo* m = &ctx->file->memo[key];
+  if (!m->done) {
+    m->report0 = ctx->res->report.size();
+    m->diags0  = ctx->res->diags.size();
+  }
+  return m;
+}
+
+void hdf5_memo_keep(imginfo_ctx* ctx, hdf5_memo* m)
+{
+  m->report = ctx->res->report.substr(m->report0);
+  m->diags.assign(ctx->res->diags.begin() + m->diags0, ctx->res->diags.end());
+  m->done = 1;
+}
+
+void hdf5_memo_replay(imginfo_ctx* ctx, const hdf5_memo* m)
+{
+  imginfo_log_text(ctx, m->report, m->diags);
+}
+
+char *hdf5_read_char(imginfo_ctx* ctx, hid_t fid, const char* item) {
+  trace_span span("hdf5", __func__, item);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("char\n") + item);
+  if (m==NULL) return hdf5_read_char_h5(ctx, fid, item);
+  if (!m->done) {
+    char* r = hdf5_read_char_h5(ctx, fid, item);
+    m->isnull = ( r==NULL );
+    if (r!=NULL) m->s = r;
+    hdf5_memo_keep(ctx, m);
+    return r;
+  }
+  hdf5_memo_replay(ctx, m);
+  return m->isnull ? NULL : arena_strdup(ctx->arena, m->s.c_str());
+}
+
+char *hdf5_read_group_attribute(imginfo_ctx* ctx, hid_t fid, const char* item, const char* attribute) {
+  trace_span span("hdf5", __func__, item);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("attribute\n") + item + "\n" + attribute);
+  if (m==NULL) return hdf5_read_group_attribute_h5(ctx, fid, item, attribute);
+  if (!m->done) {
+    char* r = hdf5_read_group_attribute_h5(ctx, fid, item, attribute);
+    m->isnull = ( r==NULL );
+    if (r!=NULL) m->s = r;
+    hdf5_memo_keep(ctx, m);
+    return r;
+  }
+  hdf5_memo_replay(ctx, m);
+  return m->isnull ? NULL : arena_strdup(ctx->arena, m->s.c_str());
+}
+
+int hdf5_read_int(imginfo_ctx* ctx, hid_t fid, const char* item) {
+  trace_span span("hdf5", __func__, item);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("int\n") + item);
+  if (m==NULL) return hdf5_read_int_h5(ctx, fid, item);
+  if (!m->done) {
+    m->i = hdf5_read_int_h5(ctx, fid, item);
+    hdf5_memo_keep(ctx, m);
+    return m->i;
+  }
+  hdf5_memo_replay(ctx, m);
+  return m->i;
+}
+
+int hdf5_read_dataset_size(imginfo_ctx* ctx, hid_t fid, const char* item) {
+  trace_span span("hdf5", __func__, item);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("size\n") + item);
+  if (m==NULL) return hdf5_read_dataset_size_h5(ctx, fid, item);
+  if (!m->done) {
+    m->i = hdf5_read_dataset_size_h5(ctx, fid, item);
+    hdf5_memo_keep(ctx, m);
+    return m->i;
+  }
+  hdf5_memo_replay(ctx, m);
+  return m->i;
+}
+
+double hdf5_read_double(imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit) {
+  trace_span span("hdf5", __func__, item);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("double\n") + item + "\n" + unit);
+  if (m==NULL) return hdf5_read_double_h5(ctx, fid, item, unit);
+  if (!m->done) {
+    m->d = hdf5_read_double_h5(ctx, fid, item, unit);
+    hdf5_memo_keep(ctx, m);
+    return m->d;
+  }
+  hdf5_memo_replay(ctx, m);
+  return m->d;
+}
+
+int* hdf5_read_nint(imginfo_ctx* ctx, hid_t fid, const char* item, int* n) {
+  trace_span span("hdf5", __func__, item);
+  char nstr[32];
+  snprintf(nstr, sizeof(nstr), "\n%d", *n);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("nint\n") + item + nstr);
+  if (m==NULL) return hdf5_read_nint_h5(ctx, fid, item, n);
+  if (!m->done) {
+    int* d = hdf5_read_nint_h5(ctx, fid, item, n);
+    m->i = *n;
+    m->iv.assign(d, d + *n);
+    hdf5_memo_keep(ctx, m);
+    return d;
+  }
+  hdf5_memo_replay(ctx, m);
+  *n = m->i;
+  int* d = (int*) arena_alloc(ctx->arena, m->iv.size() * sizeof (int));
+  std::copy(m->iv.begin(), m->iv.end(), d);
+  return d;
+}
+
+double* hdf5_read_axis_vector(imginfo_ctx* ctx, hid_t fid, const char* item) {
+  trace_span span("hdf5", __func__, item);
+  hdf5_memo* m = hdf5_memo_get(ctx, fid, string("vector\n") + item);
+  if (m==NULL) return hdf5_read_axis_vector_h5(ctx, fid, item);
+  if (!m->done) {
+    double* d = hdf5_read_axis_vector_h5(ctx, fid, item);
+    m->dv.assign(d, d + 3);
+    hdf5_memo_keep(ctx, m);
+    return d;
+  }
+  hdf5_memo_replay(ctx, m);
+  double* d = (double*) arena_alloc(ctx->arena, 3 * sizeof (double));
+  std::copy(m->dv.begin(), m->dv.end(), d);
+  return d;
+}
+
+double* hdf5_read_ndouble_sel(imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit, int n, const int* idx, int nidx) {
+  trace_span span("hdf5", __func__, item);
+  if (ctx->file==NULL || fid!=ctx->file->fid) return hdf5_read_ndouble_sel_h5(ctx, fid, item, unit, n, idx, nidx);
+  hdf5_array& a = ctx->file->arrays[item];
+  if (a.state==HDF5_ARRAY_UNREAD) {
+    // image is 1 + the image it was read for
+    if (a.image==0 || a.image==ctx->file->nread+1) {
+      a.image = ctx->file->nread+1;
+      return hdf5_read_ndouble_sel_h5(ctx, fid, item, unit, n, idx, nidx);
+    }
+    hdf5_array_load(ctx, fid, item, &a);
+  }
+  return hdf5_array_sel(ctx, &a, item, n, idx, nidx);
+}
+
+// all of a per-image array (in storage order)
+void hdf5_array_load(imginfo_ctx* ctx, hid_t fid, const char* item, hdf5_array* a)
+{
+  a->nid  = 0;
+  a->rank = 0;
+  if (!hdf5_exists(ctx, fid, item)) {
+    a->state = HDF5_ARRAY_MISSING;
+    return;
+  }
+  hid_t did = hdf5_open_dataset(ctx, fid, item);
+  if (did<0) {
+    a->state = HDF5_ARRAY_NO_OPEN;
+    return;
+  }
+  hid_t sid = H5Dget_space(did);
+  a->nid  = H5Sget_simple_extent_npoints(sid);
+  a->rank = H5Sget_simple_extent_ndims(sid);
+  a->state = HDF5_ARRAY_NO_READ;
+  if (a->nid>0) {
+    a->v.resize(a->nid);
+    if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read all %llu items from %s\n",(unsigned long long) a->nid,item);
+    if (H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &a->v[0])>=0) {
+      a->state = HDF5_ARRAY_READ;
+    }
+  }
+  H5Sclose(sid);
+  H5Dclose(did);
+}
+
+// elements of a loaded array - as hdf5_read_ndouble_sel_h5 would read
+// (and report) them
+double* hdf5_array_sel(imginfo_ctx* ctx, const hdf5_array* a, const char* item, int n, const int* idx, int nidx)
+{
+  double *d = (double*) arena_alloc(ctx->arena, nidx * sizeof (double));
+  for(int i=0; i<nidx; i++) {
+    d[i] = INIT_DOUBLE;
+  }
+
+  if (a->state==HDF5_ARRAY_MISSING) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     %s[0] set to INIT_DOUBLE because it doesn't exist\n",item);
+    return(d);
+  }
+  if (a->state==HDF5_ARRAY_NO_OPEN) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when opening %s\n",item);
+    return(d);
+  }
+  hssize_t nid = a->nid;
+  if (nid>n) {
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read only %d items while data has size %llu\n",n,(unsigned long long) nid);
+  }
+  else if (nid<n && nid>0) {
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read %d items while data has only size %llu\n",n,(unsigned long long) nid);
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "              will set all items to %s one stored\n",(nid==1)?"first/only":"last");
+  }
+
+  if (nid>0 && a->rank>0 && a->rank<=H5S_MAX_RANK) {
+    vector<hsize_t> pos, upos;
+    hdf5_sel_positions(idx, nidx, nid, pos, upos);
+    if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read %llu of %llu items from %s\n",(unsigned long long) upos.size(),(unsigned long long) nid,item);
+    if (a->state==HDF5_ARRAY_READ) {
+      for(int i=0; i<nidx; i++) {
+        d[i] = a->v[pos[i]];
+      }
+      if (ctx->iverb>1) {
+        for(size_t ipos=0; ipos<upos.size(); ipos++) {
+          imginfo_log(ctx, IMGINFO_DEBUG, "     %s[%llu] = %f\n",item,(unsigned long long) upos[ipos],a->v[upos[ipos]]);
+        }
+      }
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when reading %s\n",item);
+    }
+  }
+
+  if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+  return(d);
+}
+
+char *hdf5_read_char_h5(imginfo_ctx* ctx, hid_t fid, const char* item) {
+
+  if (ctx->iverb > 2) {
+    imginfo_log(ctx, IMGINFO_DEBUG, "Reading char: %s\n", item);
+  }
+
+  char* r = arena_strdup(ctx->arena, "");
+  hid_t did, space_c, memtype_c, filetype_c;
+  hsize_t dims_c[1] = {1};
+  int ndims_c, sdim_c;
+  herr_t status;
+  
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0 ) {
+    did = hdf5_open_dataset(ctx, fid, item);
+
+    filetype_c = H5Dget_type(did);
+    sdim_c = H5Tget_size (filetype_c);
+    sdim_c++;                         /* Make room for null terminator */
+    space_c = H5Dget_space (did);
+    ndims_c = H5Sget_simple_extent_dims (space_c, dims_c, NULL);
+    memtype_c = H5Tcopy (H5T_C_S1);
+    
+    // if this is e.g. a variable-length string (e.g. 7OMC dataset):
+    // (HDF5 allocates the string itself)
+    if (H5Tis_variable_str(filetype_c)>0&&ndims_c==0) {
+      char *strdata = NULL;
+      status = H5Dread(did, filetype_c, H5S_ALL, H5S_ALL, H5P_DEFAULT, &strdata);
+      if (status>=0 && strdata!=NULL) {
+        r = arena_strdup(ctx->arena, strdata);
+      }
+      if (strdata!=NULL) H5free_memory(strdata);
+    }
+
+    // fixed length datatype
+    else {
+      status = H5Tset_size (memtype_c, sdim_c);
+      r = (char *) arena_alloc (ctx->arena, dims_c[0] * sdim_c * sizeof (char));
+      status = H5Dread(did, memtype_c, H5S_ALL, H5S_ALL, H5P_DEFAULT, r);
+    }
+    H5Tclose(memtype_c);
+    H5Tclose(filetype_c);
+    H5Sclose(space_c);
+
+    if (status>=0) {
+      if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "     %s = \"%s\"\n",item,r);
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem reading %s\n",item);
+    }
+    status = H5Dclose(did);
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    if (ctx->iverb>1) {
+      imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem finding %s\n",item);
+    }
+  }
+  return(r);
+}
+
+char *hdf5_read_group_attribute_h5(imginfo_ctx* ctx, hid_t fid, const char* item, const char* attribute) {
+
+  char* r = arena_strdup(ctx->arena, "");
+  hid_t gid, space_c, memtype_c, filetype_c;
+  hsize_t dims_c[1] = {1};
+  int ndims_c, sdim_c;
+  herr_t status;
+
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0) {
+    gid = hdf5_open_group(ctx, fid, item);
+
+    status = H5Aexists(gid,attribute);
+    if (status>0) {
+      hid_t attribute_id    = H5Aopen_name(gid,attribute);
+      hid_t attribute_type  = H5Aget_type(attribute_id);
+      hid_t attribute_space = H5Aget_space(attribute_id);
+      size_t attribute_n = H5Tget_size(attribute_type);
+      r = (char *)arena_alloc(ctx->arena, sizeof(char)*(attribute_n+1));
+      status = H5Aread(attribute_id, attribute_type, r);
+      // safety net (assume H5T_STR_NULLPAD)
+      // see also: https://github.com/h5py/h5py/issues/727
+      //           https://forum.hdfgroup.org/t/bug-writing-a-string-does-not-include-null-terminator/5281
+      //           https://docs.hdfgroup.org/hdf5/develop/group___h5_t.html#gae5f38bfd4a4c557496b3194b5180212c
+      r[attribute_n] = '\0';
+      if (status>=0) {
+	if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "     %s = \"%s\"\n",item,r);
+      } else {
+	if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem reading attribute %s from group %s\n",attribute,item);
+      }
+      H5Tclose(attribute_type);
+      H5Sclose(attribute_space);
+      H5Aclose(attribute_id);
+    } else {
+      if (ctx->iverb>1) {
+	imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem finding attribute \"%s\" in group %s\n",attribute,item);
+      }
+    }
+    status = H5Gclose(gid);
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    if (ctx->iverb>1) {
+      imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem finding %s\n",item);
+    }
+  }
+  return(r);
+}
+
+int hdf5_read_int_h5(imginfo_ctx* ctx, hid_t fid, const char* item) {
+
+  // supports H5T_NATIVE_INT
+  //          H5T_NATIVE_LONG
+  //          H5T_NATIVE_ULONG
+  //          H5T_NATIVE_USHORT
+  //          H5T_NATIVE_UINT
+  //          H5T_NATIVE_FLOAT
+  //          H5T_NATIVE_DOUBLE
+
+  if (ctx->iverb > 2) {
+    imginfo_log(ctx, IMGINFO_DEBUG, "Reading int: %s\n", item);
+  }
+
+  int r = INIT_INT;
+  hid_t did;
+  herr_t status;
+  int data_i[10];
+
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0 ) {
+    did = hdf5_open_dataset(ctx, fid, item);
+    hid_t ptyp = H5Dget_type(did);
+    size_t ptyp_size;
+    hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
+    if (H5Tequal(type,H5T_NATIVE_INT)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read INT from %s\n",item);
+      status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_i);
+    }
+    else if (H5Tequal(type,H5T_NATIVE_LONG)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read LONG from %s\n",item);
+      long data_d[10];
+      status = H5Dread(did, H5T_NATIVE_LONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
+      if (status>=0) {
+        data_i[0] = (int) data_d[0];
+      }
+    }
+    else if (H5Tequal(type,H5T_NATIVE_ULONG)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read UNSIGNED LONG from %s\n",item);
+      unsigned long data_d[10];
+      status = H5Dread(did, H5T_NATIVE_ULONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
+      if (status>=0) {
+        data_i[0] = (int) data_d[0];
+      }
+    }
+    else if (H5Tequal(type,H5T_NATIVE_USHORT)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read UNSIGNED SHORT from %s\n",item);
+      unsigned short data_d[10];
+      status = H5Dread(did, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
+      if (status>=0) {
+        data_i[0] = (int) data_d[0];
+      }
+    }
+    else if (H5Tequal(type,H5T_NATIVE_UINT)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read UNSIGNED INT from %s\n",item);
+      unsigned int data_d[10];
+      status = H5Dread(did, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
+      if (status>=0) {
+        data_i[0] = (int) data_d[0];
+      }
+    }
+    else if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read DOUBLE from %s\n",item);
+      double data_d[10];
+      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
+      if (status>=0) {
+        data_i[0] = (int) data_d[0];
+      }
+    }
+    else if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read FLOAT from %s\n",item);
+      float data_f[10];
+      status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_f);
+      if (status>=0) {
+        data_i[0] = (int) data_f[0];
+      }
+    }
+    else {
+      imginfo_log(ctx, IMGINFO_ERROR, "     ERROR: unsupported datatype for item %s = %ld\n",item,type);
+    }
+    if (status>=0) {
+      r = data_i[0];
+      if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "     %s = %d\n",item,r);
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: error when reading %s\n",item);
+    }
+    status = H5Dclose(did);
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: %s doesn't exist\n",item);
+  }
+  return(r);
+
+}
+
+int hdf5_read_dataset_size_h5(imginfo_ctx* ctx, hid_t fid, const char* item) {
+
+  int r = INIT_INT;
+  hid_t did;
+  herr_t status;
+
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0 ) {
+    did = hdf5_open_dataset(ctx, fid, item);
+    hid_t sid = H5Dget_space(did);
+    r = (int) H5Sget_simple_extent_npoints(sid);
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     dataset \"%s\" has size %d\n",item,r);
+  } else {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: %s doesn't exist\n",item);
+  }
+  return(r);
+
+}
+
+double hdf5_read_double_h5(imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit) {
+
+  double r = INIT_DOUBLE;
+  hid_t did;
+  herr_t status;
+  double data_d[10];
+  double fac = 1.0;
+
+  if (ctx->iverb > 2) {
+    imginfo_log(ctx, IMGINFO_DEBUG, "Reading double: %s\n", item);
+  }
+
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0 ) {
+    did = hdf5_open_dataset(ctx, fid, item);
+    hid_t ptyp = H5Dget_type(did);
+    size_t ptyp_size;
+    hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
+    if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read DOUBLE from %s\n",item);
+      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_d);
+    } else {
+      if (H5Tequal(type,H5T_NATIVE_INT)) {
+        if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read INT from %s\n",item);
+        int data_i[10];
+        status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_i);
+        if (status>=0) {
+          data_d[0] = (double) data_i[0];
+        }
+      }
+      else if (H5Tequal(type,H5T_NATIVE_LONG)) {
+        if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read LONG from %s\n",item);
+        long data_i[10];
+        status = H5Dread(did, H5T_NATIVE_LONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_i);
+        if (status>=0) {
+          data_d[0] = (double) data_i[0];
+        }
+      }
+      else if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
+        if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read FLOAT from %s\n",item);
+        float data_f[10];
+        status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data_f);
+        if (status>=0) {
+          data_d[0] = (double) data_f[0];
+        }
+      }
+      else {
+        imginfo_log(ctx, IMGINFO_ERROR, "     ERROR: unsupported datatype for item %s = %ld\n",item,type);
+      }
+    }
+
+    if (status>=0) {
+      r = data_d[0];
+      if (strcmp(unit,"NULL")!=0) {
+	int l = strlen(unit);
+	status = H5Aexists(did,"units");
+	if (status>0) {
+	  hid_t attribute_id    = H5Aopen_name(did,"units");
+	  hid_t attribute_type  = H5Aget_type(attribute_id);
+	  hid_t attribute_space = H5Aget_space(attribute_id);
+	  size_t attribute_n = H5Tget_size(attribute_type);
+	  char* string_array = (char *)malloc(sizeof(char)*(attribute_n+1));
+	  H5Aread(attribute_id, attribute_type, string_array);
+	  string_array[attribute_n] = '\0';
+	  if ( (l!=attribute_n) || (strncmp(unit,string_array,l)!=0)) {
+	    if      ((strcmp(unit,"m")==0)&&(strcmp(string_array,"mm")==0)) {
+	      fac = 0.001;
+	    }
+	    else if ((strcmp(unit,"mm")==0)&&(strcmp(string_array,"m")==0)) {
+	      fac = 1000.0;
+	    }
+	    // accept degree/deg "mismatch"
+	    else if ((strcmp(unit,"degree")==0)&&(strcmp(string_array,"deg")==0)) {
+	      fac = 1.0;
+	    }
+	    else if ((strcmp(unit,"deg")==0)&&(strcmp(string_array,"degree")==0)) {
+	      fac = 1.0;
+	    }
+	    else if (strncmp(unit,string_array,(l-1))!=0) {
+	      imginfo_log(ctx, IMGINFO_WARNING, "\n WARNING: expected unit \"%s\" for item \"%s\" - but found unit \"%s\" (length=%d)!!\n\n",unit,item,string_array,l);
+	    }
+	  }
+	  if (ctx->iverb>1) {
+	    imginfo_log(ctx, IMGINFO_DEBUG, "     %s = %f %s\n",item,r,unit);
+	  }
+	  free(string_array);
+	  H5Tclose(attribute_type);
+	  H5Sclose(attribute_space);
+	  H5Aclose(attribute_id);
+	} else {
+	  if (ctx->iverb>1) {
+	    imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem finding attribute \"units\" in group %s\n",item);
+	  }
+	}
+      } else {
+	if (ctx->iverb>1) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     %s = %f\n",item,r);
+	}
+      }
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when reading %s\n",item);
+    }
+    status = H5Dclose(did);
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: %s doesn't exist\n",item);
+  }
+  return(r*fac);
+
+}
+
+double* hdf5_read_ndouble(imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit, int* n) {
+  trace_span span("hdf5", __func__, item);
+
+  int s = (*n * sizeof (double));
+  double *d = (double*) arena_alloc(ctx->arena, s);
+  hid_t did;
+  herr_t status;
+
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0 ) {
+    did = hdf5_open_dataset(ctx, fid, item);
+
+    hid_t sid = H5Dget_space(did);
+    hsize_t nid = H5Sget_simple_extent_npoints(sid);
+    if (nid>*n) {
+      if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read only %d items while data has size %llu\n",*n,nid);
+      s = (nid * sizeof (double));
+      double *d_tmp = (double*) malloc(s);
+      // check if these are truly H5T_NATIVE_DOUBLE
+      hid_t ptyp = H5Dget_type(did);
+      size_t ptyp_size;
+      hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
+      if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
+        if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read %llu DOUBLEs from %s\n",nid,item);
+        status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d_tmp);
+      } else {
+        if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
+          float *f_tmp = (float*) malloc(s);
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read %llu FLOATs from %s\n",nid,item);
+          status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, f_tmp);
+          if (status>=0) {
+            for(int i=0; i<*n; i++) {
+              d_tmp[i]=(double) f_tmp[i];
+            }
+          }
+          free(f_tmp);
+        } else {
+          imginfo_log(ctx, IMGINFO_ERROR, "     ERROR: unsupported datatype for item %s = %ld\n",item,type);
+        }
+      }
+      H5Tclose(type);
+      H5Tclose(ptyp);
+      for(int i=0; i<*n; i++) {
+	d[i]=d_tmp[i];
+	if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     setting d[%d] = d_tmp[%d] = %f\n",i,i,d[i]);
+      }
+      free(d_tmp);
+    }
+    else if (nid<*n) {
+      if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read %d items while data has only size %llu\n",*n,nid);
+      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d);
+      if (nid==1) {
+	if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "              will set all items to first/only one stored = %f\n",d[0]);
+	for(int i=1; i<*n; i++) {
+	  d[i]=d[0];
+	}
+      } else {
+	if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "              will set all items to last one stored = %f\n",d[(nid-1)]);
+	for(int i=nid; i<*n; i++) {
+	  d[i]=d[(nid-1)];
+	}
+      }
+    }
+    else {
+      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, d);
+    }
+    if (status>=0) {
+      if (ctx->iverb>1) {
+	imginfo_log(ctx, IMGINFO_DEBUG, "     %s[0] = %f\n",item,d[0]);
+	if (*n>1) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     %s[1] = %f\n",item,d[1]);
+	  if (*n>2) {
+	    imginfo_log(ctx, IMGINFO_DEBUG, "     %s[2] = %f\n",item,d[2]);
+	  }
+	} else {
+	  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     only one item to be read - not reporting further values\n");
+	}
+      }
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when reading %s\n",item);
+      d[0] = INIT_DOUBLE;
+    }
+    H5Sclose(sid);
+    status = H5Dclose(did);
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    d[0] = INIT_DOUBLE;
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     %s[0] set to INIT_DOUBLE because it doesn't exist\n",item);
+  }
+
+  return(d);
+
+}
+
+// position of each element within the dataset (in storage order) and
+// the distinct positions among them (sorted)
+void hdf5_sel_positions(const int* idx, int nidx, hssize_t nid, vector<hsize_t>& pos, vector<hsize_t>& upos)
+{
+  pos.resize(nidx);
+  for(int i=0; i<nidx; i++) {
+    pos[i] = (idx[i]<0) ? 0 : ( (idx[i]<nid) ? idx[i] : nid-1 );
+  }
+  upos = pos;
+  std::sort(upos.begin(), upos.end());
+  upos.erase(std::unique(upos.begin(), upos.end()), upos.end());
+}
+
+// elements idx[0..nidx-1] of a per-image array of n items - as
+// hdf5_read_ndouble would return them (a dataset with fewer items is
+// padded with its last one) but read through a point selection, so that
+// neither memory nor I/O grow with the number of images. An element
+// beyond n that is stored in the dataset is returned as it is.
+double* hdf5_read_ndouble_sel_h5(imginfo_ctx* ctx, hid_t fid, const char* item, const char* unit, int n, const int* idx, int nidx) {
+
+  double *d = (double*) arena_alloc(ctx->arena, nidx * sizeof (double));
+  for(int i=0; i<nidx; i++) {
+    d[i] = INIT_DOUBLE;
+  }
+
+  if (!hdf5_exists(ctx, fid, item)) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     %s[0] set to INIT_DOUBLE because it doesn't exist\n",item);
+    return(d);
+  }
+  hid_t did = hdf5_open_dataset(ctx, fid, item);
+  if (did<0) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when opening %s\n",item);
+    return(d);
+  }
+  hid_t sid = H5Dget_space(did);
+  hssize_t nid = H5Sget_simple_extent_npoints(sid);
+  int rank = H5Sget_simple_extent_ndims(sid);
+  if (nid>n) {
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read only %d items while data has size %llu\n",n,(unsigned long long) nid);
+  }
+  else if (nid<n && nid>0) {
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read %d items while data has only size %llu\n",n,(unsigned long long) nid);
+    if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_DEBUG, "              will set all items to %s one stored\n",(nid==1)?"first/only":"last");
+  }
+
+  if (nid>0 && rank>0 && rank<=H5S_MAX_RANK) {
+    vector<hsize_t> pos, upos;
+    hdf5_sel_positions(idx, nidx, nid, pos, upos);
+
+    hsize_t nsel = upos.size();
+    vector<double> v(nsel);
+    hid_t mid = H5Screate_simple(1, &nsel, NULL);
+    herr_t status;
+    if (nsel>HDF5_SEL_MAX_POINTS && nsel*HDF5_SEL_MAX_FRACTION>(hsize_t) nid) {
+      // many points (e.g. two per trigger): a point selection then costs
+      // more than reading the whole dataset and picking them out
+      vector<double> all(nid);
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read all %llu items from %s for %llu of them\n",(unsigned long long) nid,item,(unsigned long long) nsel);
+      status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &all[0]);
+      if (status>=0) {
+        for(size_t ipos=0; ipos<upos.size(); ipos++) {
+          v[ipos] = all[upos[ipos]];
+        }
+      }
+    } else {
+      hsize_t dims[H5S_MAX_RANK];
+      H5Sget_simple_extent_dims(sid, dims, NULL);
+      vector<hsize_t> coord(upos.size()*rank);
+      for(size_t ipos=0; ipos<upos.size(); ipos++) {
+        hsize_t lin = upos[ipos];
+        for(int idim=rank-1; idim>=0; idim--) {
+          coord[ipos*rank+idim] = lin % dims[idim];
+          lin = lin / dims[idim];
+        }
+      }
+      status = H5Sselect_elements(sid, H5S_SELECT_SET, nsel, &coord[0]);
+      if (status>=0) {
+        if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read %llu of %llu items from %s\n",(unsigned long long) nsel,(unsigned long long) nid,item);
+        status = H5Dread(did, H5T_NATIVE_DOUBLE, mid, sid, H5P_DEFAULT, &v[0]);
+      }
+    }
+    if (status>=0) {
+      for(int i=0; i<nidx; i++) {
+        d[i] = v[std::lower_bound(upos.begin(), upos.end(), pos[i]) - upos.begin()];
+      }
+      if (ctx->iverb>1) {
+        for(size_t ipos=0; ipos<upos.size(); ipos++) {
+          imginfo_log(ctx, IMGINFO_DEBUG, "     %s[%llu] = %f\n",item,(unsigned long long) upos[ipos],v[ipos]);
+        }
+      }
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when reading %s\n",item);
+    }
+    H5Sclose(mid);
+  }
+  H5Sclose(sid);
+
+  if (H5Dclose(did)<0) {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+  } else {
+    if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+  }
+
+  return(d);
+
+}
+
+int* hdf5_read_nint_h5(imginfo_ctx* ctx, hid_t fid, const char* item, int* n) {
+
+  // supports H5T_NATIVE_INT
+  //          H5T_NATIVE_LONG
+  //          H5T_NATIVE_ULONG
+  //          H5T_NATIVE_USHORT
+  //          H5T_NATIVE_UINT
+  //          H5T_NATIVE_FLOAT
+  //          H5T_NATIVE_DOUBLE
+
+  int s = (*n * sizeof (int));
+  int *d = (int*) arena_alloc(ctx->arena, s);
+  hid_t did;
+  herr_t status;
+
+  status = hdf5_exists(ctx, fid, item);
+  if (status > 0 ) {
+    did = hdf5_open_dataset(ctx, fid, item);
+    hid_t sid = H5Dget_space(did);
+    hsize_t nid = H5Sget_simple_extent_npoints(sid);
+    if (nid>*n) {
+      if (ctx->iverb>1) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: requested to read only %d items while data has size %llu\n",*n,nid);
+      s = (nid * sizeof (int));
+      int *d_tmp = (int*) malloc(s);
+      // check if these are truly H5T_NATIVE_INT
+      hid_t ptyp = H5Dget_type(did);
+      size_t ptyp_size;
+      hid_t type = H5Tget_native_type(ptyp, H5T_DIR_DEFAULT);
+      if (H5Tequal(type,H5T_NATIVE_INT)) {
+        if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read INT from %s\n",item);
+        status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, d_tmp);
+      }
+      else {
+        if (H5Tequal(type,H5T_NATIVE_DOUBLE)) {
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read DOUBLE from %s\n",item);
+          double *dd_tmp = (double*) malloc(s);
+          status = H5Dread(did, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
+          // cast to int
+          for(int i=0; i<*n; i++) {
+            d_tmp[i]=(int) dd_tmp[i];
+          }
+          free(dd_tmp);
+        }
+        else if (H5Tequal(type,H5T_NATIVE_FLOAT)) {
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read FLOAT from %s\n",item);
+          float *dd_tmp = (float*) malloc(s);
+          status = H5Dread(did, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
+          // cast to int
+          for(int i=0; i<*n; i++) {
+            d_tmp[i]=(int) dd_tmp[i];
+          }
+          free(dd_tmp);
+        }
+        else if (H5Tequal(type,H5T_NATIVE_LONG)) {
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read LONG from %s\n",item);
+          long *dd_tmp = (long*) malloc(s);
+          status = H5Dread(did, H5T_NATIVE_LONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
+          // cast to int
+          for(int i=0; i<*n; i++) {
+            d_tmp[i]=(int) dd_tmp[i];
+          }
+          free(dd_tmp);
+        }
+        else if (H5Tequal(type,H5T_NATIVE_ULONG)) {
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read UNSIGNED LONG from %s\n",item);
+          unsigned long *dd_tmp = (unsigned long*) malloc(s);
+          status = H5Dread(did, H5T_NATIVE_ULONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
+          // cast to int
+          for(int i=0; i<*n; i++) {
+            d_tmp[i]=(int) dd_tmp[i];
+          }
+          free(dd_tmp);
+        }
+        else if (H5Tequal(type,H5T_NATIVE_USHORT)) {
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read UNSIGNED SHORT from %s\n",item);
+          unsigned short *dd_tmp = (unsigned short*) malloc(s);
+          status = H5Dread(did, H5T_NATIVE_USHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
+          // cast to int
+          for(int i=0; i<*n; i++) {
+            d_tmp[i]=(int) dd_tmp[i];
+          }
+          free(dd_tmp);
+        }
+        else if (H5Tequal(type,H5T_NATIVE_UINT)) {
+          if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     read UNSIGNED INT from %s\n",item);
+          unsigned int *dd_tmp = (unsigned int*) malloc(s);
+          status = H5Dread(did, H5T_NATIVE_UINT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dd_tmp);
+          // cast to int
+          for(int i=0; i<*n; i++) {
+            d_tmp[i]=(int) dd_tmp[i];
+          }
+          free(dd_tmp);
+        }
+        else {
+          imginfo_log(ctx, IMGINFO_ERROR, "     ERROR: unsupported datatype for item %s = %ld\n",item,type);
+        }
+      }
+      H5Tclose(type);
+      H5Tclose(ptyp);
+      for(int i=0; i<*n; i++) {
+	d[i]=d_tmp[i];
+	if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     setting d[%d] = d_tmp[%d] = %d\n",i,i,d[i]);
+      }
+      free(d_tmp);
+    } else {
+      status = H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, d);
+    }
+    if (status>=0) {
+      if (ctx->iverb>1) {
+	imginfo_log(ctx, IMGINFO_DEBUG, "     %s[0] = %d\n",item,d[0]);
+	if (*n>1) {
+	  imginfo_log(ctx, IMGINFO_DEBUG, "     %s[1] = %d\n",item,d[1]);
+	  if (*n>2) {
+	    imginfo_log(ctx, IMGINFO_DEBUG, "     %s[2] = %d\n",item,d[2]);
+	  }
+	} else {
+	  if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     only one item to be read - not reporting further values\n");
+	}
+      }
+    } else {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when reading %s\n",item);
+      d[0] = INIT_INT;
+    }
+    H5Sclose(sid);
+    status = H5Dclose(did);
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    d[0] = INIT_INT;
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     %s[0] set to INIT_DOUBLE because it doesn't exist\n",item);
+  }
+
+  return(d);
+
+}
+double* hdf5_read_axis_vector_h5(imginfo_ctx* ctx, hid_t fid, const char* item) {
+
+  int s = (3 * sizeof (double));
+  double *d = (double*) arena_alloc(ctx->arena, s);
+
+  d[0]=INIT_DOUBLE;
+  d[1]=INIT_DOUBLE;
+  d[2]=INIT_DOUBLE;
+
+  hid_t gid;
+  herr_t status;
+  double data_d[10];
+  H5O_info_t info;
+
+  if (hdf5_exists(ctx, fid,item)) {
+    string name;
+    hid_t loc = hdf5_loc(ctx, fid, item, name);
+    status = H5Oget_info_by_name(loc,name.c_str(),&info,hdf5_apl(ctx, fid, H5P_LINK_ACCESS));
+    switch (info.type) {
+      case H5O_TYPE_DATASET:
+	gid = hdf5_open_dataset(ctx, fid, item);
+	if (gid < 0) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - group/dataset=\"%s\" doesn't exist!\n\n",item);
+	  return(d);
+	}
+	break;
+      case H5O_TYPE_GROUP:
+	gid = hdf5_open_group(ctx, fid, item);
+	if (gid < 0) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - in H5Gopen2 (group=\"%s\")!\n\n",item);
+	  return(d);
+	}
+	break;
+    }
+
+    if (H5Aexists(gid,"vector")>0) {
+      hid_t attribute_id    = H5Aopen_name(gid,"vector");
+      hid_t attribute_type  = H5Aget_type(attribute_id);
+      hid_t attribute_space = H5Aget_space(attribute_id);
+      size_t attribute_n    = H5Tget_size(attribute_type);
+
+      if (H5Aread(attribute_id,H5T_NATIVE_DOUBLE,data_d) >= 0 ) {
+	if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, "     %s vector = %f %f %f\n",item,data_d[0],data_d[1],data_d[2]);
+	d[0]=data_d[0];
+	d[1]=data_d[1];
+	d[2]=data_d[2];
+      }
+      H5Tclose(attribute_type);
+      H5Sclose(attribute_space);
+      H5Aclose(attribute_id);
+    }
+    switch (info.type) {
+      case H5O_TYPE_DATASET:
+	status = H5Dclose(gid);
+	break;
+      case H5O_TYPE_GROUP:
+	status = H5Gclose(gid);
+	break;
+    }
+    if (status<0) {
+      if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: problem when closing %s\n",item);
+    } else {
+      if (ctx->iverb>3) imginfo_log(ctx, IMGINFO_DEBUG, "     successfully closed %s\n",item);
+    }
+  } else {
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_WARNING, "     WARNING: %s doesn't exist\n",item);
+  }
+  return(d);
+
+}
+// collect the filters of a dataset creation property list (without
+// any checks or reporting)
+void hdf5_get_filters(hid_t plist, vector<image_filter>& filters) {
+  int nfilt = H5Pget_nfilters(plist);
+  for (int ifilt = 0; ifilt < nfilt; ifilt++ ) {
+    unsigned     filt_flags;
+    unsigned     filt_cd_values[20];
+    size_t       filt_cd_nelmts = 20;
+    char         filt_name[256];
+    unsigned     filt_config;
+    image_filter f;
+    f.id   = H5Pget_filter(plist,ifilt,&filt_flags,&filt_cd_nelmts,filt_cd_values,sizeof(filt_name),filt_name,&filt_config);
+    f.name = filt_name;
+    filters.push_back(f);
+  }
+}
+
+int hdf5_list_filters(imginfo_ctx* ctx, hid_t plist) {
+    int nfilt = H5Pget_nfilters(plist);
+    if (nfilt<=0) return(1);
+    unsigned ifilt;
+    unsigned     filt_flags;          /* filter flags */
+    H5Z_filter_t filt_id;             /* filter identification number */
+    unsigned     filt_cd_values[20];  /* filter client data values */
+    filt_cd_values[0] =  1;
+    filt_cd_values[1] =  2;
+    filt_cd_values[2] =  3;
+    filt_cd_values[3] =  4;
+    filt_cd_values[4] =  5;
+    size_t       filt_cd_nelmts = 0;  /* filter client number of values */
+    char         filt_name[256];      /* filter name */
+    unsigned     filt_config;         /* Bit field, as described in H5Zget_filter_info. */
+    htri_t avail;
+
+    if (ctx->iverb>2) imginfo_log(ctx, IMGINFO_DEBUG, " Number of filters in file = %d\n",nfilt);
+
+    for (ifilt = 0; ifilt < nfilt; ifilt++ ) {
+      filt_id = H5Pget_filter(plist,ifilt,&filt_flags,&filt_cd_nelmts,filt_cd_values,sizeof(filt_name),filt_name,&filt_config);
+      if (ctx->iverb>=0) imginfo_log(ctx, IMGINFO_INFO, " Filter-%d : %s (%d)\n",ifilt,filt_name,filt_id);
+      switch (filt_id) {
+      case H5Z_FILTER_DEFLATE:
+	if (ctx->iverb>=1) imginfo_log(ctx, IMGINFO_DEBUG, "   natively supported filter = H5Z_FILTER_DEFLATE\n");
+	avail = H5Zfilter_avail(filt_id);
+	if (!avail) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - gzip filter not available.\n");
+	  ctx->fatal = 1;
+	  return(0);
+	}
+	break;
+      case H5Z_FILTER_SHUFFLE:
+	if (ctx->iverb>=1) imginfo_log(ctx, IMGINFO_DEBUG, "   natively supported filter = H5Z_FILTER_SHUFFLE\n");
+	avail = H5Zfilter_avail(filt_id);
+	if (!avail) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - Shuffle filter not available.\n");
+	  ctx->fatal = 1;
+	  return(0);
+	}
+	break;
+      case H5Z_FILTER_FLETCHER32:
+	if (ctx->iverb>=1) imginfo_log(ctx, IMGINFO_DEBUG, "   natively supported filter = H5Z_FILTER_FLETCHER32\n");
+	avail = H5Zfilter_avail(filt_id);
+	if (!avail) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - fletcher32 filter not available.\n");
+	  ctx->fatal = 1;
+	  return(0);
+	}
+	break;
+      case H5Z_FILTER_SZIP:
+	if (ctx->iverb>=1) imginfo_log(ctx, IMGINFO_DEBUG, "   natively supported filter = H5Z_FILTER_SZIP\n");
+	avail = H5Zfilter_avail(filt_id);
+	if (!avail) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - szip filter not available.\n");
+	  ctx->fatal = 1;
+	  return(0);
+	}
+	break;
+      case H5Z_FILTER_NBIT:
+	if (ctx->iverb>=1) imginfo_log(ctx, IMGINFO_DEBUG, "   natively supported filter = H5Z_FILTER_NBIT\n");
+	avail = H5Zfilter_avail(filt_id);
+	if (!avail) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - n-bit filter not available.\n");
+	  ctx->fatal = 1;
+	  return(0);
+	}
+	break;
+      case H5Z_FILTER_SCALEOFFSET:
+	if (ctx->iverb>=1) imginfo_log(ctx, IMGINFO_DEBUG, "   natively supported filter = H5Z_FILTER_SCALEOFFSET\n");
+	avail = H5Zfilter_avail(filt_id);
+	if (!avail) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - scale-offset filter not available.\n");
+	  ctx->fatal = 1;
+	  return(0);
+	}
+      default:
+#ifdef USE_BITSHUFFLE
+#ifdef USE_LZ4
+	if ( filt_id!=LZ4_FILTER && filt_id!=BSHUF_H5FILTER ) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unsupported filter Filter-%d : %s (%d)!\n",ifilt,filt_name,filt_id);
+	  imginfo_log(ctx, IMGINFO_ERROR, "         supported filters are BITSHUFFLE (%d) and LZ4 (%d)\n\n",BSHUF_H5FILTER,LZ4_FILTER);
+	  ctx->fatal = 1;
+	  return(0);
+	} else {
+          if (ctx->iverb>=1&&filt_id==LZ4_FILTER    ) {
+            imginfo_log(ctx, IMGINFO_DEBUG, "   supported filter = LZ4_FILTER\n");
+          }
+          else if (ctx->iverb>=1&&filt_id==BSHUF_H5FILTER) {
+            imginfo_log(ctx, IMGINFO_DEBUG, "   supported filter = BSHUF_H5FILTER\n");
+          }
+          else {
+            imginfo_log(ctx, IMGINFO_INFO, "   unsupported filter = %d\n",filt_id);
+          }
+        }
+#else
+	if ( filt_id!=BSHUF_H5FILTER ) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unsupported filter Filter-%d : %s (%d)!\n",ifilt,filt_name,filt_id);
+	  imginfo_log(ctx, IMGINFO_ERROR, "         supported filter is BITSHUFFLE (%d)\n",BSHUF_H5FILTER);
+	  ctx->fatal = 1;
+	  return(0);
+	} else {
+          if (ctx->iverb>=1&&filt_id==BSHUF_H5FILTER) {
+            imginfo_log(ctx, IMGINFO_DEBUG, "   supported filter = BSHUF_H5FILTER\n");
+          }
+          else {
+            imginfo_log(ctx, IMGINFO_INFO, "   unsupported filter = %d\n",filt_id);
+          }
+        }
+#endif
+#else
+#ifdef USE_LZ4
+	if ( filt_id!=LZ4_FILTER ) {
+	  imginfo_log(ctx, IMGINFO_ERROR, "\n\n ERROR - unsupported filter Filter-%d : %s (%d)!\n",ifilt,filt_name,filt_id);
+	  imginfo_log(ctx, IMGINFO_ERROR, "         supported filter is LZ4 (%d)\n",LZ4_FILTER);
+	  ctx->fatal = 1;
+	  return(0);
+	} else {
+          if (ctx->iverb>=1&&filt_id==LZ4_FILTER    ) {
+            imginfo_log(ctx, IMGINFO_DEBUG, "   supported filter = LZ4_FILTER\n");
+          }
+          else {
+            imginfo_log(ctx, IMGINFO_INFO, "   unsupported filter = %d\n",filt_id);
+          }
+        }
+#endif
+#endif
+      }
+    }
+    return(1);
+}
+
@@ -0,0 +1,222 @@
+//     **********************************************************************
+//
+//      Copyright (c) 2017, 2024 Global Phasing Ltd.
+//
+//      This Source Code Form is subject to the terms of the Mozilla Public
+//      License, v. 2.0. If a copy of the MPL was not distributed with this
+//      file, you can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//      Authors: Clemens Vonrhein, Claus Flensburg, Thomas Womack and Gerard Bricogne
+//
+//     **********************************************************************
+
+// libimginfo: read the header of an Eiger/HDF5 master file in-process.
+//
+//   imginfo_options opt = imginfo_default_options();
+//   imginfo_result  res;
+//   if (imginfo_read("x_master.h5", 0, &opt, &res) == IMGINFO_OK) {
+//     ... res.h (as filled by get_header), res.diags ...
+//   }
+//
+// imginfo_read keeps no state between calls and never prints or exits:
+// everything the imginfo program would report while reading the file is
+// handed back in res.report (verbatim) and res.diags (one entry per
+// message). Calls for different files may run in several threads at the
+// same time as long as the caller serialises the HDF5 library itself
+// (unless that is built thread-safe). With h5jobs>1 external files are
+// checked in forked worker processes.
+//
+// To read several images of the same file use a file handle instead:
+//
+//   imginfo_file* f = imginfo_open("x_master.h5", &opt);
+//   for (...) imginfo_read_image(f, imgnum, &res);
+//   imginfo_close(f);
+//
+// The master file then stays open, and what doesn't depend on the image
+// (header items, the -h5check results) is read only once - each result
+// still carries the full report as imginfo_read would give it.
+//
+// imginfo_read_frames reads the image data itself: images first..last
+// (0 = all) are read as raw chunks and decompressed by nthreads threads,
+// each frame is handed to fn (if given). The rate achieved ends up in
+// stats.
+//
+// With opt.timings each call also fills in res.timings: wall and CPU
+// time, bytes read per phase of reading the header, and counts of the
+// main HDF5 calls.
+//
+// imginfo_trace_open records spans - reading each file, each
+// hdf5_read_* call, each external file opened by -h5check - into a
+// ring buffer of nevents preallocated at the start, so that recording
+// costs no more than a clock reading and a copy. imginfo_trace_flush
+// appends what was recorded to path in Chrome trace-event format (for
+// chrome://tracing or Perfetto) and imginfo_trace_close does the same
+// and finishes the file. Forked worker processes (h5jobs) add their own
+// spans before they exit. The ring is flushed by itself whenever it
+// fills up in the thread that opened the trace, so long-running callers
+// (-serve, -watch) lose nothing as long as they record from that thread.
+// There is one trace per process, not per imginfo_file: the trace
+// functions are not thread-safe and none of them must be called while
+// other threads are still recording.
+//
+// imginfo_hash_files hashes whole files - e.g. a master file and the
+// data files in res.h.extf (found with -h5check) - in nthreads threads
+// and returns the number that couldn't be read.
+
+#ifndef LIBIMGINFO_H
+#define LIBIMGINFO_H
+
+#include <string>
+#include <vector>
+
+#include "image_headers.h"
+
+/* diagnostic levels */
+#define IMGINFO_DEBUG       0 /* only reported with iverb>0            */
+#define IMGINFO_INFO        1 /* normal report (notes, sweeps, ...)    */
+#define IMGINFO_WARNING     2
+#define IMGINFO_ERROR       3
+
+/* imginfo_read return values */
+#define IMGINFO_OK          0 /* header read                           */
+#define IMGINFO_UNREADABLE  1 /* file can't be opened/read at all      */
+#define IMGINFO_NO_HEADER   2 /* readable, but no header extracted     */
+#define IMGINFO_FATAL       3 /* e.g. unsupported filter: the imginfo
+                                 program stops altogether on these     */
+
+/* one row of the per-image table: angles (start, end) of an image */
+typedef struct imginfo_image_s {
+  INT32 imgn;      /* image number (as named in the data files)        */
+  INT32 trig;      /* trigger (1..ntrigger)                            */
+  FLT64 omeg[2];
+  FLT64 kapp[2];
+  FLT64 chi[2];
+  FLT64 phi[2];
+  FLT64 twot[2];
+} imginfo_image;
+
+/* gets the per-image table in blocks of up to IMGINFO_IMAGE_BLOCK
+   rows, a non-zero return stops it */
+#define IMGINFO_IMAGE_BLOCK 4096
+typedef int (*imginfo_image_fn)(const imginfo_image* rows, int nrows, void* arg);
+
+/* one frame of image data as handed to an imginfo_frame_fn: called from
+   the decode threads, i.e. for several frames at the same time and in no
+   particular order (and must not call HDF5) - data is only valid during
+   the call, a non-zero return stops reading */
+typedef struct imginfo_frame_s {
+  INT32 imgn;      /* image number (1.. in the order of /entry/data)   */
+  INT32 nx;
+  INT32 ny;
+  INT32 elem_size; /* bytes per pixel (native byte order)              */
+  const void* data;
+} imginfo_frame;
+
+typedef int (*imginfo_frame_fn)(const imginfo_frame* frame, void* arg);
+
+typedef struct imginfo_frame_stats_s {
+  long   nframes;  /* frames read and decompressed                     */
+  long   ndirect;  /* of which read as raw chunks (H5Dread_chunk)      */
+  double nraw;     /* bytes read from the file (compressed)            */
+  double nbytes;   /* bytes after decompression                        */
+  double seconds;  /* wall-clock time                                  */
+  int    nthreads; /* decode threads                                   */
+  long   nbad;     /* with verify: frames that couldn't be read or
+                      decoded                                          */
+  INT32  bad_imgn; /* the first of them (image number as found by
+                      -h5check, if done)                               */
+  string bad_file; /* its data file                                    */
+  string bad_error;
+} imginfo_frame_stats;
+
+/* -timings: phases of reading a header ... */
+#define IMGINFO_PHASE_BUFFER     0 /* start of the file (decompressing it)  */
+#define IMGINFO_PHASE_OPEN       1 /* H5Fopen (reading it in with h5mem)    */
+#define IMGINFO_PHASE_METADATA   2 /* detector, beam and collection items   */
+#define IMGINFO_PHASE_H5CHECK    3 /* external (data) files                 */
+#define IMGINFO_PHASE_GONIOMETER 4 /* axes (per trigger)                    */
+#define IMGINFO_PHASE_PER_IMAGE  5 /* per-image table                       */
+#define IMGINFO_PHASE_CLOSE      6
+#define IMGINFO_NPHASES          7
+
+/* ... and the HDF5 calls counted */
+#define IMGINFO_CALL_H5FOPEN     0
+#define IMGINFO_CALL_H5DOPEN     1
+#define IMGINFO_CALL_H5LEXISTS   2
+#define IMGINFO_CALL_H5DREAD     3
+#define IMGINFO_CALL_H5AREAD     4
+#define IMGINFO_NCALLS           5
+
+extern const char* imginfo_phase_name[IMGINFO_NPHASES];
+extern const char* imginfo_call_name[IMGINFO_NCALLS];
+
+typedef struct imginfo_timings_s {
+  double wall[IMGINFO_NPHASES];  /* seconds                            */
+  double cpu[IMGINFO_NPHASES];   /* seconds (of the calling thread)    */
+  double nread[IMGINFO_NPHASES]; /* bytes read by the process (-1 =
+                                    not known)                         */
+  long   calls[IMGINFO_NCALLS];  /* made by the calling thread - not
+                                    by h5jobs worker processes         */
+} imginfo_timings;
+
+typedef struct imginfo_options_s {
+  int iverb;       /* verbosity (0 = default, +1 for each -v)          */
+  int h5check;     /* check external (data) files (-h5check)           */
+  int h5jobs;      /* worker processes for -h5check (1 = in-process,
+                      0 = depending on CPUs and number of files)       */
+  string h5resume; /* -h5check state file (empty = none)               */
+  long   h5mem;    /* master files up to this size (bytes) are read
+                      into memory with a single read and opened from
+                      there (0 = never)                                */
+  int    verify;   /* imginfo_read_frames carries on past frames that
+                      can't be read or decoded (see nbad)              */
+  int    timings;  /* fill in res.timings                              */
+  int    sweep_summary; /* report each run of triggers that continue one
+                           another as a single sweep (h.swps still has
+                           one entry per trigger)                      */
+  imginfo_image_fn per_image; /* if set: called with the angles of all
+                                 images (or just imgnum if given)      */
+  void* per_image_arg;
+} imginfo_options;
+
+typedef struct imginfo_diag_s {
+  int level;       /* IMGINFO_DEBUG .. IMGINFO_ERROR                   */
+  string text;     /* message without surrounding blank lines          */
+} imginfo_diag;
+
+typedef struct imginfo_result_s {
+  int status;      /* as returned by imginfo_read                      */
+  image_header h;
+  string report;   /* text as printed by the imginfo program           */
+  vector<imginfo_diag> diags;
+  imginfo_timings timings; /* with opt.timings                        */
+} imginfo_result;
+
+/* imginfo_hash_files: hashes of whole files */
+#define IMGINFO_HASH_XXH64  1
+#define IMGINFO_HASH_SHA256 2
+
+typedef struct imginfo_hash_s {
+  string path;
+  int    status;   /* 0 = hashed, otherwise errno of open/read         */
+  unsigned long long size;
+  string xxh64;    /* hex digests (empty unless asked for)             */
+  string sha256;
+} imginfo_hash;
+
+/* a file open for reading several images */
+typedef struct imginfo_file_s imginfo_file;
+
+imginfo_options imginfo_default_options(void);
+int             imginfo_read(const char* path, int imgnum, const imginfo_options* opt, imginfo_result* res);
+imginfo_file*   imginfo_open(const char* path, const imginfo_options* opt);
+int             imginfo_read_image(imginfo_file* file, int imgnum, imginfo_result* res);
+void            imginfo_close(imginfo_file* file);
+int             imginfo_hash_files(vector<imginfo_hash>* files, int which, int nthreads, double* seconds);
+int             imginfo_trace_open(const char* path, long nevents);
+void            imginfo_trace_flush(void);
+void            imginfo_trace_close(void);
+int             imginfo_read_frames(imginfo_file* file, int first, int last, int nthreads,
+                                    imginfo_frame_fn fn, void* arg, imginfo_frame_stats* stats, imginfo_result* res);
+
+#endif